@@ -0,0 +1,444 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+/**
+ * Benchmark harness: generates inventories in-process with the
+ * distributions of data/generate_data.py (ids from 1, uniform location,
+ * uptime in [100, 9999], load in [10, 90] rounded to 2 decimals) and times
+ * every stage of a job separately over repeated runs:
+ *
+ *   load       JSON parse into the table (load_inline)
+ *   upload     Staging to device copies      (device time, OpenCL only)
+ *   kernel     Kernel execution              (device time, OpenCL only)
+ *   transfer   Result read-back              (device time, OpenCL only)
+ *   reliability, stability   Wall time of the Filter 1 / Filter 2 stages
+ *   join       Result snapshot
+ *   write      Report file
+ *
+ * Stages run one after another so their times do not overlap. Median,
+ * p99 and records/s of every stage are written as JSON.
+ *
+ * Usage: bench_app [--sizes N,N,...] [--repeats N] [--warmup N]
+ *                  [--stability native|opencl] [--cpu-reliability]
+ *                  [--precision full|quick] [--io-only] [--seed N]
+ *                  [--output FILE]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>  // NOLINT(build/c++17)
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "src/channel.h"
+#include "src/config.h"
+#include "src/cpu_reliability.h"
+#include "src/data_io.h"
+#include "src/opencl_processor.h"
+#include "src/opencl_session.h"
+#include "src/score_params.h"
+#include "src/server_table.h"
+#include "src/stability_engine.h"
+#include "src/types.h"
+#include "src/utils.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+// Same list as data/generate_data.py
+const char* const LOCATIONS[] = {
+    "Vilnius", "Kaunas", "Klaipeda", "Siauliai", "Panevezys",
+    "Alytus", "Marijampole", "Mazeikiai", "Jonava", "Utena",
+    "Kedainiai", "Telsiai", "Visaginas", "Taurage", "Ukmerge"
+};
+
+struct BenchOptions {
+    std::vector<int> sizes;
+    int repeats = Config::BENCH_REPEATS;
+    int warmup = Config::BENCH_WARMUP;
+    bool opencl_stability = false;
+    bool cpu_reliability = false;
+    bool io_only = false;            // Skip both filters
+    ScoreParameters params;
+    uint64_t seed = Config::BENCH_SEED;
+    std::string output = Config::BENCH_OUTPUT_FILE;
+};
+
+/**
+ * Milliseconds of each stage, one entry per measured run.
+ */
+using StageTimes = std::map<std::string, std::vector<double>>;
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+}
+
+/**
+ * JSON inventory of records servers, as generate_data.py would write it.
+ */
+std::string generate_inventory(int records, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> location(
+        0, std::size(LOCATIONS) - 1);
+    std::uniform_int_distribution<int> uptime(100, 9999);
+    std::uniform_real_distribution<double> load(10.0, 90.0);
+
+    std::string text = "{\"servers\": [";
+    text.reserve(text.size() + static_cast<size_t>(records) * 72);
+    char line[128];
+    for (int i = 0; i < records; i++) {
+        const int n = std::snprintf(
+            line, sizeof(line),
+            "%s\n{\"id\": %d, \"location\": \"%s\", \"uptime\": %d, "
+            "\"load\": %.2f}",
+            (i == 0) ? "" : ",", i + 1, LOCATIONS[location(rng)],
+            uptime(rng), std::round(load(rng) * 100.0) / 100.0);
+        text.append(line, n);
+    }
+    text += "\n]}\n";
+    return text;
+}
+
+/**
+ * Channel holding the whole table as one row range, already closed, as the
+ * loader leaves it.
+ */
+void publish_all(const ServerTable& table, Channel<RowRange>* rows) {
+    rows->push(RowRange{0, static_cast<int32_t>(table.size())});
+    rows->close();
+}
+
+/**
+ * Run every stage once on a fresh table.
+ * @return Records that passed both filters
+ */
+int64_t run_once(const BenchOptions& options, const std::string& text,
+                 const std::string& report, OpenCLSession* session,
+                 StageTimes* times) {
+    ServerTable table;
+    DeviceProfile profile;
+
+    auto start = Clock::now();
+    if (!load_inline(text, &table, {})) {
+        throw std::runtime_error("Generated inventory did not load");
+    }
+    (*times)["load"].push_back(elapsed_ms(start));
+
+    if (!options.io_only) {
+        OpenCLSettings settings{
+            .batch_size = Config::OPENCL_BATCH_SIZE,
+            .program_cache = true,
+            .multi_device = false,
+            .autotune = true,
+            .filter = DeviceFilter::kReliability,
+            .cpu_threads = 0,
+            .profile = &profile,
+            .cores = nullptr,
+            .params = options.params
+        };
+
+        Channel<RowRange> reliability_rows;
+        publish_all(table, &reliability_rows);
+        start = Clock::now();
+        if (options.cpu_reliability) {
+            const CpuReliabilitySettings cpu{.threads = 0,
+                                             .throttle = nullptr,
+                                             .params = options.params};
+            cpu_reliability_thread(&table, cpu, &reliability_rows, nullptr,
+                                   nullptr);
+        } else {
+            opencl_thread(session, &table, settings, &reliability_rows,
+                          nullptr, nullptr);
+        }
+        (*times)["reliability"].push_back(elapsed_ms(start));
+
+        Channel<RowRange> stability_rows;
+        publish_all(table, &stability_rows);
+        start = Clock::now();
+        if (options.opencl_stability) {
+            settings.filter = DeviceFilter::kStability;
+            opencl_thread(session, &table, settings, &stability_rows,
+                          nullptr, nullptr);
+        } else {
+            const StabilitySettings native{.threads = 0,
+                                           .throttle = nullptr,
+                                           .params = options.params};
+            stability_thread(&table, native, &stability_rows, nullptr,
+                             nullptr);
+        }
+        (*times)["stability"].push_back(elapsed_ms(start));
+
+        // Device stages only exist when a kernel actually ran
+        if (profile.kernel_ns > 0) {
+            (*times)["upload"].push_back(profile.upload_ns / 1e6);
+            (*times)["kernel"].push_back(profile.kernel_ns / 1e6);
+            (*times)["transfer"].push_back(profile.transfer_ns / 1e6);
+        }
+    }
+
+    start = Clock::now();
+    const ResultSnapshot results = table.snapshot();
+    (*times)["join"].push_back(elapsed_ms(start));
+
+    start = Clock::now();
+    write_output(table, results, report);
+    (*times)["write"].push_back(elapsed_ms(start));
+
+    return results.counts.both;
+}
+
+/**
+ * Value at quantile q of sorted values (nearest rank).
+ */
+double quantile(const std::vector<double>& sorted, double q) {
+    const auto rank = static_cast<size_t>(
+        q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+json summarize(int records, StageTimes times) {
+    // Wall time of a whole run: every stage that is not device time
+    std::vector<double> total(times["load"].size(), 0.0);
+    for (const char* stage : {"load", "reliability", "stability", "join",
+                              "write"}) {
+        const auto it = times.find(stage);
+        if (it == times.end()) {
+            continue;
+        }
+        for (size_t run = 0; run < total.size(); run++) {
+            total[run] += it->second[run];
+        }
+    }
+    times["total"] = total;
+
+    json stages = json::object();
+    for (auto& [stage, ms] : times) {
+        std::sort(ms.begin(), ms.end());
+        const double median = quantile(ms, 0.50);
+        stages[stage] = {
+            {"median_ms", median},
+            {"p99_ms", quantile(ms, 0.99)},
+            {"min_ms", ms.front()},
+            {"max_ms", ms.back()},
+            {"records_per_s",
+             (median > 0.0) ? records / (median / 1000.0) : 0.0}
+        };
+    }
+    return stages;
+}
+
+bool parse_count(const std::string& name, const char* value, long long min,
+                 long long* out) {
+    if (value == nullptr) {
+        std::cerr << Color::RED << "[Error] Missing value for " << name
+                  << Color::RESET << "\n";
+        return false;
+    }
+    try {
+        size_t pos = 0;
+        const long long parsed = std::stoll(value, &pos);
+        if (value[pos] != '\0' || parsed < min) {
+            throw std::invalid_argument(value);
+        }
+        *out = parsed;
+        return true;
+    } catch (const std::exception&) {
+        std::cerr << Color::RED << "[Error] Invalid value for " << name
+                  << ": " << value << Color::RESET << "\n";
+        return false;
+    }
+}
+
+bool parse_sizes(const char* value, std::vector<int>* out) {
+    out->clear();
+    std::string list = (value != nullptr) ? value : "";
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        const size_t end = std::min(list.find(',', begin), list.size());
+        long long size = 0;
+        const std::string item = list.substr(begin, end - begin);
+        if (!parse_count("--sizes", item.c_str(), 1, &size)) {
+            return false;
+        }
+        if (size > Config::BENCH_MAX_RECORDS) {
+            std::cerr << Color::RED << "[Error] --sizes: at most "
+                      << Config::BENCH_MAX_RECORDS << " records"
+                      << Color::RESET << "\n";
+            return false;
+        }
+        out->push_back(static_cast<int>(size));
+        begin = end + 1;
+    }
+    return true;
+}
+
+bool parse_bench_options(int argc, char* argv[], BenchOptions* options) {
+    bool sizes_given = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        long long value = 0;
+
+        if (arg == "--sizes") {
+            if (!parse_sizes(next, &options->sizes)) {
+                return false;
+            }
+            sizes_given = true;
+            i++;
+        } else if (arg == "--repeats") {
+            if (!parse_count(arg, next, 1, &value)) {
+                return false;
+            }
+            options->repeats = static_cast<int>(value);
+            i++;
+        } else if (arg == "--warmup") {
+            if (!parse_count(arg, next, 0, &value)) {
+                return false;
+            }
+            options->warmup = static_cast<int>(value);
+            i++;
+        } else if (arg == "--seed") {
+            if (!parse_count(arg, next, 0, &value)) {
+                return false;
+            }
+            options->seed = static_cast<uint64_t>(value);
+            i++;
+        } else if (arg == "--stability") {
+            const std::string name = (next != nullptr) ? next : "";
+            if (name != "native" && name != "opencl") {
+                std::cerr << Color::RED
+                          << "[Error] Invalid value for --stability: "
+                          << name << " (native, opencl)" << Color::RESET
+                          << "\n";
+                return false;
+            }
+            options->opencl_stability = (name == "opencl");
+            i++;
+        } else if (arg == "--precision") {
+            const std::string name = (next != nullptr) ? next : "";
+            if (!score_preset(name, &options->params)) {
+                std::cerr << Color::RED
+                          << "[Error] Invalid value for --precision: "
+                          << name << " (full, quick)" << Color::RESET
+                          << "\n";
+                return false;
+            }
+            i++;
+        } else if (arg == "--cpu-reliability") {
+            options->cpu_reliability = true;
+        } else if (arg == "--io-only") {
+            options->io_only = true;
+        } else if (arg == "--output") {
+            if (next == nullptr) {
+                std::cerr << Color::RED << "[Error] Missing value for "
+                          << arg << Color::RESET << "\n";
+                return false;
+            }
+            options->output = next;
+            i++;
+        } else {
+            std::cerr << Color::RED << "[Error] Unknown option: " << arg
+                      << Color::RESET << "\n";
+            return false;
+        }
+    }
+
+    if (!sizes_given) {
+        // Full iteration counts make the filters the bottleneck long
+        // before the I/O stages are
+        options->sizes = options->io_only
+            ? std::vector<int>{1000, 10000, 100000, 1000000, 10000000}
+            : std::vector<int>{1000, 10000};
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::cout.setf(std::ios::unitbuf);
+    std::cout << Color::BOLD << "\n=== Benchmark ===" << Color::RESET << "\n";
+
+    BenchOptions options;
+    if (!parse_bench_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    const std::string report =
+        (std::filesystem::temp_directory_path() / "lygiagretus_bench.txt")
+            .string();
+    OpenCLSession session;
+    json sizes = json::array();
+
+    try {
+        for (const int records : options.sizes) {
+            const std::string text = generate_inventory(records,
+                                                        options.seed);
+            StageTimes times;
+            StageTimes discarded;
+            int64_t passed = 0;
+            const int runs = options.warmup + options.repeats;
+            for (int run = 0; run < runs; run++) {
+                const bool warm = (run >= options.warmup);
+                std::cout << Color::BLUE << "[Bench] " << Color::RESET
+                          << records << " records, "
+                          << (warm ? "run " : "warmup ")
+                          << (warm ? run - options.warmup + 1 : run + 1)
+                          << "\n";
+                passed = run_once(options, text, report, &session,
+                                  warm ? &times : &discarded);
+            }
+            sizes.push_back({
+                {"records", records},
+                {"passed", passed},
+                {"stages", summarize(records, times)}
+            });
+        }
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Bench] " << e.what() << Color::RESET
+                  << "\n";
+        return 1;
+    }
+    std::filesystem::remove(report);
+
+    const json result = {
+        {"reliability", options.io_only ? "none"
+                        : options.cpu_reliability ? "cpu" : "opencl"},
+        {"stability", options.io_only ? "none"
+                      : options.opencl_stability ? "opencl" : "native"},
+        {"precision", score_preset_name(options.params)},
+        {"repeats", options.repeats},
+        {"warmup", options.warmup},
+        {"seed", options.seed},
+        {"sizes", sizes}
+    };
+
+    const std::filesystem::path path(options.output);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::ofstream out(options.output);
+    if (!out) {
+        std::cerr << Color::RED << "[Bench] Cannot write " << options.output
+                  << Color::RESET << "\n";
+        return 1;
+    }
+    out << result.dump(2) << "\n";
+
+    std::cout << Color::GREEN << "[Bench] " << Color::RESET << "Results -> "
+              << options.output << "\n";
+    return 0;
+}
@@ -0,0 +1,247 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/binary_format.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/mapped_file.h"
+#include "src/utils.h"
+
+namespace {
+
+uint64_t align_up(uint64_t offset) {
+    return (offset + Binary::BLOCK_ALIGN - 1) / Binary::BLOCK_ALIGN *
+           Binary::BLOCK_ALIGN;
+}
+
+/**
+ * Check that [offset, offset + size) lies inside the file and is aligned.
+ */
+void check_block(const MappedFile& file, uint64_t offset, uint64_t size,
+                 const char* name) {
+    if (offset % Binary::BLOCK_ALIGN != 0 || offset > file.size() ||
+        size > file.size() - offset) {
+        throw std::runtime_error(std::string("Bad ") + name + " block");
+    }
+}
+
+template <typename T>
+std::span<const T> column(const MappedFile& file, uint64_t offset,
+                          uint64_t rows) {
+    return std::span<const T>(
+        reinterpret_cast<const T*>(file.data() + offset), rows);
+}
+
+std::vector<std::string> read_locations(const MappedFile& file,
+                                        const Binary::Header& header) {
+    const uint64_t table_size =
+        sizeof(uint32_t) * (uint64_t{header.location_count} + 1);
+    if (header.strings_size < table_size) {
+        throw std::runtime_error("Bad strings block");
+    }
+    auto offsets = column<uint32_t>(file, header.strings_offset,
+                                    uint64_t{header.location_count} + 1);
+    const char* chars = file.data() + header.strings_offset + table_size;
+    const uint64_t chars_size = header.strings_size - table_size;
+
+    std::vector<std::string> names;
+    names.reserve(header.location_count);
+    for (uint32_t i = 0; i < header.location_count; i++) {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > chars_size) {
+            throw std::runtime_error("Bad location string table");
+        }
+        names.emplace_back(chars + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    return names;
+}
+
+/**
+ * Write a block at its offset, zero-padding from the current position.
+ */
+void write_block(std::ofstream* out, uint64_t offset, const void* data,
+                 size_t size) {
+    const auto position = static_cast<uint64_t>(out->tellp());
+    if (offset > position) {
+        const std::vector<char> padding(offset - position, 0);
+        out->write(padding.data(),
+                   static_cast<std::streamsize>(padding.size()));
+    }
+    out->write(static_cast<const char*>(data),
+               static_cast<std::streamsize>(size));
+}
+
+}  // namespace
+
+bool is_binary_inventory(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(Binary::MAGIC)] = {};
+    return file.read(magic, sizeof(magic)) &&
+           std::memcmp(magic, Binary::MAGIC, sizeof(magic)) == 0;
+}
+
+bool BinaryInventory::open(const std::string& filename) {
+    file_ = std::make_shared<MappedFile>();
+    if (!file_->open(filename)) {
+        std::cerr << Color::RED << "[Error] Cannot open: " << filename
+                  << Color::RESET << "\n";
+        return false;
+    }
+    try {
+        if (file_->size() < sizeof(header_)) {
+            throw std::runtime_error("File too small");
+        }
+        std::memcpy(&header_, file_->data(), sizeof(header_));
+        if (std::memcmp(header_.magic, Binary::MAGIC,
+                        sizeof(header_.magic)) != 0 ||
+            header_.version != Binary::VERSION) {
+            throw std::runtime_error("Unsupported format or version");
+        }
+
+        const uint64_t rows = header_.rows;
+        // Checked before the column sizes below can wrap around
+        if (rows > file_->size() / 4) {
+            throw std::runtime_error("Bad row count");
+        }
+        check_block(*file_, header_.ids_offset, 4 * rows, "id");
+        check_block(*file_, header_.uptimes_offset, 4 * rows, "uptime");
+        check_block(*file_, header_.loads_offset, 4 * rows, "load");
+        check_block(*file_, header_.location_ids_offset, 4 * rows,
+                    "location id");
+        check_block(*file_, header_.strings_offset, header_.strings_size,
+                    "strings");
+        locations_ = read_locations(*file_, header_);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Error] Binary: " << e.what()
+                  << Color::RESET << "\n";
+        header_ = Binary::Header{};
+        return false;
+    }
+}
+
+bool BinaryInventory::load(
+    ServerTable* table, size_t begin, size_t end,
+    const std::vector<Channel<RowRange>*>& consumers) const {
+    bool ok = false;
+    try {
+        if (end - begin > static_cast<size_t>(INT32_MAX)) {
+            throw std::runtime_error("Too many rows");
+        }
+        const uint64_t rows = end - begin;
+        auto location_ids = column<uint32_t>(
+            *file_, header_.location_ids_offset + 4 * begin, rows);
+        for (uint32_t location_id : location_ids) {
+            if (location_id >= header_.location_count) {
+                throw std::runtime_error("Bad location id");
+            }
+        }
+
+        table->attach(
+            file_,
+            column<int>(*file_, header_.ids_offset + 4 * begin, rows),
+            column<int>(*file_, header_.uptimes_offset + 4 * begin, rows),
+            column<float>(*file_, header_.loads_offset + 4 * begin, rows),
+            location_ids, locations_);
+
+        if (!table->empty()) {
+            for (auto* consumer : consumers) {
+                consumer->push(RowRange{
+                    0, static_cast<int32_t>(table->size())});
+            }
+        }
+        ok = true;
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Error] Binary: " << e.what()
+                  << Color::RESET << "\n";
+    }
+
+    // Consumers must not wait forever, even after a failure
+    for (auto* consumer : consumers) {
+        consumer->close();
+    }
+    return ok;
+}
+
+void BinaryInventory::release(size_t begin, size_t end) const {
+    for (uint64_t offset : {header_.ids_offset, header_.uptimes_offset,
+                            header_.loads_offset,
+                            header_.location_ids_offset}) {
+        file_->release(offset + 4 * begin, 4 * (end - begin));
+    }
+}
+
+bool load_binary(const std::string& filename, ServerTable* table,
+                 const std::vector<Channel<RowRange>*>& consumers) {
+    BinaryInventory inventory;
+    if (!inventory.open(filename)) {
+        for (auto* consumer : consumers) {
+            consumer->close();
+        }
+        return false;
+    }
+    if (!inventory.load(table, 0, inventory.rows(), consumers)) {
+        return false;
+    }
+    std::cout << Color::GREEN << "[Data] " << Color::RESET
+              << "Mapped " << table->size() << " servers, "
+              << table->location_names().size() << " locations\n";
+    return true;
+}
+
+bool write_binary(const ServerTable& table, const std::string& filename) {
+    const auto& names = table.location_names();
+    std::vector<uint32_t> offsets;
+    offsets.reserve(names.size() + 1);
+    std::string chars;
+    for (const auto& name : names) {
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+        chars += name;
+    }
+    offsets.push_back(static_cast<uint32_t>(chars.size()));
+
+    const uint64_t rows = table.size();
+    Binary::Header header{};
+    std::memcpy(header.magic, Binary::MAGIC, sizeof(header.magic));
+    header.version = Binary::VERSION;
+    header.rows = rows;
+    header.location_count = static_cast<uint32_t>(names.size());
+    header.ids_offset = align_up(sizeof(header));
+    header.uptimes_offset = align_up(header.ids_offset + 4 * rows);
+    header.loads_offset = align_up(header.uptimes_offset + 4 * rows);
+    header.location_ids_offset = align_up(header.loads_offset + 4 * rows);
+    header.strings_offset = align_up(header.location_ids_offset + 4 * rows);
+    header.strings_size = sizeof(uint32_t) * offsets.size() + chars.size();
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << Color::RED << "[Error] Cannot create: " << filename
+                  << Color::RESET << "\n";
+        return false;
+    }
+
+    write_block(&out, 0, &header, sizeof(header));
+    write_block(&out, header.ids_offset, table.ids().data(), 4 * rows);
+    write_block(&out, header.uptimes_offset, table.uptimes().data(),
+                4 * rows);
+    write_block(&out, header.loads_offset, table.loads().data(), 4 * rows);
+    write_block(&out, header.location_ids_offset,
+                table.location_ids().data(), 4 * rows);
+    write_block(&out, header.strings_offset, offsets.data(),
+                sizeof(uint32_t) * offsets.size());
+    out.write(chars.data(), static_cast<std::streamsize>(chars.size()));
+
+    if (!out) {
+        std::cerr << Color::RED << "[Error] Write failed: " << filename
+                  << Color::RESET << "\n";
+        return false;
+    }
+    return true;
+}
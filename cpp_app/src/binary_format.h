@@ -0,0 +1,110 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_BINARY_FORMAT_H_
+#define CPP_APP_SRC_BINARY_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/channel.h"
+#include "src/server_table.h"
+#include "src/types.h"
+
+/**
+ * Native binary inventory (.srvbin).
+ *
+ * A fixed header is followed by column blocks laid out exactly as the
+ * OpenCL buffers and ZMQ batch frames expect:
+ *   ids[rows](i32) uptimes[rows](i32) loads[rows](f32)
+ *   location_ids[rows](u32)
+ *   strings: offsets[location_count + 1](u32) then the location bytes
+ * Every block starts on a BLOCK_ALIGN boundary so mapped columns can back
+ * CL_MEM_USE_HOST_PTR buffers directly. Values are host byte order.
+ */
+namespace Binary {
+
+constexpr char MAGIC[4] = {'S', 'R', 'V', 'B'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t BLOCK_ALIGN = 4096;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t rows;
+    uint32_t location_count;
+    uint32_t reserved;
+    uint64_t ids_offset;
+    uint64_t uptimes_offset;
+    uint64_t loads_offset;
+    uint64_t location_ids_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+};
+static_assert(sizeof(Header) == 72, "Binary::Header must be 72 bytes");
+
+}  // namespace Binary
+
+/**
+ * Check whether a file starts with the binary inventory magic.
+ */
+bool is_binary_inventory(const std::string& filename);
+
+class MappedFile;
+
+/**
+ * A mapped and validated binary inventory whose rows can be attached to
+ * tables a window at a time (--memory-budget). Every window keeps the
+ * whole location dictionary, so location ids agree across windows.
+ */
+class BinaryInventory {
+ public:
+    /**
+     * Map a file and check its header and blocks.
+     * @return false on failure (logged)
+     */
+    bool open(const std::string& filename);
+
+    size_t rows() const { return header_.rows; }
+    const std::vector<std::string>& locations() const { return locations_; }
+
+    /**
+     * Attach rows [begin, end) to an empty table without copying and
+     * publish them to the consumers at once.
+     * @param consumers Receive the row range; closed on return, also
+     *                  after a failure
+     * @return false if a location id is out of range (logged)
+     */
+    bool load(ServerTable* table, size_t begin, size_t end,
+              const std::vector<Channel<RowRange>*>& consumers) const;
+
+    /**
+     * Drop the mapped pages of rows [begin, end) from memory.
+     */
+    void release(size_t begin, size_t end) const;
+
+ private:
+    std::shared_ptr<MappedFile> file_;
+    Binary::Header header_{};
+    std::vector<std::string> locations_;
+};
+
+/**
+ * Map a binary inventory and attach its columns to the table without
+ * copying. All rows are published to the consumers at once.
+ * @param consumers Receive the row range; closed on return, also after
+ *                  a failure
+ * @return true on success, false on failure
+ */
+bool load_binary(const std::string& filename, ServerTable* table,
+                 const std::vector<Channel<RowRange>*>& consumers);
+
+/**
+ * Write the table's input columns as a binary inventory.
+ * @return true on success, false on failure
+ */
+bool write_binary(const ServerTable& table, const std::string& filename);
+
+#endif  // CPP_APP_SRC_BINARY_FORMAT_H_
@@ -0,0 +1,107 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_CHANNEL_H_
+#define CPP_APP_SRC_CHANNEL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "src/metrics.h"
+
+/**
+ * Unbounded multi-producer / multi-consumer queue between pipeline stages.
+ * Producers call close() when done; consumers drain the remaining items
+ * and then see the channel as finished. Time spent waiting for another
+ * thread's push or pop is counted under lock="channel".
+ */
+template <typename T>
+class Channel {
+ public:
+    enum class PopResult { kItem, kEmpty, kClosed };
+
+    void push(T item) {
+        std::function<void()> wake;
+        {
+            auto lock = timed_lock(mutex_, lock_metrics());
+            items_.push_back(std::move(item));
+            wake.swap(wake_);
+        }
+        cv_.notify_one();
+        if (wake) {
+            wake();
+        }
+    }
+
+    void close() {
+        std::function<void()> wake;
+        {
+            auto lock = timed_lock(mutex_, lock_metrics());
+            closed_ = true;
+            wake.swap(wake_);
+        }
+        cv_.notify_all();
+        if (wake) {
+            wake();
+        }
+    }
+
+    /**
+     * Blocking pop.
+     * @return false once the channel is closed and drained
+     */
+    bool pop(T* out) {
+        auto lock = timed_lock(mutex_, lock_metrics());
+        cv_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return false;
+        }
+        *out = std::move(items_.front());
+        items_.pop_front();
+        return true;
+    }
+
+    /**
+     * Non-blocking pop.
+     */
+    PopResult try_pop(T* out) {
+        auto lock = timed_lock(mutex_, lock_metrics());
+        if (items_.empty()) {
+            return closed_ ? PopResult::kClosed : PopResult::kEmpty;
+        }
+        *out = std::move(items_.front());
+        items_.pop_front();
+        return PopResult::kItem;
+    }
+
+    /**
+     * Have wake called once the channel has an item or is closed, from
+     * the next push() or close(), so a coroutine can wait without
+     * blocking its thread (Executor::ready). One waiter at a time.
+     * @return false (wake is not kept) if the channel is ready already
+     */
+    bool notify_when_ready(std::function<void()> wake) {
+        auto lock = timed_lock(mutex_, lock_metrics());
+        if (!items_.empty() || closed_) {
+            return false;
+        }
+        wake_ = std::move(wake);
+        return true;
+    }
+
+ private:
+    static LockMetrics* lock_metrics() {
+        static LockMetrics* const lock = metrics().lock("channel");
+        return lock;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::function<void()> wake_;   // notify_when_ready()
+};
+
+#endif  // CPP_APP_SRC_CHANNEL_H_
@@ -3,6 +3,7 @@
 #ifndef CPP_APP_SRC_CONFIG_H_
 #define CPP_APP_SRC_CONFIG_H_
 
+#include <cstdint>
 #include <string>
 
 namespace Config {
@@ -11,8 +12,129 @@ namespace Config {
 inline const std::string ZMQ_PUSH_ADDR = "tcp://127.0.0.1:5557";
 inline const std::string ZMQ_PULL_ADDR = "tcp://127.0.0.1:5558";
 
-// Output file
+// Same-host worker sockets (--wire-transport ipc / shm)
+inline const std::string ZMQ_PUSH_IPC_ADDR = "ipc:///tmp/lygiagretus_tasks";
+inline const std::string ZMQ_PULL_IPC_ADDR = "ipc:///tmp/lygiagretus_results";
+
+// Job requests in daemon mode (--serve)
+inline const std::string ZMQ_CONTROL_ADDR = "tcp://127.0.0.1:5559";
+
+// Worker nodes connect here (--stability cluster), any interface
+inline const std::string ZMQ_ROUTER_ADDR = "tcp://*:5560";
+
+// Input / output files
+inline const std::string DEFAULT_INPUT_FILE =
+    "../data/IFF-3-2_AleksandraviciusLinas_L2_dat_1.json";
 inline const std::string OUTPUT_FILE = "../results/output.txt";
+
+// Location rollup (--summary device): most work-groups, whose partials
+// the host merges
+constexpr size_t SUMMARY_MAX_GROUPS = 64;
+
+// Out-of-core runs (--memory-budget): memory a window needs per row.
+// Covers the table (index, result columns), its snapshot, the report
+// lines, OpenCL staging and device buffers and the wire batches, with
+// headroom for the allocator.
+constexpr size_t OUT_OF_CORE_ROW_BYTES = 256;
+
+// Rows the loader parses before publishing them to the pipeline
+constexpr int LOAD_CHUNK_ROWS = 4096;
+
+// OpenCL batching (0 = everything available in one launch)
+constexpr int OPENCL_BATCH_SIZE = 0;
+constexpr int OPENCL_MAX_IN_FLIGHT = 4;
+
+// Multi-device chunk (calibration and stealing granularity) when no
+// batch size is given
+constexpr int MULTI_DEVICE_CHUNK = 64;
+
+// OpenCL program build; the score parameters are added as -D options
+// (score_params.h), with inner loops unrolled this many times
+inline const std::string OPENCL_BUILD_OPTIONS =
+    "-cl-fast-relaxed-math -cl-mad-enable -cl-no-signed-zeros";
+constexpr int KERNEL_UNROLL = 8;
+
+// --precision quick: iteration counts for cheap health checks
+constexpr int QUICK_RELIABILITY_ITERATIONS = 100000;
+constexpr int QUICK_STABILITY_ITERATIONS = 15000;
+
+// --early-exit: iterations between two checks of the recurrence state
+// (a multiple of KERNEL_UNROLL)
+constexpr int EXIT_CHECK_ITERATIONS = 4096;
+inline const std::string PROGRAM_CACHE_DIR = "../cache";
+
+// Scoring sources, hashed into the score cache and snapshot keys
+// (functions.py of this checkout stands in for remote workers)
+inline const std::string KERNEL_SOURCE_FILE = "src/kernels.cl";
+inline const std::string PYTHON_FUNCTIONS_FILE =
+    "../python_app/functions.py";
+
+// Score memo (ScoreCache, --no-score-cache): hash table file, slots it
+// starts with and the most entries it grows to (16 bytes each)
+inline const std::string SCORE_CACHE_FILE = "../cache/scores.bin";
+constexpr size_t SCORE_CACHE_INITIAL_SLOTS = size_t{1} << 16;
+constexpr size_t SCORE_CACHE_MAX_ENTRIES = size_t{1} << 26;
+
+// Launch autotuning: candidates are timed on a short-iteration build of
+// the kernels, the winner is stored next to the program cache
+constexpr int TUNE_SAMPLE_ROWS = 4096;
+constexpr int TUNE_REPEATS = 2;
+constexpr int TUNE_RELIABILITY_ITERATIONS = 2000;
+constexpr int TUNE_STABILITY_ITERATIONS = 300;
+constexpr size_t DEFAULT_LOCAL_SIZE = 256;
+
+// Metrics (metrics.h): Prometheus text endpoint in daemon mode, any
+// interface, and the most spans and samples kept per traced job
+inline const std::string METRICS_ADDR = "tcp://*:9464";
+constexpr int METRICS_POLL_MS = 100;
+constexpr size_t TRACE_MAX_EVENTS = 2000000;
+
+// Benchmark harness (bench_app)
+inline const std::string BENCH_OUTPUT_FILE = "../results/bench.json";
+constexpr int BENCH_REPEATS = 5;
+constexpr int BENCH_WARMUP = 1;
+constexpr uint64_t BENCH_SEED = 42;
+constexpr int BENCH_MAX_RECORDS = 10000000;
+
+// Early-exit validation (validate_app): inventories, report and the
+// exit checks used when --early-exit is not given
+inline const std::string VALIDATE_DATA_DIR = "../data";
+inline const std::string VALIDATE_OUTPUT_FILE = "../results/early_exit.json";
+constexpr int VALIDATE_EXIT_CHECKS = 4;
+
+// ZMQ batch frames (1 = legacy one message per record)
+constexpr int WIRE_BATCH_SIZE = 1;
+
+// Shared-memory ring (--wire-transport shm): 16 slots of 1024 records
+inline const std::string SHM_RING_NAME = "/lygiagretus_wire";
+constexpr int SHM_RING_SLOTS = 16;
+constexpr int SHM_SLOT_RECORDS = 1024;
+
+// Rows per native stability task (one row is ~600k iterations)
+constexpr int STABILITY_TASK_ROWS = 4;
+
+// Rows per CPU reliability task (one AVX-512 vector)
+constexpr int CPU_RELIABILITY_TASK_ROWS = 16;
+
+// Report rows formatted per thread at least
+constexpr int REPORT_MIN_ROWS_PER_THREAD = 16384;
+
+// Out-of-core report (SpilledReport): records read per run and bytes
+// buffered per write while the runs are merged
+constexpr size_t SPILL_MERGE_RECORDS = 4096;
+constexpr size_t SPILL_WRITE_BYTES = size_t{1} << 20;
+
+// Wake-up interval while a chained stage waits for upstream ids
+constexpr int PIPELINE_POLL_MS = 10;
+
+// CPU co-scheduling (CoreScheduler): rebalance interval, and records a
+// side must have done before its own cost replaces the earlier estimate
+constexpr int COSCHED_REBALANCE_MS = 200;
+constexpr int COSCHED_MIN_RECORDS = 64;
+
+// Worker nodes (--stability cluster)
+constexpr int NODE_TIMEOUT_MS = 5000;   // Silence before a node is dropped
+constexpr int CLUSTER_BATCH_SIZE = 16;  // Records per batch with --wire-batch 1
 }  // namespace Config
 
 #endif  // CPP_APP_SRC_CONFIG_H_
@@ -0,0 +1,44 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+/**
+ * Converts a JSON server inventory (the data/ files or generate_data.py
+ * output) into the binary format main_app maps without parsing.
+ *
+ * Usage: convert_app <input.json> [output.srvbin]
+ */
+
+#include <filesystem>  // NOLINT(build/c++17)
+#include <iostream>
+#include <string>
+
+#include "src/binary_format.h"
+#include "src/data_io.h"
+#include "src/server_table.h"
+#include "src/utils.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <input.json> [output.srvbin]\n";
+        return 1;
+    }
+
+    const std::string input = argv[1];
+    const std::string output =
+        (argc == 3) ? argv[2]
+                    : std::filesystem::path(input)
+                          .replace_extension(".srvbin")
+                          .string();
+
+    ServerTable table;
+    if (!load_data(input, &table, {})) {
+        return 1;
+    }
+    if (!write_binary(table, output)) {
+        return 1;
+    }
+
+    std::cout << Color::GREEN << "[Convert] " << Color::RESET
+              << table.size() << " servers -> " << output << "\n";
+    return 0;
+}
@@ -0,0 +1,261 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/core_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "src/config.h"
+#include "src/metrics.h"
+#include "src/utils.h"
+
+namespace {
+
+const char* side_name(int side) {
+    return (side == 0) ? "reliability" : "stability";
+}
+
+Gauge* allowance_gauge(int side) {
+    static Gauge* const gauges[2] = {
+        metrics().gauge("lygiagretus_cores_allowance",
+                        "side=\"reliability\""),
+        metrics().gauge("lygiagretus_cores_allowance", "side=\"stability\"")
+    };
+    return gauges[side];
+}
+
+}  // namespace
+
+CoreScheduler::CoreScheduler(bool enabled)
+    : enabled_(enabled),
+      cores_(pool_threads(0)),
+      reliability_throttle_(this, CoreSide::kReliability),
+      stability_throttle_(this, CoreSide::kStability) {}
+
+void CoreScheduler::begin(bool stability_on_host) {
+    std::scoped_lock lock(mutex_);
+    for (Side& side : sides_) {
+        side.local = false;
+        side.pool = false;
+        side.done = false;
+        side.allowance = cores_;
+        side.records = 0;
+        side.busy_ns = 0;
+    }
+    sides_[index(CoreSide::kStability)].local = stability_on_host;
+    device_profile_.upload_ns = 0;
+    device_profile_.kernel_ns = 0;
+    device_profile_.transfer_ns = 0;
+    device_profile_.records = 0;
+    partition_ = 0;
+    rebalances_ = 0;
+    active_ = false;
+}
+
+void CoreScheduler::finish() {
+    std::scoped_lock lock(mutex_);
+    if (!active_) {
+        return;
+    }
+    active_ = false;
+    turn_.notify_all();
+
+    // Formatted apart so that the fixed precision stays off std::cout
+    std::ostringstream out;
+    out << Color::CYAN << "[Cores] " << Color::RESET << std::fixed
+        << std::setprecision(2);
+    for (int s = 0; s < 2; s++) {
+        Side& side = sides_[s];
+        const double cost = cost_ns(side);
+        out << (s == 0 ? "" : ", ") << side_name(s) << " ";
+        if (cost > 0) {
+            out << cost / 1000.0 << " us/record";
+        } else {
+            out << "not measured";
+        }
+        // Smooth over jobs: one odd job moves the split only halfway
+        if (side.records >= Config::COSCHED_MIN_RECORDS) {
+            side.estimate_ns = (side.estimate_ns > 0)
+                                   ? (side.estimate_ns + cost) / 2.0
+                                   : cost;
+        }
+    }
+    out << "; " << rebalances_ << " rebalance(s)\n";
+    std::cout << out.str();
+}
+
+int CoreScheduler::device_units(int compute_units) {
+    std::scoped_lock lock(mutex_);
+    sides_[index(CoreSide::kReliability)].local = true;
+    device_clock_ns_ = MetricsRegistry::now_ns();
+    activate_locked();
+    const int usable = std::min(compute_units, cores_);
+    if (!active_ || usable < 2) {
+        return 0;
+    }
+    return std::clamp(
+        sides_[index(CoreSide::kReliability)].allowance.load(), 1,
+        usable - 1);
+}
+
+void CoreScheduler::set_device_partition(int units) {
+    std::scoped_lock lock(mutex_);
+    partition_ = units;
+    if (!active_) {
+        return;
+    }
+    rebalance_locked(true);
+    std::cout << Color::CYAN << "[Cores] " << Color::RESET;
+    if (units > 0) {
+        std::cout << "OpenCL runs on a partition of " << units
+                  << " compute unit(s), "
+                  << sides_[index(CoreSide::kStability)].allowance
+                  << " core(s) left for stability\n";
+    } else {
+        std::cout << "Device fission not supported, OpenCL shares the "
+                     "whole device\n";
+    }
+}
+
+void CoreScheduler::device_done() {
+    std::scoped_lock lock(mutex_);
+    Side& side = sides_[index(CoreSide::kReliability)];
+    if (!side.local || side.pool) {
+        return;
+    }
+    record_device_locked(MetricsRegistry::now_ns());
+    side.done = true;
+    rebalance_locked(true);
+}
+
+PoolThrottle* CoreScheduler::throttle(CoreSide side) {
+    std::scoped_lock lock(mutex_);
+    sides_[index(side)].local = true;
+    sides_[index(side)].pool = true;
+    activate_locked();
+    return (side == CoreSide::kReliability) ? &reliability_throttle_
+                                            : &stability_throttle_;
+}
+
+double CoreScheduler::cost_ns(const Side& side) {
+    const int64_t records = side.records;
+    if (records >= Config::COSCHED_MIN_RECORDS) {
+        return static_cast<double>(side.busy_ns) /
+               static_cast<double>(records);
+    }
+    return side.estimate_ns;
+}
+
+void CoreScheduler::activate_locked() {
+    if (active_ || !enabled_ || cores_ < 2 ||
+        !sides_[index(CoreSide::kReliability)].local ||
+        !sides_[index(CoreSide::kStability)].local) {
+        return;
+    }
+    active_ = true;
+    rebalance_locked(true);
+    std::cout << Color::CYAN << "[Cores] " << Color::RESET
+              << "Both filters run on " << cores_ << " core(s): reliability "
+              << sides_[index(CoreSide::kReliability)].allowance
+              << ", stability "
+              << sides_[index(CoreSide::kStability)].allowance << "\n";
+}
+
+void CoreScheduler::record_device_locked(int64_t now) {
+    Side& side = sides_[index(CoreSide::kReliability)];
+    if (!side.local || side.pool || side.done) {
+        return;
+    }
+    // OpenCL keeps its partition (or what the pool leaves it) busy
+    const int units = (partition_ > 0) ? partition_ : side.allowance.load();
+    side.busy_ns += (now - device_clock_ns_) * units;
+    side.records = device_profile_.records.load();
+    device_clock_ns_ = now;
+}
+
+bool CoreScheduler::rebalance_due(int64_t now) const {
+    return now - last_rebalance_ns_.load(std::memory_order_relaxed) >=
+           static_cast<int64_t>(Config::COSCHED_REBALANCE_MS) * 1000000;
+}
+
+void CoreScheduler::rebalance_locked(bool force) {
+    const int64_t now = MetricsRegistry::now_ns();
+    if (!active_ || (!force && !rebalance_due(now))) {
+        return;
+    }
+    last_rebalance_ns_ = now;
+    record_device_locked(now);
+
+    Side& reliability = sides_[index(CoreSide::kReliability)];
+    Side& stability = sides_[index(CoreSide::kStability)];
+    int reliability_cores = 0;
+    if (stability.done) {
+        reliability_cores = cores_;
+    } else if (reliability.done) {
+        reliability_cores = 0;
+    } else if (partition_ > 0) {
+        // The partition is fixed for the job
+        reliability_cores = partition_;
+    } else {
+        double reliability_cost = cost_ns(reliability);
+        double stability_cost = cost_ns(stability);
+        if (reliability_cost <= 0 || stability_cost <= 0) {
+            reliability_cost = stability_cost = 1.0;
+        }
+        reliability_cores = static_cast<int>(std::lround(
+            cores_ * reliability_cost / (reliability_cost + stability_cost)));
+        reliability_cores = std::clamp(reliability_cores, 1, cores_ - 1);
+    }
+
+    // A finished side keeps one core for its exiting workers
+    const int stability_cores = std::max(cores_ - reliability_cores, 1);
+    reliability_cores = std::max(reliability_cores, 1);
+    if (reliability.allowance == reliability_cores &&
+        stability.allowance == stability_cores) {
+        return;
+    }
+    if (!force) {
+        rebalances_++;
+    }
+    reliability.allowance = reliability_cores;
+    stability.allowance = stability_cores;
+    allowance_gauge(0)->set(reliability.allowance);
+    allowance_gauge(1)->set(stability.allowance);
+    turn_.notify_all();
+}
+
+void CoreScheduler::SideThrottle::wait_turn(int worker) {
+    const Side& side = owner_->sides_[index(side_)];
+    if (!owner_->active_ || side.done || worker < side.allowance) {
+        return;
+    }
+    std::unique_lock lock(owner_->mutex_);
+    owner_->turn_.wait(lock, [&] {
+        return !owner_->active_ || side.done || worker < side.allowance;
+    });
+}
+
+void CoreScheduler::SideThrottle::task_done(int records, int64_t busy_ns) {
+    Side& side = owner_->sides_[index(side_)];
+    side.records.fetch_add(records, std::memory_order_relaxed);
+    side.busy_ns.fetch_add(busy_ns, std::memory_order_relaxed);
+    if (owner_->active_ &&
+        owner_->rebalance_due(MetricsRegistry::now_ns())) {
+        std::scoped_lock lock(owner_->mutex_);
+        owner_->rebalance_locked(false);
+    }
+}
+
+void CoreScheduler::SideThrottle::release() {
+    std::scoped_lock lock(owner_->mutex_);
+    Side& side = owner_->sides_[index(side_)];
+    if (side.done) {
+        return;
+    }
+    side.done = true;
+    owner_->rebalance_locked(true);
+    owner_->turn_.notify_all();
+}
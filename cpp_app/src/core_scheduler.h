@@ -0,0 +1,149 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_CORE_SCHEDULER_H_
+#define CPP_APP_SRC_CORE_SCHEDULER_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "src/opencl_processor.h"
+#include "src/row_pool.h"
+
+/**
+ * Side of the split: Filter 1 or Filter 2.
+ */
+enum class CoreSide {
+    kReliability,   // OpenCL on a CPU device, or the CPU reliability pool
+    kStability      // Native stability pool or the local Python workers
+};
+
+/**
+ * Divides this host's cores between the two filters when both run on
+ * them, i.e. when Filter 1 has only a CPU OpenCL device (or the CPU
+ * engine) and Filter 2 runs natively or on the local Python workers.
+ * Left alone, each side would start one thread per core and the two
+ * would fight over every core.
+ *
+ * Both sides see the same records, so each gets a share of the cores
+ * proportional to its measured cost in core time per record. The CPU
+ * OpenCL device gets a partition of that many compute units (device
+ * fission) where the driver supports it; the native pools are throttled
+ * to their share and rebalanced every Config::COSCHED_REBALANCE_MS as the
+ * costs are measured. A side that finishes hands its cores to the other.
+ * Costs carry over to the next job (daemon mode), so later jobs start
+ * from a measured split instead of an even one.
+ *
+ * Thread-safe; one job at a time.
+ */
+class CoreScheduler {
+ public:
+    /**
+     * @param enabled false = never split (--no-co-schedule)
+     */
+    explicit CoreScheduler(bool enabled);
+
+    CoreScheduler(const CoreScheduler&) = delete;
+    CoreScheduler& operator=(const CoreScheduler&) = delete;
+
+    /**
+     * Start a job, before any stage starts.
+     * @param stability_on_host Filter 2 runs on this host's cores
+     */
+    void begin(bool stability_on_host);
+
+    /**
+     * End a job once every stage has finished: log the split and keep the
+     * measured costs for the next job.
+     */
+    void finish();
+
+    /**
+     * Filter 1 found a CPU OpenCL device.
+     * @param compute_units CL_DEVICE_MAX_COMPUTE_UNITS of the device
+     * @return Compute units to partition off for OpenCL, 0 = use the whole
+     *         device (nothing to share)
+     */
+    int device_units(int compute_units);
+
+    /**
+     * The partition OpenCL actually runs on, 0 if fission is not
+     * supported (the split then only throttles the stability pool).
+     */
+    void set_device_partition(int units);
+
+    /**
+     * Records and device time of the OpenCL batches, for its cost.
+     */
+    DeviceProfile* device_profile() { return &device_profile_; }
+
+    /**
+     * The OpenCL stage has finished.
+     */
+    void device_done();
+
+    /**
+     * Throttle for the native pool of a side.
+     */
+    PoolThrottle* throttle(CoreSide side);
+
+ private:
+    class SideThrottle : public PoolThrottle {
+     public:
+        SideThrottle(CoreScheduler* owner, CoreSide side)
+            : owner_(owner), side_(side) {}
+
+        void wait_turn(int worker) override;
+        void task_done(int records, int64_t busy_ns) override;
+        void release() override;
+
+     private:
+        CoreScheduler* owner_;
+        CoreSide side_;
+    };
+
+    /**
+     * Read lock-free by the pool workers, written under mutex_.
+     */
+    struct Side {
+        bool local = false;                // Runs on this host's cores
+        bool pool = false;                 // Throttled native pool
+        std::atomic<bool> done{false};
+        std::atomic<int> allowance{0};     // Cores while active
+        std::atomic<int64_t> records{0};   // Measured this job
+        std::atomic<int64_t> busy_ns{0};   // Core time of those records
+        double estimate_ns = 0;            // Per record, earlier jobs
+    };
+
+    static int index(CoreSide side) { return static_cast<int>(side); }
+
+    /**
+     * Core time per record of a side: this job's once measured, else the
+     * previous jobs', else 0 (unknown).
+     */
+    static double cost_ns(const Side& side);
+
+    void activate_locked();
+    void rebalance_locked(bool force);
+    void record_device_locked(int64_t now);
+    bool rebalance_due(int64_t now) const;
+
+    const bool enabled_;
+    const int cores_;
+    SideThrottle reliability_throttle_;
+    SideThrottle stability_throttle_;
+    DeviceProfile device_profile_;
+
+    std::mutex mutex_;
+    std::condition_variable turn_;
+    std::atomic<bool> active_{false};
+    std::array<Side, 2> sides_;
+    int partition_ = 0;               // OpenCL compute units, 0 = none
+    int64_t device_clock_ns_ = 0;     // OpenCL core time counted up to
+    std::atomic<int64_t> last_rebalance_ns_{0};
+    int rebalances_ = 0;
+};
+
+#endif  // CPP_APP_SRC_CORE_SCHEDULER_H_
@@ -0,0 +1,456 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/cpu_reliability.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "src/config.h"
+#include "src/metrics.h"
+#include "src/row_pool.h"
+#include "src/utils.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPU_RELIABILITY_X86 1
+#endif
+
+namespace {
+
+#ifdef __GNUC__
+
+// GCC/Clang vector extension types; operations on them are lowered to
+// whatever the enclosing function's target supports.
+using F4 = float __attribute__((vector_size(16)));
+using D4 = double __attribute__((vector_size(32)));
+using I4 = int32_t __attribute__((vector_size(16)));
+using F8 = float __attribute__((vector_size(32)));
+using D8 = double __attribute__((vector_size(64)));
+using I8 = int32_t __attribute__((vector_size(32)));
+using F16 = float __attribute__((vector_size(64)));
+using D16 = double __attribute__((vector_size(128)));
+using I16 = int32_t __attribute__((vector_size(64)));
+
+/**
+ * Float, double and int vectors with N lanes.
+ */
+template <int N>
+struct Lanes;
+
+template <>
+struct Lanes<4> {
+    using F = F4;
+    using D = D4;
+    using I = I4;
+};
+
+template <>
+struct Lanes<8> {
+    using F = F8;
+    using D = D8;
+    using I = I8;
+};
+
+template <>
+struct Lanes<16> {
+    using F = F16;
+    using D = D16;
+    using I = I16;
+};
+
+// pi/2 in four 24-bit parts: k * part is exact for k < 2^29
+constexpr double PIO2_1 = 0x1.921fb6p+0;
+constexpr double PIO2_2 = -0x1.777a5cp-25;
+constexpr double PIO2_3 = -0x1.ee59dap-50;
+constexpr double PIO2_4 = 0x1.98a2ep-77;
+constexpr double TWO_OVER_PI = 0x1.45f306dc9c883p-1;
+constexpr double ROUND_MAGIC = 0x1.8p52;  // x + M - M rounds to integer
+
+// pi/2 in three float parts (Cephes), enough for |x| < 16
+constexpr float PIO2F_1 = 1.5703125f;
+constexpr float PIO2F_2 = 4.837512969970703125e-4f;
+constexpr float PIO2F_3 = 7.54978995489188216e-8f;
+constexpr float TWO_OVER_PIF = 0.636619772367581343f;
+constexpr float ROUND_MAGICF = 0x1.8p23f;
+
+/**
+ * sin of the reduced argument r in [-pi/4, pi/4], shifted by quadrant q
+ * (q = 1 gives cos). Cephes sinf/cosf minimax polynomials.
+ */
+template <int N>
+[[gnu::always_inline]] inline void sin_reduced(
+    const typename Lanes<N>::F& r, const typename Lanes<N>::I& q,
+    typename Lanes<N>::F* out) {
+    using F = typename Lanes<N>::F;
+    const F z = r * r;
+    const F s = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z -
+                 1.6666654611e-1f) * z * r + r;
+    const F c = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z +
+                 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+    const F v = ((q & 1) != 0) ? c : s;
+    *out = ((q & 2) != 0) ? -v : v;
+}
+
+/**
+ * sin(x + offset * pi/2) for any |x| < 2^29 * pi/2: the reduction runs in
+ * double so products of large uptimes keep their phase.
+ */
+template <int N>
+[[gnu::always_inline]] inline void sin_large(
+    const typename Lanes<N>::F& x, int offset, typename Lanes<N>::F* out) {
+    using D = typename Lanes<N>::D;
+    using F = typename Lanes<N>::F;
+    using I = typename Lanes<N>::I;
+    const D xd = __builtin_convertvector(x, D);
+    const D k = (xd * TWO_OVER_PI + ROUND_MAGIC) - ROUND_MAGIC;
+    D r = xd - k * PIO2_1;
+    r = r - k * PIO2_2;
+    r = r - k * PIO2_3;
+    r = r - k * PIO2_4;
+    const I q = __builtin_convertvector(k, I) + offset;
+    sin_reduced<N>(__builtin_convertvector(r, F), q, out);
+}
+
+/**
+ * sin(x) for small arguments (|x| < 16), reduced in float.
+ */
+template <int N>
+[[gnu::always_inline]] inline void sin_small(
+    const typename Lanes<N>::F& x, typename Lanes<N>::F* out) {
+    using F = typename Lanes<N>::F;
+    using I = typename Lanes<N>::I;
+    const F k = (x * TWO_OVER_PIF + ROUND_MAGICF) - ROUND_MAGICF;
+    F r = x - k * PIO2F_1;
+    r = r - k * PIO2F_2;
+    r = r - k * PIO2F_3;
+    sin_reduced<N>(r, __builtin_convertvector(k, I), out);
+}
+
+template <int N>
+[[gnu::always_inline]] inline void abs_lanes(typename Lanes<N>::F* x) {
+    using I = typename Lanes<N>::I;
+    I bits;
+    __builtin_memcpy(&bits, x, sizeof(bits));
+    bits &= 0x7fffffff;
+    __builtin_memcpy(x, &bits, sizeof(bits));
+}
+
+/**
+ * One step of the compute_reliability recurrence in every lane.
+ */
+template <int N>
+[[gnu::always_inline]] inline void reliability_step(
+    const typename Lanes<N>::F& uptime_scale,
+    const typename Lanes<N>::F& load, int i,
+    typename Lanes<N>::F* reliability) {
+    using F = typename Lanes<N>::F;
+    const float fi = static_cast<float>(i);
+    F f1;
+    F f2;
+    sin_large<N>(uptime_scale * fi, 0, &f1);
+    sin_large<N>(load * fi, 1, &f2);  // cos
+    sin_small<N>(*reliability + f1 - f2, reliability);
+    abs_lanes<N>(reliability);
+}
+
+/**
+ * The compute_reliability recurrence for N records at once; Iterations > 0
+ * fixes the trip count at compile time, 0 takes it from params. With
+ * early exit, a lane keeps its state once it stayed on one side of the
+ * threshold for reliability_exit_checks checks; the loop ends when every
+ * lane is settled.
+ */
+template <int N, int Iterations>
+[[gnu::always_inline]] inline void reliability_lanes(
+    const int* uptimes, const float* loads, const ScoreParameters& params,
+    float* out) {
+    const int count =
+        (Iterations > 0) ? Iterations : params.reliability_iterations;
+    using F = typename Lanes<N>::F;
+    F uptime_scale;
+    F load;
+    for (int j = 0; j < N; j++) {
+        uptime_scale[j] = static_cast<float>(uptimes[j]) / 1000.0f;
+        load[j] = loads[j];
+    }
+
+    F reliability = F{} + 0.5f;
+    if (params.reliability_exit_checks <= 0) {
+        for (int i = 0; i < count; i++) {
+            reliability_step<N>(uptime_scale, load, i, &reliability);
+        }
+    } else {
+        const float threshold = params.reliability_threshold;
+        F settled = reliability;
+        int side[N] = {};
+        int streak[N] = {};
+        bool done[N] = {};
+        int open = N;
+        for (int base = 0; base < count && open > 0;
+             base += Config::EXIT_CHECK_ITERATIONS) {
+            const int end =
+                std::min(base + Config::EXIT_CHECK_ITERATIONS, count);
+            F lo = F{} + 2.0f;
+            F hi = F{} - 1.0f;
+            for (int i = base; i < end; i++) {
+                reliability_step<N>(uptime_scale, load, i, &reliability);
+                lo = (reliability < lo) ? reliability : lo;
+                hi = (reliability > hi) ? reliability : hi;
+            }
+            for (int j = 0; j < N; j++) {
+                if (done[j]) {
+                    continue;
+                }
+                const int now = (lo[j] * 100.0f >= threshold)  ? 1
+                                : (hi[j] * 100.0f < threshold) ? -1
+                                                               : 0;
+                streak[j] = (now != 0 && now == side[j]) ? streak[j] + 1
+                                                         : (now != 0);
+                side[j] = now;
+                if (streak[j] >= params.reliability_exit_checks) {
+                    done[j] = true;
+                    settled[j] = reliability[j];
+                    open--;
+                }
+            }
+        }
+        for (int j = 0; j < N; j++) {
+            if (done[j]) {
+                reliability[j] = settled[j];
+            }
+        }
+    }
+    reliability *= 100.0f;
+
+    for (int j = 0; j < N; j++) {
+        out[j] = reliability[j];
+    }
+}
+
+#else
+
+// No vector extensions: plain libm loop, one record at a time
+template <int N, int Iterations>
+void reliability_lanes(const int* uptimes, const float* loads,
+                       const ScoreParameters& params, float* out) {
+    const int count =
+        (Iterations > 0) ? Iterations : params.reliability_iterations;
+    const int checks = params.reliability_exit_checks;
+    for (int j = 0; j < N; j++) {
+        float reliability = 0.5f;
+        float lo = 2.0f;
+        float hi = -1.0f;
+        int side = 0;
+        int streak = 0;
+        for (int i = 0; i < count; i++) {
+            const float f1 = std::sin(static_cast<float>(uptimes[j]) /
+                                      1000.0f * static_cast<float>(i));
+            const float f2 = std::cos(loads[j] * static_cast<float>(i));
+            reliability = std::fabs(std::sin(reliability + f1 - f2));
+            if (checks <= 0) {
+                continue;
+            }
+            lo = std::min(lo, reliability);
+            hi = std::max(hi, reliability);
+            if ((i + 1) % Config::EXIT_CHECK_ITERATIONS == 0) {
+                const float threshold = params.reliability_threshold;
+                const int now = (lo * 100.0f >= threshold)  ? 1
+                                : (hi * 100.0f < threshold) ? -1
+                                                            : 0;
+                streak = (now != 0 && now == side) ? streak + 1 : (now != 0);
+                side = now;
+                lo = 2.0f;
+                hi = -1.0f;
+                if (streak >= checks) {
+                    break;
+                }
+            }
+        }
+        out[j] = reliability * 100.0f;
+    }
+}
+
+#endif  // __GNUC__
+
+using BlockFn = void (*)(const int*, const float*, const ScoreParameters&,
+                         float*);
+
+template <int Iterations>
+void block_generic(const int* uptimes, const float* loads,
+                   const ScoreParameters& params, float* out) {
+    reliability_lanes<4, Iterations>(uptimes, loads, params, out);
+}
+
+#ifdef CPU_RELIABILITY_X86
+template <int Iterations>
+__attribute__((target("avx2")))
+void block_avx2(const int* uptimes, const float* loads,
+                const ScoreParameters& params, float* out) {
+    reliability_lanes<8, Iterations>(uptimes, loads, params, out);
+}
+
+template <int Iterations>
+__attribute__((target("avx512f")))
+void block_avx512(const int* uptimes, const float* loads,
+                  const ScoreParameters& params, float* out) {
+    reliability_lanes<16, Iterations>(uptimes, loads, params, out);
+}
+#endif
+
+int lane_count(CpuIsa isa) {
+    switch (isa) {
+        case CpuIsa::kAvx512:
+            return 16;
+        case CpuIsa::kAvx2:
+            return 8;
+        case CpuIsa::kGeneric:
+        default:
+            return 4;
+    }
+}
+
+template <int Iterations>
+BlockFn block_fn(CpuIsa isa) {
+#ifdef CPU_RELIABILITY_X86
+    if (isa == CpuIsa::kAvx512) {
+        return block_avx512<Iterations>;
+    }
+    if (isa == CpuIsa::kAvx2) {
+        return block_avx2<Iterations>;
+    }
+#endif
+    return block_generic<Iterations>;
+}
+
+BlockFn block_fn(CpuIsa isa, int iterations) {
+    // The preset counts are specialized, anything else runs the generic loop
+    if (iterations == Constants::RELIABILITY_ITERATIONS) {
+        return block_fn<Constants::RELIABILITY_ITERATIONS>(isa);
+    }
+    if (iterations == Config::QUICK_RELIABILITY_ITERATIONS) {
+        return block_fn<Config::QUICK_RELIABILITY_ITERATIONS>(isa);
+    }
+    return block_fn<0>(isa);
+}
+
+}  // namespace
+
+CpuIsa detect_cpu_isa() {
+#ifdef CPU_RELIABILITY_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return CpuIsa::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return CpuIsa::kAvx2;
+    }
+#endif
+    return CpuIsa::kGeneric;
+}
+
+const char* cpu_isa_name(CpuIsa isa) {
+    switch (isa) {
+        case CpuIsa::kAvx512:
+            return "AVX-512";
+        case CpuIsa::kAvx2:
+            return "AVX2";
+        case CpuIsa::kGeneric:
+        default:
+            return "generic";
+    }
+}
+
+void compute_reliability_block(CpuIsa isa, const ScoreParameters& params,
+                               const int* uptimes, const float* loads,
+                               int count, float* out) {
+    const int lanes = lane_count(isa);
+    const BlockFn fn = block_fn(isa, params.reliability_iterations);
+
+    int begin = 0;
+    for (; begin + lanes <= count; begin += lanes) {
+        fn(uptimes + begin, loads + begin, params, out + begin);
+    }
+    if (begin == count) {
+        return;
+    }
+
+    // Pad the tail to a full vector
+    std::array<int, 16> tail_uptimes{};
+    std::array<float, 16> tail_loads{};
+    std::array<float, 16> tail_out{};
+    const int tail = count - begin;
+    std::copy_n(uptimes + begin, tail, tail_uptimes.begin());
+    std::copy_n(loads + begin, tail, tail_loads.begin());
+    fn(tail_uptimes.data(), tail_loads.data(), params, tail_out.data());
+    std::copy_n(tail_out.begin(), tail, out + begin);
+}
+
+void cpu_reliability_thread(
+    ServerTable* table,
+    const CpuReliabilitySettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed) {
+    TraceScope scope("cpu", "cpu reliability");
+    const int threads = pool_threads(settings.threads);
+    const CpuIsa isa = detect_cpu_isa();
+
+    std::cout << Color::CYAN << "[CPU] " << Color::RESET
+              << "Reliability on " << threads << " thread(s), "
+              << cpu_isa_name(isa) << "\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::atomic<int> processed{0};
+    std::atomic<int> accepted{0};
+
+    try {
+        run_row_pool(*table, threads, Config::CPU_RELIABILITY_TASK_ROWS,
+                     rows, input, settings.throttle,
+                     [&](const RowTask& task) {
+            const int count = static_cast<int>(task.size());
+            std::vector<int> uptimes(count);
+            std::vector<float> loads(count);
+            std::vector<float> scores(count);
+            for (int i = 0; i < count; i++) {
+                uptimes[i] = table->uptimes()[task[i]];
+                loads[i] = table->loads()[task[i]];
+            }
+            compute_reliability_block(isa, settings.params, uptimes.data(),
+                                      loads.data(), count, scores.data());
+
+            IdBatch ids;
+            for (int i = 0; i < count; i++) {
+                if (scores[i] >= settings.params.reliability_threshold) {
+                    table->set_reliability(task[i], scores[i]);
+                    ids.push_back(table->ids()[task[i]]);
+                }
+            }
+            processed += count;
+            accepted += static_cast<int>(ids.size());
+            if (passed != nullptr && !ids.empty()) {
+                passed->push(std::move(ids));
+            }
+        });
+    } catch (const std::exception& e) {
+        stage_errors()->add(1);
+        std::cerr << Color::RED << "[CPU] " << e.what()
+                  << Color::RESET << "\n";
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << Color::CYAN << "[CPU] " << Color::RESET
+              << accepted << "/" << processed << " passed, " << elapsed
+              << " ms\n";
+
+    // Downstream stage must not wait forever, even after a failure
+    if (passed != nullptr) {
+        passed->close();
+    }
+}
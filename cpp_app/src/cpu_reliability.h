@@ -0,0 +1,92 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_CPU_RELIABILITY_H_
+#define CPP_APP_SRC_CPU_RELIABILITY_H_
+
+#include "src/channel.h"
+#include "src/score_params.h"
+#include "src/server_table.h"
+#include "src/types.h"
+
+class PoolThrottle;
+
+/**
+ * Vector instruction set used by the CPU reliability engine.
+ */
+enum class CpuIsa {
+    kGeneric,       // 4 records per SSE2 (or compiler generic) vector
+    kAvx2,          // 8 records per AVX2 vector
+    kAvx512         // 16 records per AVX-512 vector
+};
+
+/**
+ * Tunables for the CPU reliability stage.
+ */
+struct CpuReliabilitySettings {
+    int threads;             // Worker threads (0 = one per core)
+    PoolThrottle* throttle;  // Limits the busy workers (nullptr = all)
+    ScoreParameters params;  // Iterations and threshold
+};
+
+/**
+ * Widest instruction set supported by this CPU (and this build).
+ */
+CpuIsa detect_cpu_isa();
+
+/**
+ * Instruction set name for logs.
+ */
+const char* cpu_isa_name(CpuIsa isa);
+
+/**
+ * Reliability scores of a block of records, computed in vector lanes.
+ * Same recurrence as compute_reliability in kernels.cl. Every ISA gives
+ * the same bits: the sin/cos approximations use identical operations and
+ * no contraction into FMA.
+ *
+ * Accuracy: range reduction is done in double with a four-part pi/2, so
+ * the large arguments of the recurrence (uptime / 1000 * i reaches ~4e7
+ * on the sample data) keep their phase; results are within 1 ulp of libm
+ * sinf / cosf. The recurrence damps earlier errors: against a libm sinf/cosf
+ * reference of the kernel loop, data sets 1-4 (1200 records) differ by at
+ * most 3.1e-5 (mean 2.7e-6) with no Filter 1 decision changed. The
+ * -cl-fast-relaxed-math kernel makes no such promise for large arguments
+ * (native sin/cos may reduce in single precision), so device scores can
+ * differ by more and records near the 50 threshold may land on the other
+ * side of Filter 1.
+ *
+ * @param isa Instruction set to use (must be supported)
+ * @param params Recurrence length (the preset counts run a loop with a
+ *               compile-time trip count), threshold and early exit
+ * @param uptimes Uptime column, count entries
+ * @param loads Load column, count entries
+ * @param count Number of records
+ * @param out Receives count scores (already multiplied by 100)
+ */
+void compute_reliability_block(CpuIsa isa, const ScoreParameters& params,
+                               const int* uptimes, const float* loads,
+                               int count, float* out);
+
+/**
+ * CPU reliability thread function (fallback for hosts without an OpenCL
+ * device). Applies Filter 1 (reliability >= threshold) on a thread pool with
+ * the widest available vector ISA; results are written to the table as
+ * each task completes.
+ *
+ * @param table Server table; reliability results are written lock-free
+ * @param settings Thread pool settings
+ * @param rows Row ranges published by the loader (used when input is
+ *             nullptr)
+ * @param input Ids to evaluate, pushed by an upstream stage
+ *              (nullptr = evaluate every loaded record)
+ * @param passed Receives the ids that passed each task
+ *               (nullptr = not chained); closed when the thread ends
+ */
+void cpu_reliability_thread(
+    ServerTable* table,
+    const CpuReliabilitySettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed);
+
+#endif  // CPP_APP_SRC_CPU_RELIABILITY_H_
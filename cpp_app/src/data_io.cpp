@@ -2,59 +2,241 @@
 
 #include "src/data_io.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <filesystem>  // NOLINT(build/c++17)
 #include <fstream>
-#include <iomanip>
+#include <functional>
 #include <iostream>
-#include <map>
+#include <queue>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "src/config.h"
+#include "src/mapped_file.h"
 #include "src/utils.h"
 
 using json = nlohmann::json;
 
-bool load_data(
-    const std::string& filename,
-    std::vector<ServerData>* servers,
-    std::map<int, ServerResult>* results) {
-    std::ifstream file(filename);
-    if (!file) {
-        std::cerr << Color::RED << "[Error] Cannot open: " << filename
-                  << Color::RESET << "\n";
+namespace {
+
+// Shortest possible record: {"id":0,"location":"","uptime":0,"load":0}
+constexpr size_t MIN_RECORD_BYTES = 43;
+
+/**
+ * SAX handler turning the "servers" array into table rows.
+ * Published rows are handed to the consumers every LOAD_CHUNK_ROWS
+ * records while the rest of the file is still being parsed.
+ */
+class InventorySax {
+ public:
+    InventorySax(ServerTable* table,
+                 const std::vector<Channel<RowRange>*>& consumers)
+        : table_(table), consumers_(consumers) {}
+
+    bool null() { return scalar(); }
+    bool boolean(bool /*value*/) { return scalar(); }
+    bool number_integer(json::number_integer_t value) {
+        return number(static_cast<double>(value), value, false);
+    }
+    bool number_unsigned(json::number_unsigned_t value) {
+        return number(static_cast<double>(value),
+                      static_cast<int64_t>(value), false);
+    }
+    bool number_float(json::number_float_t value,
+                      const json::string_t& /*raw*/) {
+        return number(value, static_cast<int64_t>(value), true);
+    }
+    bool string(json::string_t& value) {
+        if (in_record_field() && field_ == Field::kLocation) {
+            location_ = std::move(value);
+            seen_ |= Field::kLocation;
+        }
+        return scalar();
+    }
+    bool binary(json::binary_t& /*value*/) { return scalar(); }
+
+    bool start_object(size_t /*size*/) {
+        if (servers_depth_ >= 0 && depth_ == servers_depth_) {
+            seen_ = 0;
+        }
+        field_ = Field::kNone;
+        depth_++;
+        return true;
+    }
+
+    bool end_object() {
+        if (servers_depth_ >= 0 && depth_ == servers_depth_ + 1) {
+            finish_record();
+        }
+        depth_--;
+        return true;
+    }
+
+    bool start_array(size_t /*size*/) {
+        if (depth_ == 1 && top_key_ == "servers") {
+            servers_depth_ = depth_ + 1;
+        }
+        field_ = Field::kNone;
+        depth_++;
+        return true;
+    }
+
+    bool end_array() {
+        depth_--;
+        if (depth_ + 1 == servers_depth_) {
+            servers_depth_ = -1;
+        }
+        return true;
+    }
+
+    bool key(json::string_t& name) {
+        if (depth_ == 1) {
+            top_key_ = name;
+        } else if (servers_depth_ >= 0 && depth_ == servers_depth_ + 1) {
+            if (name == "id") {
+                field_ = Field::kId;
+            } else if (name == "location") {
+                field_ = Field::kLocation;
+            } else if (name == "uptime") {
+                field_ = Field::kUptime;
+            } else if (name == "load") {
+                field_ = Field::kLoad;
+            } else {
+                field_ = Field::kNone;
+            }
+        }
+        return true;
+    }
+
+    bool parse_error(size_t /*position*/, const std::string& /*token*/,
+                     const nlohmann::detail::exception& e) {
+        error_ = e.what();
         return false;
     }
 
-    try {
-        json json_data;
-        file >> json_data;
-
-        for (const auto& server : json_data["servers"]) {
-            ServerData data{
-                .id = server["id"],
-                .location = server["location"],
-                .uptime = server["uptime"],
-                .load = server["load"]
-            };
-            servers->push_back(data);
-
-            (*results)[data.id] = ServerResult{
-                .id = data.id,
-                .location = data.location,
-                .uptime = data.uptime,
-                .load = data.load,
-                .reliability = 0.0f,
-                .stability = 0.0f,
-                .has_opencl_result = false,
-                .has_python_result = false
-            };
+    /**
+     * Hand the rows parsed since the last call to the consumers.
+     */
+    void publish() {
+        const auto end = static_cast<int32_t>(table_->size());
+        if (end > chunk_begin_) {
+            for (auto* consumer : consumers_) {
+                consumer->push(RowRange{chunk_begin_, end});
+            }
+            chunk_begin_ = end;
         }
+    }
+
+    const std::string& error() const { return error_; }
 
+ private:
+    // Bit per record field
+    struct Field {
+        static constexpr int kNone = 0;
+        static constexpr int kId = 1;
+        static constexpr int kLocation = 2;
+        static constexpr int kUptime = 4;
+        static constexpr int kLoad = 8;
+        static constexpr int kAll = kId | kLocation | kUptime | kLoad;
+    };
+
+    bool in_record_field() const {
+        return servers_depth_ >= 0 && depth_ == servers_depth_ + 1 &&
+               field_ != Field::kNone;
+    }
+
+    bool scalar() {
+        field_ = Field::kNone;
+        return true;
+    }
+
+    bool number(double as_double, int64_t as_int, bool is_float) {
+        if (in_record_field()) {
+            switch (field_) {
+                case Field::kId:
+                    id_ = static_cast<int>(as_int);
+                    seen_ |= Field::kId;
+                    break;
+                case Field::kUptime:
+                    uptime_ = static_cast<int>(as_int);
+                    seen_ |= Field::kUptime;
+                    break;
+                case Field::kLoad:
+                    load_ = is_float ? static_cast<float>(as_double)
+                                     : static_cast<float>(as_int);
+                    seen_ |= Field::kLoad;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return scalar();
+    }
+
+    void finish_record() {
+        if (seen_ != Field::kAll) {
+            throw std::runtime_error(
+                "Server record " + std::to_string(table_->size()) +
+                " is missing id, location, uptime or load");
+        }
+        // Consumers read published rows concurrently: never reallocate
+        if (table_->size() == table_->capacity()) {
+            throw std::runtime_error("More records than the input can hold");
+        }
+        table_->add(id_, location_, uptime_, load_);
+        if (static_cast<int32_t>(table_->size()) - chunk_begin_ >=
+            Config::LOAD_CHUNK_ROWS) {
+            publish();
+        }
+    }
+
+    ServerTable* table_;
+    const std::vector<Channel<RowRange>*>& consumers_;
+    int32_t chunk_begin_ = 0;
+
+    int depth_ = 0;
+    int servers_depth_ = -1;  // Depth inside the servers array
+    std::string top_key_;
+    int field_ = Field::kNone;
+
+    int seen_ = 0;
+    int id_ = 0;
+    std::string location_;
+    int uptime_ = 0;
+    float load_ = 0.0f;
+
+    std::string error_;
+};
+
+/**
+ * Parse a document with a "servers" array into the table.
+ * @return true on success
+ */
+bool parse_inventory(const char* begin, const char* end, ServerTable* table,
+                     const std::vector<Channel<RowRange>*>& consumers) {
+    try {
+        table->reserve(static_cast<size_t>(end - begin) / MIN_RECORD_BYTES +
+                       1);
+
+        InventorySax sax(table, consumers);
+        const bool ok = json::sax_parse(begin, end, &sax);
+        sax.publish();
+        if (!ok) {
+            std::cerr << Color::RED << "[Error] JSON: " << sax.error()
+                      << Color::RESET << "\n";
+            return false;
+        }
         std::cout << Color::GREEN << "[Data] " << Color::RESET
-                  << "Loaded " << servers->size() << " servers\n";
+                  << "Loaded " << table->size() << " servers, "
+                  << table->location_names().size() << " locations\n";
         return true;
     } catch (const std::exception& e) {
         std::cerr << Color::RED << "[Error] JSON: " << e.what()
@@ -63,96 +245,461 @@ bool load_data(
     }
 }
 
-void write_output(
-    const std::vector<ServerData>& servers,
-    const std::map<int, ServerResult>& results
-) {
-    std::filesystem::create_directories("../results");
-    std::ofstream file(Config::OUTPUT_FILE);
+void close_all(const std::vector<Channel<RowRange>*>& consumers) {
+    for (auto* consumer : consumers) {
+        consumer->close();
+    }
+}
+
+}  // namespace
+
+bool load_data(const std::string& filename, ServerTable* table,
+               const std::vector<Channel<RowRange>*>& consumers) {
+    bool ok = false;
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << Color::RED << "[Error] Cannot open: " << filename
+                  << Color::RESET << "\n";
+    } else {
+        ok = parse_inventory(file.data(), file.data() + file.size(), table,
+                             consumers);
+    }
+
+    // Consumers must not wait forever, even after a failure
+    close_all(consumers);
+    return ok;
+}
+
+bool load_inline(std::string_view text, ServerTable* table,
+                 const std::vector<Channel<RowRange>*>& consumers) {
+    const bool ok = parse_inventory(text.data(), text.data() + text.size(),
+                                    table, consumers);
+    close_all(consumers);
+    return ok;
+}
+
+namespace {
+
+/**
+ * Appends fields padded the way `std::left << std::setw(width)` prints
+ * them, formatting numbers with std::to_chars.
+ */
+class LineWriter {
+ public:
+    explicit LineWriter(std::string* out) : out_(out) {}
+
+    void text(std::string_view value, int width) {
+        out_->append(value);
+        pad(value.size(), width);
+    }
+
+    void integer(int value, int width) {
+        char buf[16];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        append(buf, result.ptr, width);
+    }
+
+    // Same digits as std::fixed << std::setprecision(precision)
+    void fixed(float value, int precision, int width) {
+        char buf[64];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value,
+                                    std::chars_format::fixed, precision);
+        append(buf, result.ptr, width);
+    }
+
+    void end_line() { out_->push_back('\n'); }
+
+ private:
+    void append(const char* begin, const char* end, int width) {
+        out_->append(begin, end);
+        pad(static_cast<size_t>(end - begin), width);
+    }
+
+    void pad(size_t written, int width) {
+        if (written < static_cast<size_t>(width)) {
+            out_->append(static_cast<size_t>(width) - written, ' ');
+        }
+    }
+
+    std::string* out_;
+};
+
+/**
+ * Number of formatting threads for count rows.
+ */
+size_t chunk_count(size_t count) {
+    const size_t min_rows = Config::REPORT_MIN_ROWS_PER_THREAD;
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    return std::clamp<size_t>((count + min_rows - 1) / min_rows, 1, hardware);
+}
+
+/**
+ * Split [0, count) into contiguous chunks and run fn(chunk, begin, end)
+ * for each on its own thread. A single chunk stays on the calling thread.
+ */
+template <typename Fn>
+void parallel_chunks(size_t count, size_t chunks, Fn fn) {
+    if (chunks == 1) {
+        fn(size_t{0}, size_t{0}, count);
+        return;
+    }
+    const size_t per_chunk = (count + chunks - 1) / chunks;
+    std::vector<std::jthread> workers;
+    for (size_t c = 0; c < chunks; c++) {
+        const size_t begin = std::min(count, c * per_chunk);
+        const size_t end = std::min(count, begin + per_chunk);
+        workers.emplace_back(fn, c, begin, end);
+    }
+}
+
+void append_rule(std::string* out, char c) {
+    out->append(Constants::LINE_WIDTH, c);
+    out->push_back('\n');
+}
+
+/**
+ * Initial data lines of rows [begin, end). The rows passing both filters
+ * are picked up in the same pass (rows shadowed by a later duplicate id
+ * are not results).
+ */
+void format_initial(const ServerTable& table, const ResultSnapshot& results,
+                    size_t begin, size_t end, std::string* out,
+                    std::vector<int32_t>* passed) {
+    const auto ids = table.ids();
+    const auto uptimes = table.uptimes();
+    const auto loads = table.loads();
+    out->reserve(out->size() + (end - begin) * (Constants::COL_ID +
+                 Constants::COL_LOC + Constants::COL_UPTIME +
+                 Constants::COL_LOAD + 1));
+    LineWriter line(out);
+    for (size_t r = begin; r < end; r++) {
+        const auto row = static_cast<int32_t>(r);
+        line.integer(ids[r], Constants::COL_ID);
+        line.text(table.location(row), Constants::COL_LOC);
+        line.integer(uptimes[r], Constants::COL_UPTIME);
+        line.fixed(loads[r], 2, Constants::COL_LOAD);
+        line.end_line();
+
+        if (results.has_opencl_result(row) &&
+            results.has_python_result(row) &&
+            table.row_of(ids[r]) == row) {
+            passed->push_back(row);
+        }
+    }
+}
+
+void format_filtered(LineWriter* line, int id, std::string_view location,
+                     int uptime, float load, float reliability,
+                     float stability) {
+    line->integer(id, Constants::COL_ID);
+    line->text(location, Constants::COL_LOC);
+    line->integer(uptime, Constants::COL_UPTIME);
+    line->fixed(load, 2, Constants::COL_LOAD);
+    line->fixed(reliability, 4, Constants::COL_REL);
+    line->fixed(stability, 4, Constants::COL_STAB);
+    line->end_line();
+}
+
+/**
+ * Statistics (counted as results arrived) and the initial data heading.
+ */
+std::string report_header(size_t rows, const ResultCounts& counts) {
+    std::string header;
+    append_rule(&header, '=');
+    header += "STATISTICS:\n  Total: " + std::to_string(rows) +
+              ", Filter1: " + std::to_string(counts.opencl) +
+              ", Filter2: " + std::to_string(counts.python) +
+              ", Both: " + std::to_string(counts.both) + "\n\n";
+    append_rule(&header, '=');
+    header += "INITIAL DATA\n";
+    append_rule(&header, '-');
+    LineWriter header_line(&header);
+    header_line.text("ID", Constants::COL_ID);
+    header_line.text("Location", Constants::COL_LOC);
+    header_line.text("Uptime", Constants::COL_UPTIME);
+    header_line.text("Load", Constants::COL_LOAD);
+    header_line.end_line();
+    append_rule(&header, '-');
+    return header;
+}
+
+/**
+ * Filtered results heading.
+ */
+std::string report_middle() {
+    std::string middle = "\n";
+    append_rule(&middle, '=');
+    middle += "FILTERED RESULTS (passed both filters)\n";
+    append_rule(&middle, '-');
+    LineWriter middle_line(&middle);
+    middle_line.text("ID", Constants::COL_ID);
+    middle_line.text("Location", Constants::COL_LOC);
+    middle_line.text("Uptime", Constants::COL_UPTIME);
+    middle_line.text("Load", Constants::COL_LOAD);
+    middle_line.text("Reliability", Constants::COL_REL);
+    middle_line.text("Stability", Constants::COL_STAB);
+    middle_line.end_line();
+    append_rule(&middle, '-');
+    return middle;
+}
+
+std::string report_footer() {
+    std::string footer;
+    append_rule(&footer, '=');
+    return footer;
+}
+
+/**
+ * Create a report's directory and open it for writing.
+ */
+std::ofstream create_report(const std::string& filename) {
+    const std::filesystem::path parent =
+        std::filesystem::path(filename).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+    return std::ofstream(filename, std::ios::binary);
+}
+
+}  // namespace
 
+void write_output(const ServerTable& table, const ResultSnapshot& results,
+                  const std::string& filename) {
+    std::ofstream file = create_report(filename);
     if (!file) {
         std::cerr << Color::RED << "[Error] Cannot create output\n"
                   << Color::RESET;
         return;
     }
 
-    // Calculate statistics
-    int opencl_passed = 0;
-    int python_passed = 0;
-    int both_passed = 0;
-
-    for (const auto& [id, result] : results) {
-        if (result.has_opencl_result) {
-            opencl_passed++;
-        }
-        if (result.has_python_result) {
-            python_passed++;
-        }
-        if (result.has_opencl_result && result.has_python_result) {
-            both_passed++;
-        }
-    }
-
-    int total_servers = static_cast<int>(servers.size());
-
-    // Write header
-    file << std::string(Constants::LINE_WIDTH, '=') << "\n"
-         << "STATISTICS:\n"
-         << "  Total: " << total_servers
-         << ", Filter1: " << opencl_passed
-         << ", Filter2: " << python_passed
-         << ", Both: " << both_passed << "\n\n";
-
-    // Write initial data section
-    file << std::string(Constants::LINE_WIDTH, '=') << "\n"
-         << "INITIAL DATA\n"
-         << std::string(Constants::LINE_WIDTH, '-') << "\n"
-         << std::left
-         << std::setw(Constants::COL_ID) << "ID"
-         << std::setw(Constants::COL_LOC) << "Location"
-         << std::setw(Constants::COL_UPTIME) << "Uptime"
-         << std::setw(Constants::COL_LOAD) << "Load" << "\n"
-         << std::string(Constants::LINE_WIDTH, '-') << "\n";
-
-    for (const auto& server : servers) {
-        file << std::left
-             << std::setw(Constants::COL_ID) << server.id
-             << std::setw(Constants::COL_LOC) << server.location
-             << std::setw(Constants::COL_UPTIME) << server.uptime
-             << std::fixed << std::setprecision(2)
-             << std::setw(Constants::COL_LOAD) << server.load << "\n";
-    }
-
-    // Write filtered results section
-    file << "\n" << std::string(Constants::LINE_WIDTH, '=') << "\n"
-         << "FILTERED RESULTS (passed both filters)\n"
-         << std::string(Constants::LINE_WIDTH, '-') << "\n"
-         << std::left
-         << std::setw(Constants::COL_ID) << "ID"
-         << std::setw(Constants::COL_LOC) << "Location"
-         << std::setw(Constants::COL_UPTIME) << "Uptime"
-         << std::setw(Constants::COL_LOAD) << "Load"
-         << std::setw(Constants::COL_REL) << "Reliability"
-         << std::setw(Constants::COL_STAB) << "Stability" << "\n"
-         << std::string(Constants::LINE_WIDTH, '-') << "\n";
-
-    // Write filtered data rows
-    for (const auto& [id, result] : results) {
-        if (result.has_opencl_result && result.has_python_result) {
-            file << std::left
-                 << std::setw(Constants::COL_ID) << result.id
-                 << std::setw(Constants::COL_LOC) << result.location
-                 << std::setw(Constants::COL_UPTIME) << result.uptime
-                 << std::fixed << std::setprecision(2)
-                 << std::setw(Constants::COL_LOAD) << result.load
-                 << std::setprecision(4)
-                 << std::setw(Constants::COL_REL) << result.reliability
-                 << std::setw(Constants::COL_STAB) << result.stability << "\n";
-        }
-    }
-
-    file << std::string(Constants::LINE_WIDTH, '=') << "\n";
+    const size_t rows = table.size();
+    const auto ids = table.ids();
+    const auto uptimes = table.uptimes();
+    const auto loads = table.loads();
+
+    // Initial data rows; the rows passing both filters are picked up in
+    // the same pass
+    const size_t initial_chunks = chunk_count(rows);
+    std::vector<std::string> initial(initial_chunks);
+    std::vector<std::vector<int32_t>> passed(initial_chunks);
+    parallel_chunks(
+        rows, initial_chunks, [&](size_t chunk, size_t begin, size_t end) {
+            format_initial(table, results, begin, end, &initial[chunk],
+                           &passed[chunk]);
+        });
+
+    // Filtered results are listed in id order
+    std::vector<int32_t> passed_rows;
+    for (const auto& chunk : passed) {
+        passed_rows.insert(passed_rows.end(), chunk.begin(), chunk.end());
+    }
+    std::sort(passed_rows.begin(), passed_rows.end(),
+              [&ids](int32_t a, int32_t b) { return ids[a] < ids[b]; });
+
+    const size_t filtered_chunks = chunk_count(passed_rows.size());
+    std::vector<std::string> filtered(filtered_chunks);
+    parallel_chunks(
+        passed_rows.size(), filtered_chunks,
+        [&](size_t chunk, size_t begin, size_t end) {
+            std::string& out = filtered[chunk];
+            out.reserve((end - begin) * Constants::LINE_WIDTH);
+            LineWriter line(&out);
+            for (size_t i = begin; i < end; i++) {
+                const int32_t row = passed_rows[i];
+                format_filtered(&line, ids[row], table.location(row),
+                                uptimes[row], loads[row],
+                                results.reliability[row],
+                                results.stability[row]);
+            }
+        });
+
+    // Chunk buffers are large: each write goes straight to the file
+    auto write = [&file](const std::string& data) {
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    };
+    write(report_header(rows, results.counts));
+    for (const auto& chunk : initial) {
+        write(chunk);
+    }
+    write(report_middle());
+    for (const auto& chunk : filtered) {
+        write(chunk);
+    }
+    write(report_footer());
 
+    if (!file) {
+        std::cerr << Color::RED << "[Error] Cannot write output\n"
+                  << Color::RESET;
+        return;
+    }
+
+    std::cout << Color::GREEN << "[Output] " << Color::RESET
+              << results.counts.both << " records -> " << filename
+              << "\n";
+}
+
+SpilledReport::SpilledReport(const std::string& filename)
+    : filename_(filename),
+      initial_path_(filename + ".initial.part"),
+      passed_path_(filename + ".passed.part") {
+    const std::filesystem::path parent =
+        std::filesystem::path(filename).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+    initial_.open(initial_path_, std::ios::binary | std::ios::trunc);
+    passed_.open(passed_path_, std::ios::binary | std::ios::trunc);
+    if (!initial_ || !passed_) {
+        remove_spills();
+        throw std::runtime_error("Cannot create spill files for " +
+                                 filename);
+    }
+}
+
+SpilledReport::~SpilledReport() {
+    remove_spills();
+}
+
+void SpilledReport::remove_spills() {
+    initial_.close();
+    passed_.close();
+    std::error_code ec;
+    std::filesystem::remove(initial_path_, ec);
+    std::filesystem::remove(passed_path_, ec);
+}
+
+void SpilledReport::add_window(const ServerTable& table,
+                               const ResultSnapshot& results) {
+    const size_t rows = table.size();
+    const size_t chunks = chunk_count(rows);
+    std::vector<std::string> initial(chunks);
+    std::vector<std::vector<int32_t>> passed(chunks);
+    parallel_chunks(rows, chunks, [&](size_t chunk, size_t begin,
+                                      size_t end) {
+        format_initial(table, results, begin, end, &initial[chunk],
+                       &passed[chunk]);
+    });
+    for (const auto& chunk : initial) {
+        initial_.write(chunk.data(),
+                       static_cast<std::streamsize>(chunk.size()));
+    }
+
+    // This window's run, in id order
+    const auto ids = table.ids();
+    std::vector<Passed> run;
+    for (const auto& chunk : passed) {
+        for (int32_t row : chunk) {
+            run.push_back(Passed{
+                .id = ids[row],
+                .uptime = table.uptimes()[row],
+                .load = table.loads()[row],
+                .location_id = table.location_ids()[row],
+                .reliability = results.reliability[row],
+                .stability = results.stability[row]
+            });
+        }
+    }
+    std::sort(run.begin(), run.end(),
+              [](const Passed& a, const Passed& b) { return a.id < b.id; });
+    passed_.write(reinterpret_cast<const char*>(run.data()),
+                  static_cast<std::streamsize>(run.size() * sizeof(Passed)));
+    if (!initial_ || !passed_) {
+        throw std::runtime_error("Cannot write spill files for " +
+                                 filename_);
+    }
+
+    runs_.push_back(runs_.back() + run.size());
+    rows_ += rows;
+    counts_.opencl += results.counts.opencl;
+    counts_.python += results.counts.python;
+    counts_.both += results.counts.both;
+}
+
+bool SpilledReport::finish(const std::vector<std::string>& locations) {
+    initial_.close();
+    passed_.close();
+    std::ofstream file = create_report(filename_);
+    std::ifstream spilled(passed_path_, std::ios::binary);
+    if (!file || !spilled) {
+        std::cerr << Color::RED << "[Error] Cannot create output\n"
+                  << Color::RESET;
+        remove_spills();
+        return false;
+    }
+
+    auto write = [&file](const std::string& data) {
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    };
+    write(report_header(rows_, counts_));
+    if (std::filesystem::file_size(initial_path_) > 0) {
+        std::ifstream initial(initial_path_, std::ios::binary);
+        file << initial.rdbuf();
+    }
+    write(report_middle());
+
+    // k-way merge of the runs, a buffer of records per run
+    struct RunReader {
+        uint64_t next;
+        uint64_t end;
+        std::vector<Passed> buffer;
+        size_t pos = 0;
+    };
+    std::vector<RunReader> readers;
+    for (size_t r = 0; r + 1 < runs_.size(); r++) {
+        readers.push_back(RunReader{runs_[r], runs_[r + 1], {}});
+    }
+    auto refill = [&spilled](RunReader* reader) {
+        const uint64_t count = std::min<uint64_t>(
+            Config::SPILL_MERGE_RECORDS, reader->end - reader->next);
+        reader->buffer.resize(count);
+        reader->pos = 0;
+        spilled.seekg(static_cast<std::streamoff>(reader->next *
+                                                  sizeof(Passed)));
+        spilled.read(reinterpret_cast<char*>(reader->buffer.data()),
+                     static_cast<std::streamsize>(count * sizeof(Passed)));
+        reader->next += count;
+        return count > 0;
+    };
+
+    // (id, run): equal ids keep the order of their windows
+    using Head = std::pair<int32_t, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (size_t r = 0; r < readers.size(); r++) {
+        if (refill(&readers[r])) {
+            heads.emplace(readers[r].buffer[0].id, r);
+        }
+    }
+
+    std::string out;
+    LineWriter line(&out);
+    while (!heads.empty()) {
+        RunReader& reader = readers[heads.top().second];
+        heads.pop();
+        const Passed& record = reader.buffer[reader.pos++];
+        format_filtered(&line, record.id, locations[record.location_id],
+                        record.uptime, record.load, record.reliability,
+                        record.stability);
+        if (out.size() >= Config::SPILL_WRITE_BYTES) {
+            write(out);
+            out.clear();
+        }
+        if (reader.pos < reader.buffer.size() || refill(&reader)) {
+            heads.emplace(reader.buffer[reader.pos].id,
+                          static_cast<size_t>(&reader - readers.data()));
+        }
+    }
+    write(out);
+    write(report_footer());
+
+    const bool ok = static_cast<bool>(file) && static_cast<bool>(spilled);
+    spilled.close();
+    remove_spills();
+    if (!ok) {
+        std::cerr << Color::RED << "[Error] Cannot write output\n"
+                  << Color::RESET;
+        return false;
+    }
     std::cout << Color::GREEN << "[Output] " << Color::RESET
-              << both_passed << " records -> " << Config::OUTPUT_FILE << "\n";
+              << counts_.both << " records -> " << filename_ << "\n";
+    return true;
 }
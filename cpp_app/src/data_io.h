@@ -3,31 +3,106 @@
 #ifndef CPP_APP_SRC_DATA_IO_H_
 #define CPP_APP_SRC_DATA_IO_H_
 
-#include <map>
+#include <cstdint>
+#include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "src/channel.h"
+#include "src/server_table.h"
 #include "src/types.h"
 
 /**
  * Load server data from JSON file.
+ * The file is memory-mapped and parsed with a streaming (SAX) parser, so
+ * no DOM is built. Rows are appended to the table as they are parsed and
+ * published to every consumer in chunks of Config::LOAD_CHUNK_ROWS; the
+ * consumers may process a chunk while parsing continues.
+ *
  * @param filename Path to JSON file
- * @param servers Output vector for server data
- * @param results Output map for server results
+ * @param table Output table (records appended in file order)
+ * @param consumers Receive the published row ranges; closed on return,
+ *                  also after a failure
  * @return true on success, false on failure
  */
-bool load_data(
-    const std::string& filename,
-    std::vector<ServerData>* servers,
-    std::map<int, ServerResult>* results);
+bool load_data(const std::string& filename, ServerTable* table,
+               const std::vector<Channel<RowRange>*>& consumers);
+
+/**
+ * Load server data from an in-memory JSON document with the same
+ * "servers" array as an input file (inline job requests).
+ * @param consumers Receive the published row ranges; closed on return
+ * @return true on success, false on failure
+ */
+bool load_inline(std::string_view text, ServerTable* table,
+                 const std::vector<Channel<RowRange>*>& consumers);
 
 /**
  * Write final results to output file.
- * @param servers Original server data (for initial data section)
- * @param results Map of server results
+ * @param table Server table (input columns)
+ * @param results Snapshot of the computed scores
+ * @param filename Report path (Config::OUTPUT_FILE for one-shot runs);
+ *                 its directory is created
+ */
+void write_output(const ServerTable& table, const ResultSnapshot& results,
+                  const std::string& filename);
+
+/**
+ * The same report written window by window (--memory-budget), so that no
+ * more than one window is formatted at a time. Initial data lines are
+ * spilled to a file next to the report as each window finishes; the
+ * window's rows passing both filters are spilled as one id-sorted run.
+ * finish() writes the statistics, copies the initial lines and merges the
+ * runs. Duplicate ids are only resolved within a window.
  */
-void write_output(
-    const std::vector<ServerData>& servers,
-    const std::map<int, ServerResult>& results);
+class SpilledReport {
+ public:
+    /**
+     * @param filename Report path; its directory is created and the spill
+     *                 files are put next to it
+     * @throws std::runtime_error if a spill file cannot be created
+     */
+    explicit SpilledReport(const std::string& filename);
+    ~SpilledReport();
+
+    SpilledReport(const SpilledReport&) = delete;
+    SpilledReport& operator=(const SpilledReport&) = delete;
+
+    /**
+     * Spill one finished window.
+     * @throws std::runtime_error if a spill file cannot be written
+     */
+    void add_window(const ServerTable& table, const ResultSnapshot& results);
+
+    /**
+     * Write the report and remove the spill files.
+     * @param locations Location names of the windows' location ids
+     * @return true on success, false on failure
+     */
+    bool finish(const std::vector<std::string>& locations);
+
+ private:
+    // One spilled row that passed both filters
+    struct Passed {
+        int32_t id;
+        int32_t uptime;
+        float load;
+        uint32_t location_id;
+        float reliability;
+        float stability;
+    };
+
+    void remove_spills();
+
+    std::string filename_;
+    std::string initial_path_;
+    std::string passed_path_;
+    std::ofstream initial_;
+    std::ofstream passed_;
+    std::vector<uint64_t> runs_{0};   // First record of each run, then end
+    size_t rows_ = 0;
+    ResultCounts counts_;
+};
 
 #endif  // CPP_APP_SRC_DATA_IO_H_
@@ -0,0 +1,236 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/executor.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "src/utils.h"
+
+namespace {
+
+/**
+ * Top of a started task: owns it and reports its end to the future.
+ */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() {
+            return Detached{
+                std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+Detached run_detached(Task task, std::promise<void> done) {
+    try {
+        co_await task;
+        done.set_value();
+    } catch (...) {
+        done.set_exception(std::current_exception());
+    }
+}
+
+}  // namespace
+
+Executor::Executor() : context_(1) {
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    }
+    thread_ = std::jthread([this](std::stop_token stop) { loop(stop); });
+}
+
+Executor::~Executor() {
+    thread_.request_stop();
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written =
+        ::write(wake_fd_, &one, sizeof(one));
+    thread_.join();
+    ::close(wake_fd_);
+}
+
+std::future<void> Executor::start(Task task) {
+    std::promise<void> done;
+    std::future<void> finished = done.get_future();
+    post(run_detached(std::move(task), std::move(done)).handle);
+    return finished;
+}
+
+void Executor::post(std::coroutine_handle<> handle) {
+    {
+        std::scoped_lock lock(mutex_);
+        posted_.push_back(handle);
+    }
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written =
+        ::write(wake_fd_, &one, sizeof(one));
+}
+
+bool Executor::SocketAwaiter::await_ready() {
+    if (executor_->error_) {
+        error_ = executor_->error_;
+        return true;
+    }
+    if (socket_ == nullptr) {
+        return deadline_ <= Clock::now();
+    }
+    // Level check first: most waits are already satisfied
+    ready_ = (socket_->get(zmq::sockopt::events) & events_) != 0;
+    return ready_;
+}
+
+void Executor::SocketAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    executor_->waits_.push_back(Wait{
+        .socket = socket_,
+        .events = events_,
+        .deadline = deadline_,
+        .handle = handle,
+        .ready = &ready_,
+        .error = &error_
+    });
+}
+
+void Executor::loop(std::stop_token stop) {
+    while (!stop.stop_requested()) {
+        resume_posted();
+        try {
+            poll();
+        } catch (const std::system_error& e) {
+            fail(e);
+            break;
+        }
+    }
+    // No more polling; posted coroutines still run, and any socket wait
+    // or timer they start fails right away
+    while (!stop.stop_requested()) {
+        resume_posted();
+        wait_posted();
+    }
+}
+
+void Executor::fail(const std::system_error& error) {
+    std::cerr << Color::RED << "[Executor] " << error.what()
+              << ", failing " << waits_.size() << " waiting coroutine(s)"
+              << Color::RESET << "\n";
+    error_ = std::make_exception_ptr(error);
+    std::vector<Wait> waits;
+    waits.swap(waits_);
+    for (const Wait& wait : waits) {
+        *wait.error = error_;
+    }
+    for (const Wait& wait : waits) {
+        wait.handle.resume();
+    }
+}
+
+void Executor::wait_posted() {
+    {
+        std::scoped_lock lock(mutex_);
+        if (!posted_.empty()) {
+            return;
+        }
+    }
+    ::pollfd wake{wake_fd_, POLLIN, 0};
+    if (::poll(&wake, 1, -1) > 0) {
+        uint64_t count = 0;
+        [[maybe_unused]] const ssize_t read =
+            ::read(wake_fd_, &count, sizeof(count));
+    }
+}
+
+void Executor::resume_posted() {
+    std::vector<std::coroutine_handle<>> posted;
+    {
+        std::scoped_lock lock(mutex_);
+        posted.swap(posted_);
+    }
+    for (std::coroutine_handle<> handle : posted) {
+        handle.resume();
+    }
+}
+
+void Executor::poll() {
+    // The wake fd first, then every socket somebody waits on
+    std::vector<zmq_pollitem_t> items{{nullptr, wake_fd_, ZMQ_POLLIN, 0}};
+    std::vector<size_t> polled;
+    Clock::time_point deadline = Clock::time_point::max();
+    for (size_t w = 0; w < waits_.size(); w++) {
+        if (waits_[w].socket != nullptr) {
+            items.push_back({waits_[w].socket->handle(), 0,
+                             waits_[w].events, 0});
+            polled.push_back(w);
+        }
+        deadline = std::min(deadline, waits_[w].deadline);
+    }
+
+    long timeout_ms = -1;  // NOLINT(runtime/int): zmq_poll's type
+    {
+        std::scoped_lock lock(mutex_);
+        if (!posted_.empty()) {
+            timeout_ms = 0;
+        }
+    }
+    if (timeout_ms < 0 && deadline != Clock::time_point::max()) {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - Clock::now());
+        timeout_ms = std::max<long>(0, left.count());  // NOLINT
+    }
+
+    if (zmq_poll(items.data(), static_cast<int>(items.size()),
+                 timeout_ms) < 0 && errno != EINTR) {
+        // ETERM included: the context is gone, polling again would spin
+        throw std::system_error(errno, std::generic_category(), "zmq_poll");
+    }
+    if (items[0].revents & ZMQ_POLLIN) {
+        uint64_t count = 0;
+        [[maybe_unused]] const ssize_t read =
+            ::read(wake_fd_, &count, sizeof(count));
+    }
+
+    // Resume only after the list is settled: a resumed coroutine may
+    // wait again
+    for (size_t i = 0; i < polled.size(); i++) {
+        if (items[i + 1].revents != 0) {
+            *waits_[polled[i]].ready = true;
+        }
+    }
+    const auto now = Clock::now();
+    std::vector<std::coroutine_handle<>> resumed;
+    std::erase_if(waits_, [&](const Wait& wait) {
+        if (!*wait.ready && wait.deadline > now) {
+            return false;
+        }
+        resumed.push_back(wait.handle);
+        return true;
+    });
+    for (std::coroutine_handle<> handle : resumed) {
+        handle.resume();
+    }
+}
+
+void Wakeup::notify() {
+    if (waiter_) {
+        executor_->post(std::exchange(waiter_, nullptr));
+    } else {
+        pending_ = true;
+    }
+}
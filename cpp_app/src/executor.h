@@ -0,0 +1,260 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_EXECUTOR_H_
+#define CPP_APP_SRC_EXECUTOR_H_
+
+#include <zmq.hpp>
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/channel.h"
+
+/**
+ * Coroutine of the executor's control thread. Starts when awaited (or
+ * given to Executor::start) and resumes its awaiter when done; an
+ * exception escaping the coroutine is rethrown there.
+ */
+class [[nodiscard]] Task {
+ public:
+    struct promise_type {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+
+        Task get_return_object() {
+            return Task(
+                std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct Resume {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(
+                    std::coroutine_handle<promise_type> done) noexcept {
+                    const std::coroutine_handle<> next =
+                        done.promise().continuation;
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return Resume{};
+        }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&&) = delete;
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+    void await_resume() const {
+        if (handle_.promise().error) {
+            std::rethrow_exception(handle_.promise().error);
+        }
+    }
+
+ private:
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * Runs the pipeline's control flow (socket I/O, the result stream) as
+ * coroutines on one control thread instead of one blocking thread per
+ * role. A coroutine suspends on a ZMQ socket becoming readable or
+ * writable (zmq_poll), a timer, a Channel receiving an item or a Wakeup;
+ * other threads hand work to it with post(). Every ZMQ socket of the
+ * process is made from its context().
+ *
+ * Only coroutines may wait; they must not block, or every other
+ * coroutine stalls with them. Sockets awaited here are used on the
+ * control thread only.
+ *
+ * If zmq_poll fails (including ETERM once the context is gone), every
+ * socket wait and timer fails with that error, rethrown in its
+ * coroutine, and so does every later one. The control thread then only
+ * resumes posted coroutines until the executor is destroyed.
+ */
+class Executor {
+ public:
+    using Clock = std::chrono::steady_clock;
+
+    Executor();
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    zmq::context_t& context() { return context_; }
+
+    /**
+     * Run task on the control thread.
+     * @return Ready once the task has finished; holds its exception
+     */
+    std::future<void> start(Task task);
+
+    /**
+     * Resume a suspended coroutine on the control thread (any thread).
+     */
+    void post(std::coroutine_handle<> handle);
+
+    /**
+     * Suspend until a socket has events or the deadline passes.
+     */
+    class SocketAwaiter {
+     public:
+        SocketAwaiter(Executor* executor, zmq::socket_t* socket,
+                      short events, Clock::time_point deadline)
+            : executor_(executor), socket_(socket), events_(events),
+              deadline_(deadline) {}
+
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        /**
+         * @return false if the deadline passed first
+         * @throws std::system_error if the executor's poll failed
+         */
+        bool await_resume() const {
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            return ready_;
+        }
+
+     private:
+        Executor* executor_;
+        zmq::socket_t* socket_;
+        short events_;
+        Clock::time_point deadline_;
+        bool ready_ = false;
+        std::exception_ptr error_;
+    };
+
+    /**
+     * Wait for a message (ZMQ_POLLIN).
+     */
+    SocketAwaiter readable(
+        zmq::socket_t* socket,
+        Clock::time_point deadline = Clock::time_point::max()) {
+        return SocketAwaiter(this, socket, ZMQ_POLLIN, deadline);
+    }
+    SocketAwaiter readable(zmq::socket_t* socket,
+                           std::chrono::milliseconds timeout) {
+        return readable(socket, Clock::now() + timeout);
+    }
+
+    /**
+     * Wait until a message can be queued without blocking (ZMQ_POLLOUT).
+     */
+    SocketAwaiter writable(zmq::socket_t* socket) {
+        return SocketAwaiter(this, socket, ZMQ_POLLOUT,
+                             Clock::time_point::max());
+    }
+
+    SocketAwaiter sleep_for(std::chrono::milliseconds delay) {
+        return SocketAwaiter(this, nullptr, 0, Clock::now() + delay);
+    }
+
+    /**
+     * Suspend until channel has an item or is closed; pop it with
+     * try_pop(). One coroutine may wait on a channel at a time.
+     */
+    template <typename T>
+    auto ready(Channel<T>* channel) {
+        struct Awaiter {
+            Executor* executor;
+            Channel<T>* channel;
+            std::coroutine_handle<> handle;
+
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> waiting) {
+                handle = waiting;
+                return channel->notify_when_ready(
+                    [this] { executor->post(handle); });
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this, channel, {}};
+    }
+
+ private:
+    struct Wait {
+        zmq::socket_t* socket;       // nullptr = timer only
+        short events;
+        Clock::time_point deadline;
+        std::coroutine_handle<> handle;
+        bool* ready;
+        std::exception_ptr* error;
+    };
+
+    void loop(std::stop_token stop);
+    void resume_posted();
+    void poll();
+    void fail(const std::system_error& error);
+    void wait_posted();
+
+    zmq::context_t context_;
+    int wake_fd_ = -1;               // eventfd, polled beside the sockets
+
+    std::mutex mutex_;
+    std::vector<std::coroutine_handle<>> posted_;
+
+    std::vector<Wait> waits_;        // Control thread only
+    std::exception_ptr error_;       // Poll failure, control thread only
+    std::jthread thread_;
+};
+
+/**
+ * Wakes one coroutine waiting for a condition that another coroutine
+ * changes, e.g. the receiver granting the sender credits. A notify()
+ * before the wait is kept. Control thread only.
+ */
+class Wakeup {
+ public:
+    explicit Wakeup(Executor* executor) : executor_(executor) {}
+
+    void notify();
+
+    auto wait() {
+        struct Awaiter {
+            Wakeup* wakeup;
+
+            bool await_ready() const noexcept {
+                return std::exchange(wakeup->pending_, false);
+            }
+            void await_suspend(std::coroutine_handle<> handle) {
+                wakeup->waiter_ = handle;
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this};
+    }
+
+ private:
+    Executor* executor_;
+    std::coroutine_handle<> waiter_;
+    bool pending_ = false;
+};
+
+#endif  // CPP_APP_SRC_EXECUTOR_H_
@@ -0,0 +1,346 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/job_server.h"
+
+#include <zmq.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <stop_token>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "src/binary_format.h"
+#include "src/config.h"
+#include "src/core_scheduler.h"
+#include "src/data_io.h"
+#include "src/executor.h"
+#include "src/location_summary.h"
+#include "src/metrics.h"
+#include "src/opencl_session.h"
+#include "src/pipeline.h"
+#include "src/result_stream.h"
+#include "src/run_snapshot.h"
+#include "src/score_cache.h"
+#include "src/server_table.h"
+#include "src/utils.h"
+#include "src/worker_cluster.h"
+#include "src/zmq_comm.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+/**
+ * Request fields other than the inline records, which are parsed
+ * straight into the table by load_inline instead.
+ */
+struct JobRequest {
+    json fields;
+    bool inline_servers = false;
+};
+
+JobRequest parse_request(std::string_view text) {
+    JobRequest request;
+    request.fields = json::parse(
+        text.begin(), text.end(),
+        [&request](int depth, json::parse_event_t event, json& parsed) {
+            if (event == json::parse_event_t::key && depth == 1 &&
+                parsed == "servers") {
+                request.inline_servers = true;
+                return false;  // Skip the array, the loader reads it
+            }
+            return true;
+        });
+    if (!request.fields.is_object()) {
+        throw std::runtime_error("Request must be a JSON object");
+    }
+    return request;
+}
+
+/**
+ * Records passing both filters, in id order (same rows as the report).
+ */
+json passed_records(const ServerTable& table,
+                    const ResultSnapshot& results) {
+    const auto ids = table.ids();
+    std::vector<int32_t> rows;
+    for (size_t r = 0; r < table.size(); r++) {
+        const auto row = static_cast<int32_t>(r);
+        if (results.has_opencl_result(row) &&
+            results.has_python_result(row) &&
+            table.row_of(ids[r]) == row) {
+            rows.push_back(row);
+        }
+    }
+    std::sort(rows.begin(), rows.end(),
+              [&ids](int32_t a, int32_t b) { return ids[a] < ids[b]; });
+
+    json records = json::array();
+    for (int32_t row : rows) {
+        records.push_back({
+            {"id", ids[row]},
+            {"location", table.location(row)},
+            {"uptime", table.uptimes()[row]},
+            {"load", table.loads()[row]},
+            {"reliability", results.reliability[row]},
+            {"stability", results.stability[row]}
+        });
+    }
+    return records;
+}
+
+/**
+ * Serves the metrics over plain HTTP on a ZMQ_STREAM socket until
+ * stopped. Any request gets the current exposition, then the connection
+ * is closed. Runs on the executor beside the job loop so it answers
+ * during jobs too.
+ */
+Task metrics_endpoint(Executor* executor, std::stop_token stop) {
+    try {
+        zmq::socket_t sock(executor->context(), ZMQ_STREAM);
+        sock.bind(Config::METRICS_ADDR);
+        std::cout << Color::BLUE << "[Server] " << Color::RESET
+                  << "Metrics on " << Config::METRICS_ADDR << "\n";
+
+        while (!stop.stop_requested()) {
+            if (!co_await executor->readable(
+                    &sock,
+                    std::chrono::milliseconds(Config::METRICS_POLL_MS))) {
+                continue;
+            }
+            zmq::message_t identity;
+            zmq::message_t request;
+            if (!sock.recv(identity, zmq::recv_flags::dontwait) ||
+                !sock.recv(request) || request.size() == 0) {
+                continue;  // Connect and disconnect notices are empty
+            }
+
+            const std::string body = metrics().prometheus();
+            const std::string response =
+                "HTTP/1.0 200 OK\r\n"
+                "Content-Type: text/plain; version=0.0.4\r\n"
+                "Content-Length: " + std::to_string(body.size()) +
+                "\r\n\r\n" + body;
+            sock.send(zmq::buffer(identity.data(), identity.size()),
+                      zmq::send_flags::sndmore);
+            sock.send(zmq::buffer(response), zmq::send_flags::none);
+            // An empty frame closes the connection
+            sock.send(zmq::buffer(identity.data(), identity.size()),
+                      zmq::send_flags::sndmore);
+            sock.send(zmq::message_t(), zmq::send_flags::none);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Server] Metrics: " << e.what()
+                  << Color::RESET << "\n";
+    }
+}
+
+/**
+ * State kept for the daemon's lifetime.
+ */
+struct ServerState {
+    ServerState(const Options& job_options, Executor* job_executor)
+        : options(job_options),
+          executor(job_executor),
+          workers(&job_executor->context(), job_options.wire_transport),
+          cluster(&job_executor->context()),
+          cores(job_options.co_schedule),
+          scores(job_options.score_cache),
+          stream(job_executor, job_options.stream),
+          rollup(job_options.summary) {}
+
+    const Options& options;
+    Executor* executor;
+    OpenCLSession session;
+    WorkerLink workers;
+    WorkerCluster cluster;
+    CoreScheduler cores;
+    ScoreCache scores;
+    ResultStream stream;
+    LocationRollup rollup;
+    int jobs = 0;
+};
+
+json run_job(ServerState* state, const JobRequest& request,
+             std::string_view text) {
+    const json& fields = request.fields;
+    TableLoader load;
+    if (fields.contains("input")) {
+        const std::string input = fields.at("input").get<std::string>();
+        load = [input](ServerTable* table,
+                       const std::vector<Channel<RowRange>*>& consumers) {
+            if (is_binary_inventory(input)) {
+                return load_binary(input, table, consumers);
+            }
+            return load_data(input, table, consumers);
+        };
+    } else if (request.inline_servers) {
+        load = [text](ServerTable* table,
+                      const std::vector<Channel<RowRange>*>& consumers) {
+            return load_inline(text, table, consumers);
+        };
+    } else {
+        throw std::runtime_error("Request needs \"input\" or \"servers\"");
+    }
+
+    const int job = ++state->jobs;
+    std::cout << Color::BLUE << "[Server] " << Color::RESET << "Job " << job
+              << "\n";
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // A job may re-score against its own previous run, or pick its
+    // precision (each parameter set gets its own kernel build)
+    Options options = state->options;
+    if (fields.contains("delta")) {
+        options.delta = fields.at("delta").get<std::string>();
+    }
+    if (fields.contains("precision") &&
+        !score_preset(fields.at("precision").get<std::string>(),
+                      &options.params)) {
+        throw std::runtime_error("\"precision\" is full or quick");
+    }
+    options.params.reliability_iterations = fields.value(
+        "iterations", options.params.reliability_iterations);
+    options.params.stability_iterations = fields.value(
+        "stability_iterations", options.params.stability_iterations);
+    if (fields.contains("early_exit")) {
+        const int checks = fields.at("early_exit").get<int>();
+        options.params.reliability_exit_checks = checks;
+        options.params.stability_exit_checks = checks;
+    }
+    if (options.params.reliability_iterations < 1 ||
+        options.params.stability_iterations < 1 ||
+        options.params.reliability_exit_checks < 0) {
+        throw std::runtime_error("Invalid iteration or early-exit count");
+    }
+
+    ServerTable table;
+    if (!run_pipeline(options, state->executor, &state->session,
+                      &state->workers, &state->cluster, &state->cores,
+                      &state->scores, &state->stream, &state->rollup,
+                      &table, load)) {
+        throw std::runtime_error("Cannot load the job's records");
+    }
+    const ResultSnapshot results = table.snapshot();
+
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+
+    if (fields.contains("output")) {
+        const std::string output = fields.at("output").get<std::string>();
+        write_output(table, results, output);
+        write_run_snapshot(table, results, state->scores.known(),
+                           job_score_parameters(options),
+                           job_score_engines(options),
+                           snapshot_path(output));
+        write_location_summary(table.location_names(),
+                               state->rollup.locations(),
+                               summary_path(output));
+    }
+
+    json reply = {
+        {"ok", true},
+        {"job", job},
+        {"records", table.size()},
+        {"filter1", results.counts.opencl},
+        {"filter2", results.counts.python},
+        {"both", results.counts.both},
+        {"elapsed_ms", elapsed_ms}
+    };
+    if (fields.value("results", true)) {
+        reply["results"] = passed_records(table, results);
+    }
+    if (fields.value("locations", true)) {
+        reply["locations"] = location_summary_json(
+            table.location_names(), state->rollup.locations());
+    }
+
+    std::cout << Color::BLUE << "[Server] " << Color::RESET << "Job " << job
+              << ": " << results.counts.both << "/" << table.size()
+              << " passed both, " << elapsed_ms << " ms\n";
+    return reply;
+}
+
+/**
+ * The job loop: one reply per request on the control socket.
+ */
+int serve_jobs(const Options& options, Executor* executor) {
+    try {
+        zmq::socket_t control(executor->context(), ZMQ_REP);
+        control.bind(Config::ZMQ_CONTROL_ADDR);
+        SocketMetrics* control_metrics = metrics().socket("control");
+
+        ServerState state(options, executor);
+        std::cout << Color::BLUE << "[Server] " << Color::RESET
+                  << "Waiting for jobs on " << Config::ZMQ_CONTROL_ADDR
+                  << "\n";
+
+        bool running = true;
+        while (running) {
+            zmq::message_t request;
+            if (!control.recv(request)) {
+                continue;
+            }
+            control_metrics->received(request.size());
+            const std::string_view text = request.to_string_view();
+
+            json reply;
+            try {
+                const JobRequest job = parse_request(text);
+                const std::string command = job.fields.value("command", "");
+                if (command == "shutdown") {
+                    reply = {{"ok", true}};
+                    running = false;
+                } else if (command == "metrics") {
+                    reply = {{"ok", true},
+                             {"metrics", metrics().prometheus()}};
+                } else {
+                    reply = run_job(&state, job, text);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << Color::RED << "[Server] " << e.what()
+                          << Color::RESET << "\n";
+                reply = {{"ok", false}, {"error", e.what()}};
+            }
+            const std::string out = reply.dump();
+            control.send(zmq::buffer(out), zmq::send_flags::none);
+            control_metrics->sent(out.size());
+        }
+
+        std::cout << Color::BLUE << "[Server] " << Color::RESET
+                  << "Shut down after " << state.jobs << " job(s)\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Server] " << e.what() << Color::RESET
+                  << "\n";
+        return 1;
+    }
+}
+
+}  // namespace
+
+int serve(const Options& options) {
+    try {
+        Executor executor;
+        std::stop_source stop_metrics;
+        std::future<void> endpoint = executor.start(
+            metrics_endpoint(&executor, stop_metrics.get_token()));
+        const int code = serve_jobs(options, &executor);
+        stop_metrics.request_stop();
+        endpoint.get();
+        return code;
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Server] " << e.what() << Color::RESET
+                  << "\n";
+        return 1;
+    }
+}
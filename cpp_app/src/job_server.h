@@ -0,0 +1,32 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_JOB_SERVER_H_
+#define CPP_APP_SRC_JOB_SERVER_H_
+
+#include "src/options.h"
+
+/**
+ * Daemon mode (--serve).
+ * Binds a REP socket on Config::ZMQ_CONTROL_ADDR and runs one job per
+ * JSON request with the pipeline selected by the options. OpenCL state
+ * (see OpenCLSession) and the sockets to the Python workers are kept
+ * across jobs, so a job pays only for loading and computing.
+ *
+ * Requests:
+ * - {"input": "<path>"} - JSON or binary inventory file
+ * - {"servers": [...]} - inline records, same fields as an input file
+ *   Optional: "output": report path, "results": false to omit the
+ *   records passing both filters from the reply
+ * - {"command": "metrics"} - reply with "metrics", the Prometheus text
+ *   also served over HTTP on Config::METRICS_ADDR
+ * - {"command": "shutdown"} - reply and return
+ *
+ * Every request gets one JSON reply with "ok" and either the job's
+ * counts, time and results or an "error" message.
+ *
+ * @param options Pipeline options applied to every job
+ * @return Process exit code
+ */
+int serve(const Options& options);
+
+#endif  // CPP_APP_SRC_JOB_SERVER_H_
@@ -1,8 +1,129 @@
-// Reliability calculation + Filter 1
+// Reliability calculation + Filter 1, stability calculation + Filter 2
 // Author: IFF-3-2 Aleksandravicius Linas
 
+// The stability recurrence is double precision in the Python workers
+#ifdef cl_khr_fp64
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+typedef double real_t;
+#else
+typedef float real_t;
+#endif
+
+// Score parameters, given by the host as -D options (score_params.h).
+// UNROLL must divide ITERATIONS, STABILITY_UNROLL STABILITY_ITERATIONS.
+#ifndef ITERATIONS
 #define ITERATIONS 4000000
+#endif
+#ifndef UNROLL
+#define UNROLL 1
+#endif
+#ifndef THRESHOLD
 #define THRESHOLD 50.0f
+#endif
+
+#ifndef STABILITY_ITERATIONS
+#define STABILITY_ITERATIONS 600000
+#endif
+#ifndef STABILITY_UNROLL
+#define STABILITY_UNROLL 1
+#endif
+#ifndef STABILITY_THRESHOLD
+#define STABILITY_THRESHOLD 50.0
+#endif
+
+// Early exit (0 = exact): stop once the state stayed on one side of the
+// threshold for EXIT_CHECKS checks of EXIT_CHECK iterations in a row.
+// EXIT_CHECK must be a multiple of both unroll factors.
+#ifndef EXIT_CHECK
+#define EXIT_CHECK 4096
+#endif
+#ifndef EXIT_CHECKS
+#define EXIT_CHECKS 0
+#endif
+#ifndef STABILITY_EXIT_CHECKS
+#define STABILITY_EXIT_CHECKS 0
+#endif
+
+float reliability_score(int uptime, float load) {
+    float reliability = 0.5f;
+#if EXIT_CHECKS > 0
+    float lo = 2.0f;
+    float hi = -1.0f;
+    int side = 0;
+    int streak = 0;
+#endif
+    for (int base = 0; base < ITERATIONS; base += UNROLL) {
+        // Constant trip count: fully unrolled by the compiler
+        for (int u = 0; u < UNROLL; u++) {
+            int i = base + u;
+            float f1 = sin((float)uptime / 1000.0f * (float)i);
+            float f2 = cos(load * (float)i);
+            reliability = fabs(sin(reliability + f1 - f2));
+#if EXIT_CHECKS > 0
+            lo = fmin(lo, reliability);
+            hi = fmax(hi, reliability);
+#endif
+        }
+#if EXIT_CHECKS > 0
+        if ((base + UNROLL) % EXIT_CHECK == 0) {
+            int now = (lo * 100.0f >= THRESHOLD) ? 1
+                    : (hi * 100.0f < THRESHOLD) ? -1 : 0;
+            streak = (now != 0 && now == side) ? streak + 1 : (now != 0);
+            side = now;
+            lo = 2.0f;
+            hi = -1.0f;
+            if (streak >= EXIT_CHECKS) {
+                break;
+            }
+        }
+#endif
+    }
+    return reliability * 100.0f;
+}
+
+real_t stability_score(int id, float load, int uptime) {
+    // Python's % is never negative for a positive modulus
+    int seed = ((id % 10) + 10) % 10;
+    real_t stability = 0.5 + seed * 0.01;
+    real_t load_r = (real_t)load;
+    real_t uptime_r = (real_t)uptime;
+
+#if STABILITY_EXIT_CHECKS > 0
+    real_t lo = 2.0;
+    real_t hi = -1.0;
+    int side = 0;
+    int streak = 0;
+#endif
+    for (int base = 0; base < STABILITY_ITERATIONS;
+         base += STABILITY_UNROLL) {
+        for (int u = 0; u < STABILITY_UNROLL; u++) {
+            int i = base + u;
+            real_t f1 = cos(load_r * 0.001 * (real_t)i);
+            real_t f2 = sin(uptime_r / 10000.0 * (real_t)i);
+            real_t f3 =
+                (fabs(stability) < 100.0) ? tan(stability * 0.01) : 0.0;
+            stability = fabs(sin(stability + f1 * f2 - f3 * 0.001));
+#if STABILITY_EXIT_CHECKS > 0
+            lo = fmin(lo, stability);
+            hi = fmax(hi, stability);
+#endif
+        }
+#if STABILITY_EXIT_CHECKS > 0
+        if ((base + STABILITY_UNROLL) % EXIT_CHECK == 0) {
+            int now = (lo * 100.0 >= STABILITY_THRESHOLD) ? 1
+                    : (hi * 100.0 < STABILITY_THRESHOLD) ? -1 : 0;
+            streak = (now != 0 && now == side) ? streak + 1 : (now != 0);
+            side = now;
+            lo = 2.0;
+            hi = -1.0;
+            if (streak >= STABILITY_EXIT_CHECKS) {
+                break;
+            }
+        }
+#endif
+    }
+    return stability * 100.0;
+}
 
 __kernel void compute_reliability(
     __global const int* uptimes,
@@ -17,21 +138,174 @@ __kernel void compute_reliability(
     int gsize = get_global_size(0);
 
     for (int idx = gid; idx < count; idx += gsize) {
-        float reliability = 0.5f;
+        float reliability = reliability_score(uptimes[idx], loads[idx]);
+
+        if (reliability >= THRESHOLD) {
+            int out_idx = atomic_inc(counter);
+            out_reliability[out_idx] = reliability;
+            out_ids[out_idx] = ids[idx];
+        }
+    }
+}
+
+__kernel void compute_stability(
+    __global const int* uptimes,
+    __global const float* loads,
+    __global const int* ids,
+    __global float* out_stability,
+    __global int* out_ids,
+    __global int* counter,
+    const int count
+) {
+    int gid = get_global_id(0);
+    int gsize = get_global_size(0);
+
+    for (int idx = gid; idx < count; idx += gsize) {
+        int id = ids[idx];
+        real_t stability = stability_score(id, loads[idx], uptimes[idx]);
+
+        if (stability >= STABILITY_THRESHOLD) {
+            int out_idx = atomic_inc(counter);
+            out_stability[out_idx] = (float)stability;
+            out_ids[out_idx] = id;
+        }
+    }
+}
+
+// Both filters in one pass; only rows passing both are emitted.
+// single_counts[0] / [1] count rows passing only Filter 1 / Filter 2.
+__kernel void compute_both(
+    __global const int* uptimes,
+    __global const float* loads,
+    __global const int* ids,
+    __global float* out_reliability,
+    __global int* out_ids,
+    __global int* counter,
+    const int count,
+    __global float* out_stability,
+    __global int* single_counts
+) {
+    int gid = get_global_id(0);
+    int gsize = get_global_size(0);
+
+    for (int idx = gid; idx < count; idx += gsize) {
+        int id = ids[idx];
         int uptime = uptimes[idx];
         float load = loads[idx];
 
-        for (int i = 0; i < ITERATIONS; i++) {
-            float f1 = sin((float)uptime / 1000.0f * (float)i);
-            float f2 = cos(load * (float)i);
-            reliability = fabs(sin(reliability + f1 - f2));
-        }
-        reliability *= 100.0f;
+        float reliability = reliability_score(uptime, load);
+        real_t stability = stability_score(id, load, uptime);
+        bool pass1 = reliability >= THRESHOLD;
+        bool pass2 = stability >= STABILITY_THRESHOLD;
 
-        if (reliability >= THRESHOLD) {
+        if (pass1 && pass2) {
             int out_idx = atomic_inc(counter);
             out_reliability[out_idx] = reliability;
-            out_ids[out_idx] = ids[idx];
+            out_stability[out_idx] = (float)stability;
+            out_ids[out_idx] = id;
+        } else if (pass1) {
+            atomic_inc(&single_counts[0]);
+        } else if (pass2) {
+            atomic_inc(&single_counts[1]);
+        }
+    }
+}
+
+// Per-location rollup (LocationRollup, --summary device). flags are the
+// table's result flags; rows shadowed by a duplicate id are marked
+// ROW_SHADOWED by the host and skipped.
+#define BOTH_PASSED 0x03
+#define ROW_SHADOWED 0x80
+
+// Per location in local memory: SUMMARY_FLOATS sums (reliability,
+// stability), SUMMARY_INTS counts and extrema (records, passed, min and
+// max reliability, min and max stability as order-preserving int keys)
+#define SUMMARY_FLOATS 2
+#define SUMMARY_INTS 6
+
+inline int float_key(float value) {
+    int bits = as_int(value);
+    return (bits >= 0) ? bits : bits ^ 0x7FFFFFFF;
+}
+
+// Float add on local memory through compare-and-swap (no native float
+// atomics in OpenCL 1.2)
+inline void local_add(volatile __local float* target, float value) {
+    volatile __local int* bits = (volatile __local int*)target;
+    int current = *bits;
+    while (true) {
+        int seen = atomic_cmpxchg(bits, current,
+                                  as_int(as_float(current) + value));
+        if (seen == current) {
+            break;
+        }
+        current = seen;
+    }
+}
+
+// Each work-group reduces its share of the rows into one aggregate per
+// location id in local memory, then writes them as its partial:
+// group_sums[(group * locations + loc) * SUMMARY_FLOATS + k], likewise
+// group_ints. The host merges the partials.
+__kernel void summarize_locations(
+    __global const uint* location_ids,
+    __global const uchar* flags,
+    __global const float* reliability,
+    __global const float* stability,
+    const int count,
+    const int locations,
+    __global float* group_sums,
+    __global int* group_ints,
+    __local float* sums,
+    __local int* ints
+) {
+    int lid = get_local_id(0);
+    int lsize = get_local_size(0);
+
+    for (int loc = lid; loc < locations; loc += lsize) {
+        sums[loc * SUMMARY_FLOATS] = 0.0f;
+        sums[loc * SUMMARY_FLOATS + 1] = 0.0f;
+        ints[loc * SUMMARY_INTS] = 0;
+        ints[loc * SUMMARY_INTS + 1] = 0;
+        ints[loc * SUMMARY_INTS + 2] = INT_MAX;
+        ints[loc * SUMMARY_INTS + 3] = INT_MIN;
+        ints[loc * SUMMARY_INTS + 4] = INT_MAX;
+        ints[loc * SUMMARY_INTS + 5] = INT_MIN;
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    int gsize = get_global_size(0);
+    for (int idx = get_global_id(0); idx < count; idx += gsize) {
+        uchar flag = flags[idx];
+        if (flag == ROW_SHADOWED) {
+            continue;
+        }
+        int loc = (int)location_ids[idx];
+        atomic_inc(&ints[loc * SUMMARY_INTS]);
+        if (flag != BOTH_PASSED) {
+            continue;
+        }
+        float r = reliability[idx];
+        float s = stability[idx];
+        atomic_inc(&ints[loc * SUMMARY_INTS + 1]);
+        local_add(&sums[loc * SUMMARY_FLOATS], r);
+        local_add(&sums[loc * SUMMARY_FLOATS + 1], s);
+        atomic_min(&ints[loc * SUMMARY_INTS + 2], float_key(r));
+        atomic_max(&ints[loc * SUMMARY_INTS + 3], float_key(r));
+        atomic_min(&ints[loc * SUMMARY_INTS + 4], float_key(s));
+        atomic_max(&ints[loc * SUMMARY_INTS + 5], float_key(s));
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    int base = get_group_id(0) * locations;
+    for (int loc = lid; loc < locations; loc += lsize) {
+        for (int k = 0; k < SUMMARY_FLOATS; k++) {
+            group_sums[(base + loc) * SUMMARY_FLOATS + k] =
+                sums[loc * SUMMARY_FLOATS + k];
+        }
+        for (int k = 0; k < SUMMARY_INTS; k++) {
+            group_ints[(base + loc) * SUMMARY_INTS + k] =
+                ints[loc * SUMMARY_INTS + k];
         }
     }
 }
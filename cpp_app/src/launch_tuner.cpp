@@ -0,0 +1,193 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/launch_tuner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>  // NOLINT(build/c++17)
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "src/config.h"
+#include "src/program_cache.h"
+#include "src/utils.h"
+
+namespace {
+
+constexpr char TUNE_MAGIC[] = "CLTUNE";
+constexpr int TUNE_VERSION = 1;
+constexpr size_t MIN_LOCAL_SIZE = 16;
+constexpr int MAX_ROWS_PER_ITEM = 8;
+
+std::filesystem::path tune_path(const std::string& key) {
+    return std::filesystem::path(Config::PROGRAM_CACHE_DIR) /
+           (cache_hash_hex(key) + ".tune");
+}
+
+/**
+ * File layout (text): "CLTUNE <version>", "local_size <n>",
+ * "rows_per_item <n>".
+ */
+bool read_tune(const std::filesystem::path& path, LaunchConfig* out) {
+    std::ifstream file(path);
+    std::string magic;
+    std::string local_label;
+    std::string rows_label;
+    int version = 0;
+    LaunchConfig config{};
+    file >> magic >> version >> local_label >> config.local_size
+         >> rows_label >> config.rows_per_item;
+    if (!file || magic != TUNE_MAGIC || version != TUNE_VERSION ||
+        local_label != "local_size" || rows_label != "rows_per_item" ||
+        config.local_size == 0 || config.rows_per_item < 1) {
+        return false;
+    }
+    *out = config;
+    return true;
+}
+
+void write_tune(const std::filesystem::path& path,
+                const LaunchConfig& config) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    // Per-writer temporary + rename, as for the program cache
+    const std::filesystem::path tmp = cache_temp_path(path);
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (file) {
+            file << TUNE_MAGIC << ' ' << TUNE_VERSION << '\n'
+                 << "local_size " << config.local_size << '\n'
+                 << "rows_per_item " << config.rows_per_item << '\n';
+        }
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+    }
+}
+
+std::vector<size_t> local_sizes(const cl::Device& device,
+                                const cl::Kernel& kernel) {
+    const size_t limit = std::min(
+        kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device),
+        device.getInfo<CL_DEVICE_MAX_WORK_GROUP_SIZE>());
+    const size_t multiple = std::max<size_t>(
+        1, kernel.getWorkGroupInfo<
+               CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE>(device));
+
+    std::vector<size_t> sizes;
+    for (size_t size = multiple; size <= limit; size *= 2) {
+        if (size >= MIN_LOCAL_SIZE) {
+            sizes.push_back(size);
+        }
+    }
+    if (sizes.empty() && limit > 0) {
+        sizes.push_back(limit);
+    }
+    return sizes;
+}
+
+/**
+ * Kernel execution time of one launch, from the profiling counters.
+ * @return false if the launch, the wait or the query failed
+ */
+bool kernel_ns(const TuneLaunch& launch, const LaunchConfig& config,
+               size_t global, uint64_t* ns) {
+    cl::Event event;
+    if (launch(config, global, &event) != CL_SUCCESS ||
+        event.wait() != CL_SUCCESS) {
+        return false;
+    }
+    cl_int start_err = CL_SUCCESS;
+    cl_int end_err = CL_SUCCESS;
+    const cl_ulong start =
+        event.getProfilingInfo<CL_PROFILING_COMMAND_START>(&start_err);
+    const cl_ulong end =
+        event.getProfilingInfo<CL_PROFILING_COMMAND_END>(&end_err);
+    if (start_err != CL_SUCCESS || end_err != CL_SUCCESS || end < start) {
+        return false;
+    }
+    *ns = end - start;
+    return true;
+}
+
+}  // namespace
+
+size_t launch_global_size(const LaunchConfig& config, int count) {
+    const size_t items =
+        (static_cast<size_t>(count) + config.rows_per_item - 1) /
+        config.rows_per_item;
+    return std::max<size_t>(1, (items + config.local_size - 1) /
+                                   config.local_size) *
+           config.local_size;
+}
+
+LaunchConfig tune_launch(
+    const cl::Device& device,
+    const cl::Kernel& kernel,
+    const std::string& key,
+    const TuneLaunch& launch) {
+    const std::string full_key = device.getInfo<CL_DEVICE_NAME>() + '\n' +
+                                 device.getInfo<CL_DRIVER_VERSION>() +
+                                 '\n' + key;
+    const std::filesystem::path path = tune_path(full_key);
+
+    LaunchConfig best{Config::DEFAULT_LOCAL_SIZE, 1};
+    if (read_tune(path, &best)) {
+        std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+                  << "Launch config " << best.local_size << " x "
+                  << best.rows_per_item << " (tuned)\n";
+        return best;
+    }
+
+    uint64_t best_ns = std::numeric_limits<uint64_t>::max();
+    uint64_t default_ns = 0;
+    for (size_t local : local_sizes(device, kernel)) {
+        for (int rows = 1; rows <= MAX_ROWS_PER_ITEM; rows *= 2) {
+            const LaunchConfig config{local, rows};
+            const size_t global =
+                launch_global_size(config, Config::TUNE_SAMPLE_ROWS);
+            uint64_t ns = std::numeric_limits<uint64_t>::max();
+            bool valid = true;
+            for (int r = 0; r < Config::TUNE_REPEATS && valid; r++) {
+                uint64_t sample = 0;
+                valid = kernel_ns(launch, config, global, &sample);
+                ns = std::min(ns, sample);
+            }
+            if (!valid) {
+                continue;   // Geometry the device rejects
+            }
+            if (local == Config::DEFAULT_LOCAL_SIZE && rows == 1) {
+                default_ns = ns;
+            }
+            if (ns < best_ns) {
+                best_ns = ns;
+                best = config;
+            }
+        }
+    }
+    if (best_ns == std::numeric_limits<uint64_t>::max()) {
+        return best;  // Nothing ran: keep the default, save nothing
+    }
+
+    write_tune(path, best);
+    std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+              << "Launch config " << best.local_size << " x "
+              << best.rows_per_item << " tuned, " << best_ns / 1000
+              << " us per sample";
+    if (default_ns > 0) {
+        std::cout << " (" << Config::DEFAULT_LOCAL_SIZE << " x 1: "
+                  << default_ns / 1000 << " us)";
+    }
+    std::cout << "\n";
+    return best;
+}
@@ -0,0 +1,56 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_LAUNCH_TUNER_H_
+#define CPP_APP_SRC_LAUNCH_TUNER_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "src/opencl_common.h"
+
+/**
+ * Launch geometry of a grid-stride kernel.
+ */
+struct LaunchConfig {
+    size_t local_size;       // Work-group size
+    int rows_per_item;       // Records per work-item (grid-stride factor)
+};
+
+/**
+ * Global size covering count records with the given geometry, rounded
+ * up to whole work-groups.
+ */
+size_t launch_global_size(const LaunchConfig& config, int count);
+
+/**
+ * Enqueue one timing launch with the given geometry on a profiling queue
+ * and set *done to its kernel event.
+ * @return CL_SUCCESS, or the error of the first call that failed
+ */
+using TuneLaunch = std::function<cl_int(const LaunchConfig& config,
+                                        size_t global, cl::Event* done)>;
+
+/**
+ * Best launch geometry for a kernel on one device. A stored result is
+ * reused when its key matches (device name, driver version and the
+ * caller's key); otherwise every supported local size (multiples of the
+ * preferred work-group multiple up to the kernel limit) is swept with
+ * 1, 2, 4 and 8 records per work-item, timed from the profiling events,
+ * and the fastest configuration is saved next to the program cache. A
+ * candidate whose launch, wait or profiling query fails is skipped; if
+ * none ran, nothing is saved.
+ *
+ * @param device Target device
+ * @param kernel Kernel the limits are read from
+ * @param key Kernel name, source hash and build options
+ * @param launch Enqueues one sample launch
+ * @return Fastest configuration, the default geometry if nothing ran
+ */
+LaunchConfig tune_launch(
+    const cl::Device& device,
+    const cl::Kernel& kernel,
+    const std::string& key,
+    const TuneLaunch& launch);
+
+#endif  // CPP_APP_SRC_LAUNCH_TUNER_H_
@@ -0,0 +1,223 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/location_summary.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>  // NOLINT(build/c++17)
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "src/opencl_processor.h"
+#include "src/utils.h"
+
+namespace {
+
+using json = nlohmann::json;
+
+// Job numbers of every rollup in the process, so a thread's cached shard
+// of an earlier job (or rollup at the same address) is never reused
+std::atomic<uint64_t> next_job{1};
+
+/**
+ * Loaded records per location, without the rows shadowed by a duplicate.
+ */
+void count_records(const ServerTable& table, LocationAggregates* out) {
+    out->resize(table.location_names().size());
+    for (uint32_t location : table.location_ids()) {
+        (*out)[location].records++;
+    }
+    for (int32_t row : table.shadowed_rows()) {
+        (*out)[table.location_ids()[row]].records--;
+    }
+}
+
+json score_range(double sum, float min, float max, int64_t passed) {
+    if (passed == 0) {
+        return nullptr;
+    }
+    return {
+        {"mean", sum / static_cast<double>(passed)},
+        {"min", min},
+        {"max", max}
+    };
+}
+
+}  // namespace
+
+void LocationAggregate::add(float reliability, float stability) {
+    passed++;
+    reliability_sum += reliability;
+    stability_sum += stability;
+    reliability_min = std::min(reliability_min, reliability);
+    reliability_max = std::max(reliability_max, reliability);
+    stability_min = std::min(stability_min, stability);
+    stability_max = std::max(stability_max, stability);
+}
+
+void LocationAggregate::merge(const LocationAggregate& other) {
+    records += other.records;
+    passed += other.passed;
+    reliability_sum += other.reliability_sum;
+    stability_sum += other.stability_sum;
+    reliability_min = std::min(reliability_min, other.reliability_min);
+    reliability_max = std::max(reliability_max, other.reliability_max);
+    stability_min = std::min(stability_min, other.stability_min);
+    stability_max = std::max(stability_max, other.stability_max);
+}
+
+LocationAggregates summarize_locations(const ServerTable& table,
+                                       const ResultSnapshot& results) {
+    LocationAggregates locations;
+    count_records(table, &locations);
+    const auto ids = table.ids();
+    const auto location_ids = table.location_ids();
+    for (size_t r = 0; r < table.size(); r++) {
+        const auto row = static_cast<int32_t>(r);
+        if (results.has_opencl_result(row) &&
+            results.has_python_result(row) &&
+            table.row_of(ids[r]) == row) {
+            locations[location_ids[r]].add(results.reliability[r],
+                                           results.stability[r]);
+        }
+    }
+    return locations;
+}
+
+void LocationRollup::begin(ServerTable* table) {
+    table_ = table;
+    job_ = next_job.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::scoped_lock lock(mutex_);
+        shards_.clear();
+    }
+    locations_.clear();
+    if (mode_ == SummaryMode::kHost) {
+        table->add_completion_hook([this](int32_t row) { add(row); });
+    }
+}
+
+LocationRollup::Shard* LocationRollup::shard() {
+    thread_local uint64_t cached_job = 0;
+    thread_local Shard* cached = nullptr;
+    if (cached_job != job_) {
+        std::scoped_lock lock(mutex_);
+        shards_.push_back(std::make_unique<Shard>());
+        cached = shards_.back().get();
+        cached_job = job_;
+    }
+    return cached;
+}
+
+void LocationRollup::add(int32_t row) {
+    Shard* own = shard();
+    if (table_->row_of(table_->ids()[row]) != row) {
+        own->shadowed++;
+        return;
+    }
+    // The dictionary may still grow; ids only ever get appended
+    const uint32_t location = table_->location_ids()[row];
+    if (location >= own->locations.size()) {
+        own->locations.resize(location + 1);
+    }
+    own->locations[location].add(table_->reliability(row),
+                                 table_->stability(row));
+}
+
+void LocationRollup::finish(const ServerTable& table,
+                            OpenCLSession* session,
+                            const OpenCLSettings& settings) {
+    if (mode_ == SummaryMode::kDevice) {
+        const ResultSnapshot results = table.snapshot();
+        if (!summarize_locations_on_device(session, settings, table, results,
+                                           &locations_)) {
+            std::cout << Color::YELLOW << "[Summary] " << Color::RESET
+                      << "Rolling up locations on the host\n";
+            locations_ = summarize_locations(table, results);
+        }
+        return;
+    }
+
+    // Shadowed rows that passed both must all have been skipped
+    int64_t skipped = 0;
+    for (const auto& part : shards_) {
+        skipped += part->shadowed;
+    }
+    int64_t shadowed_passed = 0;
+    for (int32_t row : table.shadowed_rows()) {
+        shadowed_passed += (table.flags(row) ==
+                            (RESULT_OPENCL | RESULT_PYTHON)) ? 1 : 0;
+    }
+    if (skipped != shadowed_passed) {
+        locations_ = summarize_locations(table, table.snapshot());
+        return;
+    }
+
+    count_records(table, &locations_);
+    for (const auto& part : shards_) {
+        for (size_t l = 0; l < part->locations.size(); l++) {
+            locations_[l].merge(part->locations[l]);
+        }
+    }
+}
+
+std::string summary_path(const std::string& output) {
+    return std::filesystem::path(output)
+        .replace_extension(".locations.json").string();
+}
+
+nlohmann::json location_summary_json(const std::vector<std::string>& names,
+                                     const LocationAggregates& locations) {
+    std::vector<size_t> order;
+    for (size_t l = 0; l < locations.size(); l++) {
+        if (locations[l].records > 0) {
+            order.push_back(l);
+        }
+    }
+    std::sort(order.begin(), order.end(),
+              [&names](size_t a, size_t b) { return names[a] < names[b]; });
+
+    json summary = json::array();
+    for (size_t l : order) {
+        const LocationAggregate& location = locations[l];
+        summary.push_back({
+            {"location", names[l]},
+            {"records", location.records},
+            {"passed", location.passed},
+            {"reliability", score_range(location.reliability_sum,
+                                        location.reliability_min,
+                                        location.reliability_max,
+                                        location.passed)},
+            {"stability", score_range(location.stability_sum,
+                                      location.stability_min,
+                                      location.stability_max,
+                                      location.passed)}
+        });
+    }
+    return summary;
+}
+
+bool write_location_summary(const std::vector<std::string>& names,
+                            const LocationAggregates& locations,
+                            const std::string& filename) {
+    const std::filesystem::path path(filename);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << Color::RED << "[Summary] Cannot write " << filename
+                  << Color::RESET << "\n";
+        return false;
+    }
+    out << location_summary_json(names, locations).dump(2) << "\n";
+    std::cout << Color::GREEN << "[Summary] " << Color::RESET
+              << "Location summary -> " << filename << "\n";
+    return true;
+}
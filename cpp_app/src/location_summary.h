@@ -0,0 +1,135 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_LOCATION_SUMMARY_H_
+#define CPP_APP_SRC_LOCATION_SUMMARY_H_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "src/options.h"
+#include "src/server_table.h"
+
+class OpenCLSession;
+struct OpenCLSettings;
+
+/**
+ * Rollup of one location: loaded records, records passing both filters
+ * and their score ranges. Sums are kept so that partials merge exactly.
+ */
+struct LocationAggregate {
+    int64_t records = 0;
+    int64_t passed = 0;
+    double reliability_sum = 0.0;
+    double stability_sum = 0.0;
+    float reliability_min = std::numeric_limits<float>::infinity();
+    float reliability_max = -std::numeric_limits<float>::infinity();
+    float stability_min = std::numeric_limits<float>::infinity();
+    float stability_max = -std::numeric_limits<float>::infinity();
+
+    void add(float reliability, float stability);
+    void merge(const LocationAggregate& other);
+};
+
+/**
+ * Per-location rollups indexed by the table's location ids.
+ */
+using LocationAggregates = std::vector<LocationAggregate>;
+
+/**
+ * Rollup of every row of a finished job in one pass over the results
+ * (the fallback of both modes).
+ */
+LocationAggregates summarize_locations(const ServerTable& table,
+                                       const ResultSnapshot& results);
+
+/**
+ * Per-location rollup of a job (count passed, mean/min/max of both
+ * scores), kept across jobs like ResultStream.
+ *
+ * Host mode computes it while the job runs: a completion hook adds every
+ * row passing both filters to a partial aggregate owned by the
+ * publishing thread, so the producers share nothing, and the partials
+ * are merged once the stages are done. Records are counted from the
+ * location column at the end. A row that passed before a later duplicate
+ * of its id was loaded cannot be taken out of its partial's minimum and
+ * maximum; finish() then falls back to summarize_locations().
+ *
+ * Device mode reduces the final result columns on the OpenCL device
+ * instead (summarize_locations_on_device), falling back to the host pass
+ * without a device.
+ */
+class LocationRollup {
+ public:
+    explicit LocationRollup(SummaryMode mode) : mode_(mode) {}
+
+    LocationRollup(const LocationRollup&) = delete;
+    LocationRollup& operator=(const LocationRollup&) = delete;
+
+    SummaryMode mode() const { return mode_; }
+
+    /**
+     * Start a job: hook into the table before any stage starts (host
+     * mode only).
+     */
+    void begin(ServerTable* table);
+
+    /**
+     * Compute the job's rollup once every result is final.
+     * @param session OpenCL state of the job (device mode)
+     * @param settings Program build settings of the job (device mode)
+     */
+    void finish(const ServerTable& table, OpenCLSession* session,
+                const OpenCLSettings& settings);
+
+    /**
+     * Aggregates of the last finished job, by location id.
+     */
+    const LocationAggregates& locations() const { return locations_; }
+
+ private:
+    struct Shard {
+        LocationAggregates locations;
+        int64_t shadowed = 0;     // Rows skipped as shadowed when passing
+    };
+
+    Shard* shard();
+    void add(int32_t row);
+
+    SummaryMode mode_;
+    const ServerTable* table_ = nullptr;
+    uint64_t job_ = 0;          // Tells this job's shards from older ones
+    std::mutex mutex_;          // Guards shards_
+    std::vector<std::unique_ptr<Shard>> shards_;
+    LocationAggregates locations_;
+};
+
+/**
+ * Summary path for a report, e.g. results/output.txt ->
+ * results/output.locations.json.
+ */
+std::string summary_path(const std::string& output);
+
+/**
+ * Rollups as a JSON array, one object per location with at least one
+ * record, sorted by name (names: the table's location_names()):
+ * location, records, passed, and reliability / stability {mean, min,
+ * max} over the passed records (null if none).
+ */
+nlohmann::json location_summary_json(const std::vector<std::string>& names,
+                                     const LocationAggregates& locations);
+
+/**
+ * Write location_summary_json() to a file.
+ * @return true on success, false on failure
+ */
+bool write_location_summary(const std::vector<std::string>& names,
+                            const LocationAggregates& locations,
+                            const std::string& filename);
+
+#endif  // CPP_APP_SRC_LOCATION_SUMMARY_H_
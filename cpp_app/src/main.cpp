@@ -2,85 +2,129 @@
 
 /**
  * OpenCL: reliability calculation + Filter 1 (reliability >= 50)
- * Communication with Python via ZeroMQ binary protocol
+ * Communication with Python via ZeroMQ binary protocol, or a native
+ * stability thread pool (--stability native), or an OpenCL stability
+ * kernel (--stability opencl, --pipeline fused). With --serve the
+ * process stays up and takes jobs on a control socket (job_server.h).
  *
  * Performance measurements (300 records):
  * - Single worker (Python) + OpenCL: ~54 seconds
  * - Full parallelization (Python N-1) + OpenCL: ~10 seconds
  * - Single worker OpenCL: Not available due to AMD driver limitations
+ * Per-stage timings on generated inventories: bench_app (bench_main.cpp).
  */
 
 #include <chrono>
 #include <iostream>
-#include <map>
-#include <mutex>
-#include <string>
-#include <thread>
 #include <vector>
 
+#include "src/binary_format.h"
+#include "src/channel.h"
+#include "src/config.h"
+#include "src/core_scheduler.h"
 #include "src/data_io.h"
-#include "src/opencl_processor.h"
+#include "src/executor.h"
+#include "src/job_server.h"
+#include "src/location_summary.h"
+#include "src/opencl_session.h"
+#include "src/options.h"
+#include "src/out_of_core.h"
+#include "src/pipeline.h"
+#include "src/result_stream.h"
+#include "src/run_snapshot.h"
+#include "src/score_cache.h"
+#include "src/server_table.h"
 #include "src/types.h"
 #include "src/utils.h"
+#include "src/worker_cluster.h"
 #include "src/zmq_comm.h"
 
-namespace {
-
-std::string parse_input_file(int argc, char* argv[]) {
-    std::string input = "../data/IFF-3-2_AleksandraviciusLinas_L2_dat_1.json";
-    for (int i = 1; i < argc; i++) {
-        if (argv[i][0] != '-') {
-            input = argv[i];
-        }
-    }
-    return input;
-}
-
-}  // namespace
-
 int main(int argc, char* argv[]) {
     std::cout.setf(std::ios::unitbuf);
     std::cout << Color::BOLD << "\n=== C++ Application ==="
               << Color::RESET << "\n";
 
-    const std::string input_file = parse_input_file(argc, argv);
+    Options options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+    if (!options.serve) {
+        std::cout << Color::BLUE << "[Main] " << Color::RESET
+                  << "Input: " << options.input_file << "\n";
+    }
+
     std::cout << Color::BLUE << "[Main] " << Color::RESET
-              << "Input: " << input_file << "\n";
+              << "Pipeline: " << pipeline_name(options.pipeline)
+              << ", stability: "
+              << ((options.pipeline == PipelineMode::kFused)
+                      ? "opencl (fused)"
+                      : stability_name(options.stability))
+              << "\n";
+
+    if (options.serve) {
+        return serve(options);
+    }
+
+    // Shared data structures; the executor's control thread and ZMQ
+    // context outlive every socket
+    Executor executor;
+    ServerTable table;
+    OpenCLSession opencl_session;
+    WorkerLink workers(&executor.context(), options.wire_transport);
+    WorkerCluster cluster(&executor.context());
+    CoreScheduler cores(options.co_schedule);
+    ScoreCache scores(options.score_cache);
+    ResultStream stream(&executor, options.stream);
+    LocationRollup rollup(options.summary);
 
-    // Shared data structures
-    std::vector<ServerData> servers;
-    std::map<int, ServerResult> results;
-    std::mutex results_mutex;
+    auto start = std::chrono::high_resolution_clock::now();
 
-    // Load data
-    if (!load_data(input_file, &servers, &results)) {
+    if (options.memory_budget > 0) {
+        if (!run_out_of_core(options, &executor, &opencl_session, &workers,
+                             &cluster, &cores, &scores, &stream, &rollup,
+                             Config::OUTPUT_FILE)) {
+            return 1;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        std::cout << Color::BOLD << "\n[Main] Total: " << elapsed << " ms"
+                  << Color::RESET << "\n";
+        return 0;
+    }
+
+    const bool loaded = run_pipeline(
+        options, &executor, &opencl_session, &workers, &cluster, &cores,
+        &scores, &stream, &rollup, &table,
+        [&options](ServerTable* out,
+                   const std::vector<Channel<RowRange>*>& consumers) {
+            if (is_binary_inventory(options.input_file)) {
+                return load_binary(options.input_file, out, consumers);
+            }
+            return load_data(options.input_file, out, consumers);
+        });
+
+    if (!loaded) {
         return 1;
     }
-    if (servers.empty()) {
+    if (table.empty()) {
         std::cerr << Color::RED << "[Error] No data" << Color::RESET << "\n";
         return 1;
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
-
-    {
-        std::jthread t_opencl(opencl_thread,
-                              std::cref(servers),
-                              &results,
-                              &results_mutex);
-        std::jthread t_sender(sender_thread, std::cref(servers));
-        std::jthread t_receiver(receiver_thread,
-                                &results,
-                                &results_mutex);
-    }  // All threads auto-join here
-
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::high_resolution_clock::now() - start).count();
 
     // Write output
-    write_output(servers, results);
-
-    std::cout << Color::BOLD << "\n[Main] Total: " << elapsed << "s"
+    const ResultSnapshot results = table.snapshot();
+    write_output(table, results, Config::OUTPUT_FILE);
+    write_run_snapshot(table, results, scores.known(),
+                       job_score_parameters(options),
+                       job_score_engines(options),
+                       snapshot_path(Config::OUTPUT_FILE));
+    write_location_summary(table.location_names(), rollup.locations(),
+                           summary_path(Config::OUTPUT_FILE));
+
+    std::cout << Color::BOLD << "\n[Main] Total: " << elapsed << " ms"
               << Color::RESET << "\n";
 
     return 0;
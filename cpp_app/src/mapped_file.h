@@ -0,0 +1,44 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_MAPPED_FILE_H_
+#define CPP_APP_SRC_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file.
+ * Pages are faulted in on first access, so mapping a large file is cheap
+ * and only the parts actually read use memory.
+ */
+class MappedFile {
+ public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Map a file, replacing any previous mapping.
+     * @return false if the file cannot be opened or mapped
+     */
+    bool open(const std::string& filename);
+
+    void close();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    /**
+     * Drop the pages of [offset, offset + size) from memory; they are
+     * read from the file again on the next access.
+     */
+    void release(size_t offset, size_t size) const;
+
+ private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif  // CPP_APP_SRC_MAPPED_FILE_H_
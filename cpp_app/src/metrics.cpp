@@ -0,0 +1,382 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "src/config.h"
+#include "src/utils.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string series_name(const std::string& name, const std::string& labels) {
+    return labels.empty() ? name : name + "{" + labels + "}";
+}
+
+/**
+ * Series with a suffix on the metric name, e.g. foo{a="b"} -> foo_max{a="b"}.
+ */
+std::string with_suffix(const std::string& series, const std::string& suffix) {
+    const size_t brace = series.find('{');
+    if (brace == std::string::npos) {
+        return series + suffix;
+    }
+    return series.substr(0, brace) + suffix + series.substr(brace);
+}
+
+std::string metric_name(const std::string& series) {
+    return series.substr(0, series.find('{'));
+}
+
+/**
+ * Writes "# TYPE" once per metric name; series of one name are adjacent
+ * in every sorted map.
+ */
+class ExpositionWriter {
+ public:
+    void add(const std::string& series, const char* type, int64_t value) {
+        const std::string name = metric_name(series);
+        if (name != last_) {
+            out_ << "# TYPE " << name << " " << type << "\n";
+            last_ = name;
+        }
+        out_ << series << " " << value << "\n";
+    }
+
+    std::string str() const { return out_.str(); }
+
+ private:
+    std::ostringstream out_;
+    std::string last_;
+};
+
+double mega(int64_t value) {
+    return static_cast<double>(value) / 1e6;
+}
+
+}  // namespace
+
+void Gauge::set(int64_t level) {
+    value.store(level, std::memory_order_relaxed);
+    record(level);
+}
+
+void Gauge::add(int64_t delta) {
+    record(value.fetch_add(delta, std::memory_order_relaxed) + delta);
+}
+
+void Gauge::record(int64_t level) {
+    int64_t seen = max.load(std::memory_order_relaxed);
+    while (level > seen &&
+           !max.compare_exchange_weak(seen, level,
+                                      std::memory_order_relaxed)) {
+    }
+    if (metrics().tracing()) {
+        metrics().sample(series, level);
+    }
+}
+
+int64_t MetricsRegistry::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Counter* MetricsRegistry::counter(const std::string& name,
+                                  const std::string& labels) {
+    std::scoped_lock lock(mutex_);
+    auto& slot = counters_[series_name(name, labels)];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    return slot.get();
+}
+
+Gauge* MetricsRegistry::gauge(const std::string& name,
+                              const std::string& labels) {
+    const std::string series = series_name(name, labels);
+    std::scoped_lock lock(mutex_);
+    auto& slot = gauges_[series];
+    if (!slot) {
+        slot = std::make_unique<Gauge>();
+        slot->series = series;
+    }
+    return slot.get();
+}
+
+SocketMetrics* MetricsRegistry::socket(const std::string& name) {
+    std::scoped_lock lock(mutex_);
+    auto& slot = sockets_[name];
+    if (!slot) {
+        slot = std::make_unique<SocketMetrics>();
+    }
+    return slot.get();
+}
+
+LockMetrics* MetricsRegistry::lock(const std::string& name) {
+    std::scoped_lock lock(mutex_);
+    auto& slot = locks_[name];
+    if (!slot) {
+        slot = std::make_unique<LockMetrics>();
+    }
+    return slot.get();
+}
+
+void MetricsRegistry::set_tracing(bool enabled) {
+    std::scoped_lock lock(trace_mutex_);
+    if (enabled && !tracing()) {
+        trace_start_ns_ = now_ns();
+    }
+    tracing_.store(enabled, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::span(TraceSpan span) {
+    if (!tracing()) {
+        return;
+    }
+    std::scoped_lock lock(trace_mutex_);
+    if (spans_.size() + samples_.size() >= Config::TRACE_MAX_EVENTS) {
+        dropped_++;
+        return;
+    }
+    spans_.push_back(std::move(span));
+}
+
+void MetricsRegistry::sample(const std::string& series, int64_t value) {
+    if (!tracing()) {
+        return;
+    }
+    const int64_t ts = now_ns();
+    std::scoped_lock lock(trace_mutex_);
+    if (spans_.size() + samples_.size() >= Config::TRACE_MAX_EVENTS) {
+        dropped_++;
+        return;
+    }
+    samples_.push_back(Sample{.series = series, .ts_ns = ts, .value = value});
+}
+
+bool MetricsRegistry::write_trace(const std::string& path) {
+    std::vector<TraceSpan> spans;
+    std::vector<Sample> samples;
+    int64_t start = 0;
+    int64_t dropped = 0;
+    {
+        std::scoped_lock lock(trace_mutex_);
+        spans.swap(spans_);
+        samples.swap(samples_);
+        start = trace_start_ns_;
+        dropped = dropped_;
+        trace_start_ns_ = now_ns();
+        dropped_ = 0;
+    }
+
+    // Timestamps are microseconds since the timeline started
+    auto us = [start](int64_t ns) {
+        return static_cast<double>(ns - start) / 1000.0;
+    };
+
+    json events = json::array();
+    std::map<std::string, int> tracks;
+    for (const TraceSpan& span : spans) {
+        const auto [it, added] =
+            tracks.emplace(span.track, static_cast<int>(tracks.size()) + 1);
+        if (added) {
+            events.push_back({
+                {"name", "thread_name"}, {"ph", "M"}, {"pid", 1},
+                {"tid", it->second}, {"args", {{"name", span.track}}}
+            });
+        }
+        json args = json::object();
+        if (span.queued_ns >= 0) {
+            args["queued_us"] = us(span.queued_ns);
+        }
+        if (span.submit_ns >= 0) {
+            args["submit_us"] = us(span.submit_ns);
+        }
+        if (span.records >= 0) {
+            args["records"] = span.records;
+        }
+        events.push_back({
+            {"name", span.name}, {"cat", span.category}, {"ph", "X"},
+            {"pid", 1}, {"tid", it->second}, {"ts", us(span.start_ns)},
+            {"dur", static_cast<double>(span.end_ns - span.start_ns) /
+                        1000.0},
+            {"args", args}
+        });
+    }
+    for (const Sample& sample : samples) {
+        events.push_back({
+            {"name", sample.series}, {"ph", "C"}, {"pid", 1},
+            {"ts", us(sample.ts_ns)}, {"args", {{"value", sample.value}}}
+        });
+    }
+
+    const std::filesystem::path file(path);
+    if (file.has_parent_path()) {
+        std::filesystem::create_directories(file.parent_path());
+    }
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << Color::RED << "[Metrics] Cannot write " << path
+                  << Color::RESET << "\n";
+        return false;
+    }
+    out << json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump()
+        << "\n";
+
+    std::cout << Color::CYAN << "[Metrics] " << Color::RESET << "Trace: "
+              << spans.size() << " spans, " << samples.size() << " samples";
+    if (dropped > 0) {
+        std::cout << ", " << dropped << " dropped";
+    }
+    std::cout << " -> " << path << "\n";
+    return true;
+}
+
+std::string MetricsRegistry::prometheus() const {
+    std::scoped_lock lock(mutex_);
+    ExpositionWriter out;
+    for (const auto& [series, counter] : counters_) {
+        out.add(series, "counter", counter->value.load());
+    }
+    for (const auto& [series, gauge] : gauges_) {
+        out.add(series, "gauge", gauge->value.load());
+    }
+    for (const auto& [series, gauge] : gauges_) {
+        out.add(with_suffix(series, "_max"), "gauge", gauge->max.load());
+    }
+
+    const std::pair<const char*, std::atomic<int64_t> SocketMetrics::*>
+        socket_series[] = {
+            {"lygiagretus_socket_messages_sent_total",
+             &SocketMetrics::messages_sent},
+            {"lygiagretus_socket_bytes_sent_total",
+             &SocketMetrics::bytes_sent},
+            {"lygiagretus_socket_messages_received_total",
+             &SocketMetrics::messages_received},
+            {"lygiagretus_socket_bytes_received_total",
+             &SocketMetrics::bytes_received}
+        };
+    for (const auto& [name, member] : socket_series) {
+        for (const auto& [socket, values] : sockets_) {
+            out.add(series_name(name, "socket=\"" + socket + "\""),
+                    "counter", ((*values).*member).load());
+        }
+    }
+
+    for (const auto& [name, lock_metrics] : locks_) {
+        out.add(series_name("lygiagretus_lock_contended_total",
+                            "lock=\"" + name + "\""),
+                "counter", lock_metrics->contended.load());
+    }
+    for (const auto& [name, lock_metrics] : locks_) {
+        out.add(series_name("lygiagretus_lock_wait_nanoseconds_total",
+                            "lock=\"" + name + "\""),
+                "counter", lock_metrics->wait_ns.load());
+    }
+    return out.str();
+}
+
+void MetricsRegistry::begin_job() {
+    std::scoped_lock lock(mutex_);
+    job_start_ns_ = now_ns();
+    job_base_.clear();
+    for (const auto& [name, socket] : sockets_) {
+        job_base_[name] = {socket->messages_sent.load(),
+                           socket->bytes_sent.load(),
+                           socket->messages_received.load(),
+                           socket->bytes_received.load()};
+    }
+    job_lock_wait_ns_ = 0;
+    for (const auto& [name, lock_metrics] : locks_) {
+        job_lock_wait_ns_ += lock_metrics->wait_ns.load();
+    }
+    for (const auto& [series, gauge] : gauges_) {
+        gauge->max.store(gauge->value.load());
+    }
+}
+
+void MetricsRegistry::end_job() {
+    std::scoped_lock lock(mutex_);
+    const double seconds =
+        std::max(static_cast<double>(now_ns() - job_start_ns_) / 1e9, 1e-9);
+
+    // Formatted apart so that the fixed precision stays off std::cout
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    for (const auto& [name, socket] : sockets_) {
+        // Sockets opened during the job start from zero
+        const std::array<int64_t, 4> base =
+            job_base_.contains(name) ? job_base_[name]
+                                     : std::array<int64_t, 4>{};
+        const int64_t sent = socket->messages_sent.load() - base[0];
+        const int64_t received = socket->messages_received.load() - base[2];
+        if (sent == 0 && received == 0) {
+            continue;
+        }
+        out << Color::CYAN << "[Metrics] " << Color::RESET << name
+            << ": sent " << sent / seconds << " msg/s "
+            << mega(socket->bytes_sent.load() - base[1]) / seconds
+            << " MB/s, received " << received / seconds << " msg/s "
+            << mega(socket->bytes_received.load() - base[3]) / seconds
+            << " MB/s\n";
+    }
+
+    int64_t lock_wait_ns = -job_lock_wait_ns_;
+    for (const auto& [name, lock_metrics] : locks_) {
+        lock_wait_ns += lock_metrics->wait_ns.load();
+    }
+    out << Color::CYAN << "[Metrics] " << Color::RESET
+        << "Lock wait " << mega(lock_wait_ns) << " ms";
+    for (const auto& [series, gauge] : gauges_) {
+        if (gauge->max.load() > 0) {
+            out << ", " << series << " max " << gauge->max.load();
+        }
+    }
+    out << "\n";
+    std::cout << out.str();
+}
+
+MetricsRegistry& metrics() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter* stage_errors() {
+    static Counter* const errors =
+        metrics().counter("lygiagretus_stage_errors_total", "");
+    return errors;
+}
+
+TraceScope::TraceScope(std::string track, std::string name)
+    : track_(std::move(track)), name_(std::move(name)) {
+    if (metrics().tracing()) {
+        start_ns_ = MetricsRegistry::now_ns();
+    }
+}
+
+TraceScope::~TraceScope() {
+    if (start_ns_ < 0) {
+        return;
+    }
+    TraceSpan span;
+    span.name = name_;
+    span.category = "stage";
+    span.track = track_;
+    span.start_ns = start_ns_;
+    span.end_ns = MetricsRegistry::now_ns();
+    metrics().span(std::move(span));
+}
@@ -0,0 +1,223 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_METRICS_H_
+#define CPP_APP_SRC_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Monotonically increasing value, e.g. device time of a command type.
+ */
+struct Counter {
+    std::atomic<int64_t> value{0};
+
+    void add(int64_t delta) {
+        value.fetch_add(delta, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Current level and its high-water mark since the job started, e.g.
+ * batches in flight. Every change is also a sample on the trace timeline
+ * while tracing.
+ */
+struct Gauge {
+    std::string series;          // Prometheus series, also the trace name
+    std::atomic<int64_t> value{0};
+    std::atomic<int64_t> max{0};
+
+    void set(int64_t level);
+    void add(int64_t delta);
+
+ private:
+    void record(int64_t level);
+};
+
+/**
+ * Message and byte counters of one socket.
+ */
+struct SocketMetrics {
+    std::atomic<int64_t> messages_sent{0};
+    std::atomic<int64_t> bytes_sent{0};
+    std::atomic<int64_t> messages_received{0};
+    std::atomic<int64_t> bytes_received{0};
+
+    void sent(size_t bytes) {
+        messages_sent.fetch_add(1, std::memory_order_relaxed);
+        bytes_sent.fetch_add(static_cast<int64_t>(bytes),
+                             std::memory_order_relaxed);
+    }
+    void received(size_t bytes) {
+        messages_received.fetch_add(1, std::memory_order_relaxed);
+        bytes_received.fetch_add(static_cast<int64_t>(bytes),
+                                 std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Contended acquisitions of a kind of lock and the time spent waiting.
+ */
+struct LockMetrics {
+    std::atomic<int64_t> contended{0};
+    std::atomic<int64_t> wait_ns{0};
+};
+
+/**
+ * One timed command or stage on the trace timeline (host clock).
+ */
+struct TraceSpan {
+    std::string name;
+    std::string category;
+    std::string track;       // Timeline row: a thread or a device queue
+    int64_t start_ns = 0;
+    int64_t end_ns = 0;
+    int64_t queued_ns = -1;  // OpenCL commands: enqueued and submitted
+    int64_t submit_ns = -1;
+    int64_t records = -1;
+};
+
+/**
+ * Process-wide hot-path instrumentation.
+ * Counters, gauges, socket and lock metrics are always collected (relaxed
+ * atomics) and exported in the Prometheus text format; the daemon serves
+ * them on Config::METRICS_ADDR. Spans and gauge samples are only recorded
+ * while tracing (--trace FILE) and written as a Chrome trace / Perfetto
+ * JSON timeline at the end of each job.
+ *
+ * Series are created on first use and live as long as the process, so the
+ * returned pointers may be kept. Thread-safe.
+ */
+class MetricsRegistry {
+ public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * Monotonic host time of every span and sample.
+     */
+    static int64_t now_ns();
+
+    /**
+     * @param name Prometheus metric name
+     * @param labels Label list without braces, e.g. device="gfx1030"
+     */
+    Counter* counter(const std::string& name, const std::string& labels);
+    Gauge* gauge(const std::string& name, const std::string& labels);
+    SocketMetrics* socket(const std::string& name);
+    LockMetrics* lock(const std::string& name);
+
+    void set_tracing(bool enabled);
+    bool tracing() const { return tracing_.load(std::memory_order_relaxed); }
+
+    /**
+     * Add a span to the timeline (ignored unless tracing). At most
+     * Config::TRACE_MAX_EVENTS are kept per job; the rest are counted.
+     */
+    void span(TraceSpan span);
+    void sample(const std::string& series, int64_t value);
+
+    /**
+     * Write the recorded timeline as Chrome trace JSON and start a new
+     * one.
+     * @return false if the file cannot be written
+     */
+    bool write_trace(const std::string& path);
+
+    /**
+     * Every series in the Prometheus text exposition format.
+     */
+    std::string prometheus() const;
+
+    /**
+     * Mark the start of a job for the rates logged by end_job().
+     */
+    void begin_job();
+
+    /**
+     * Log messages and bytes per second of every socket used by the job,
+     * the lock wait time and the in-flight high-water marks.
+     */
+    void end_job();
+
+ private:
+    struct Sample {
+        std::string series;
+        int64_t ts_ns;
+        int64_t value;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Counter>> counters_;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges_;
+    std::map<std::string, std::unique_ptr<SocketMetrics>> sockets_;
+    std::map<std::string, std::unique_ptr<LockMetrics>> locks_;
+
+    // Values at begin_job(), guarded by mutex_
+    int64_t job_start_ns_ = 0;
+    std::map<std::string, std::array<int64_t, 4>> job_base_;
+    int64_t job_lock_wait_ns_ = 0;
+
+    std::atomic<bool> tracing_{false};
+    std::mutex trace_mutex_;
+    int64_t trace_start_ns_ = 0;
+    std::vector<TraceSpan> spans_;
+    std::vector<Sample> samples_;
+    int64_t dropped_ = 0;
+};
+
+/**
+ * The process's registry.
+ */
+MetricsRegistry& metrics();
+
+/**
+ * Failures caught by the filter stages (lygiagretus_stage_errors_total):
+ * a job during which it moved may have left records unevaluated.
+ */
+Counter* stage_errors();
+
+/**
+ * Span from construction to destruction of a stage running on the
+ * calling thread (tracing only).
+ */
+class TraceScope {
+ public:
+    TraceScope(std::string track, std::string name);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+    std::string track_;
+    std::string name_;
+    int64_t start_ns_ = -1;
+};
+
+/**
+ * Lock a mutex, adding the time spent waiting to lock when it was held
+ * by another thread.
+ */
+template <typename Mutex>
+std::unique_lock<Mutex> timed_lock(Mutex& mutex, LockMetrics* lock) {
+    std::unique_lock held(mutex, std::try_to_lock);
+    if (!held.owns_lock()) {
+        const int64_t start = MetricsRegistry::now_ns();
+        held.lock();
+        lock->contended.fetch_add(1, std::memory_order_relaxed);
+        lock->wait_ns.fetch_add(MetricsRegistry::now_ns() - start,
+                                std::memory_order_relaxed);
+    }
+    return held;
+}
+
+#endif  // CPP_APP_SRC_METRICS_H_
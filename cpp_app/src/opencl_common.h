@@ -0,0 +1,12 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_OPENCL_COMMON_H_
+#define CPP_APP_SRC_OPENCL_COMMON_H_
+
+// Single place for the OpenCL C++ bindings configuration so every
+// translation unit sees the same target version.
+#define CL_HPP_TARGET_OPENCL_VERSION 300
+#define CL_HPP_MINIMUM_OPENCL_VERSION 120
+#include <CL/opencl.hpp>
+
+#endif  // CPP_APP_SRC_OPENCL_COMMON_H_
@@ -2,19 +2,33 @@
 
 #include "src/opencl_processor.h"
 
-#define CL_HPP_TARGET_OPENCL_VERSION 300
-#define CL_HPP_MINIMUM_OPENCL_VERSION 120
-#include <CL/opencl.hpp>
-
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
-#include <fstream>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <iostream>
-#include <map>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "src/config.h"
+#include "src/core_scheduler.h"
+#include "src/cpu_reliability.h"
+#include "src/launch_tuner.h"
+#include "src/metrics.h"
+#include "src/opencl_common.h"
+#include "src/opencl_session.h"
+#include "src/server_table.h"
+#include "src/stability_engine.h"
 #include "src/utils.h"
+#include "src/work_scheduler.h"
 
 namespace {
 
@@ -53,125 +67,1141 @@ cl::Device select_device() {
     throw std::runtime_error("No OpenCL device found");
 }
 
-std::string load_kernel_source() {
-    std::ifstream kernel_file("src/kernels.cl");
-    if (!kernel_file) {
-        throw std::runtime_error("Cannot open kernels.cl");
+/**
+ * Every GPU and CPU device on every platform, GPUs first.
+ */
+std::vector<cl::Device> select_devices() {
+    std::vector<cl::Platform> platforms;
+    cl::Platform::get(&platforms);
+
+    std::vector<cl::Device> all;
+    for (cl_device_type type : {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_CPU}) {
+        for (const auto& platform : platforms) {
+            std::vector<cl::Device> devices;
+            platform.getDevices(type, &devices);
+            for (const auto& device : devices) {
+                std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+                          << platform.getInfo<CL_PLATFORM_NAME>() << " - "
+                          << device.getInfo<CL_DEVICE_NAME>()
+                          << ((type == CL_DEVICE_TYPE_GPU) ? " (GPU)\n"
+                                                           : " (CPU)\n");
+                all.push_back(device);
+            }
+        }
+    }
+
+    if (all.empty()) {
+        throw std::runtime_error("No OpenCL device found");
     }
-    return std::string(
-        std::istreambuf_iterator<char>(kernel_file),
-        std::istreambuf_iterator<char>());
+    return all;
 }
 
-}  // namespace
+/**
+ * Slot indices handed over from OpenCL completion callbacks.
+ */
+struct CompletionQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::pair<size_t, cl_int>> done;  // (slot index, status)
+};
 
-void opencl_thread(
-    const std::vector<ServerData>& servers,
-    std::map<int, ServerResult>* results,
-    std::mutex* mutex) {
-    try {
-        cl::Device device = select_device();
-
-        cl::Context context(device);
-
-        // Enable profiling + out-of-order execution
-        cl_command_queue_properties props =
-            CL_QUEUE_PROFILING_ENABLE | CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
-        cl::CommandQueue queue(context, device, props);
-
-        std::string kernel_source = load_kernel_source();
-        cl::Program program(context, kernel_source);
-
-        try {
-            program.build({device},
-                          "-cl-fast-relaxed-math -cl-mad-enable "
-                          "-cl-no-signed-zeros");
-        } catch (...) {
-            std::cerr << "[OpenCL] Build error:\n"
-                      << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device)
-                      << "\n";
+/**
+ * One in-flight batch of records. Device and pinned staging blocks come
+ * from the device's pool and go back to it once the batch is published.
+ */
+struct Batch {
+    int count = 0;
+    int first_row = 0;
+    BufferPool* pool = nullptr;
+
+    // Inputs: table column slices used in place, or rows gathered into
+    // pinned staging and copied to pooled device blocks
+    cl::Buffer d_uptimes;
+    cl::Buffer d_loads;
+    cl::Buffer d_ids;
+    BufferPool::Block in_staging;
+    std::array<BufferPool::Block, 3> in_device;
+
+    // Outputs: scores, ids, stability (compute_both), result counters
+    std::array<BufferPool::Block, 3> out_device;
+    BufferPool::Block counter;
+    BufferPool::Block single_counts;    // compute_both only
+    BufferPool::Block out_staging;
+
+    // Views into out_staging, valid once the batch has completed
+    const int* counts = nullptr;        // result count, single counts
+    const float* scores = nullptr;      // Scores of the kernel's filter
+    const int* out_ids = nullptr;
+    const float* stability = nullptr;   // compute_both only
+    cl::Event done;
+
+    // Commands of the batch, for DeviceProfile and the metrics; the host
+    // time of the kernel's enqueue maps device timestamps to host time
+    std::vector<cl::Event> uploads;
+    cl::Event kernel_done;
+    std::vector<cl::Event> reads;
+    int64_t kernel_host_ns = 0;
+
+    // Completion callback context
+    CompletionQueue* completions = nullptr;
+    size_t slot = 0;
+};
+
+/**
+ * Return every pooled block of a finished batch and reset it.
+ */
+void release_batch(Batch* batch) {
+    if (batch->pool != nullptr) {
+        batch->pool->release(&batch->in_staging);
+        for (auto& block : batch->in_device) {
+            batch->pool->release(&block);
+        }
+        for (auto& block : batch->out_device) {
+            batch->pool->release(&block);
+        }
+        batch->pool->release(&batch->counter);
+        batch->pool->release(&batch->single_counts);
+        batch->pool->release(&batch->out_staging);
+    }
+    *batch = Batch{};
+}
+
+size_t align_up(size_t bytes) {
+    constexpr size_t ALIGN = 64;
+    return (bytes + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+void CL_CALLBACK on_batch_complete(cl_event /*event*/, cl_int status,
+                                   void* user_data) {
+    auto* batch = static_cast<Batch*>(user_data);
+    CompletionQueue* completions = batch->completions;
+    {
+        std::scoped_lock lock(completions->mutex);
+        completions->done.emplace_back(batch->slot, status);
+    }
+    completions->cv.notify_one();
+}
+
+/**
+ * Supplies batches of record indices to one device.
+ */
+class BatchSource {
+ public:
+    virtual ~BatchSource() = default;
+
+    /**
+     * Get the next batch of record indices.
+     * @param idle true when nothing is in flight on the device; the call
+     *             may then block until work is available
+     * @return false when no batch is ready (or the source is exhausted)
+     */
+    virtual bool next(bool idle, std::vector<int>* rows) = 0;
+
+    virtual bool exhausted() const = 0;
+
+    /**
+     * Called once per completed batch.
+     * @param first_row First record of the batch (scheduler batches are
+     *                  contiguous)
+     * @param rows Record count of the batch
+     * @param ok false when the batch failed on the device
+     */
+    virtual void on_complete(int /*first_row*/, size_t /*rows*/,
+                             bool /*ok*/) {}
+};
+
+/**
+ * Collects rows that an upstream stage pushes into a channel: row ranges
+ * published by the loader, or ids forwarded by a chained filter. Adjacent
+ * rows are merged so loader chunks upload as contiguous column slices.
+ */
+template <typename T>
+class StreamSource : public BatchSource {
+ public:
+    StreamSource(const ServerTable& table, int batch_size, Channel<T>* input)
+        : table_(table), input_(input) {
+        max_rows_ = (batch_size > 0) ? batch_size
+                                     : std::numeric_limits<int>::max();
+    }
+
+    // An idle device dispatches whatever is pending instead of waiting
+    // for a full batch.
+    bool next(bool idle, std::vector<int>* rows) override {
+        // Drain what upstream has produced so far
+        bool closed = false;
+        T item;
+        while (pending_rows_ < max_rows_) {
+            auto status = input_->try_pop(&item);
+            if (status == Channel<T>::PopResult::kClosed) {
+                closed = true;
+                break;
+            }
+            if (status == Channel<T>::PopResult::kEmpty) {
+                if (!idle || pending_rows_ > 0) {
+                    break;
+                }
+                // Nothing in flight and nothing pending: wait upstream
+                if (!input_->pop(&item)) {
+                    closed = true;
+                    break;
+                }
+            }
+            append(item);
+        }
+
+        const bool full = pending_rows_ >= max_rows_;
+        if (pending_rows_ == 0 || !(full || closed || idle)) {
+            exhausted_ = closed && pending_rows_ == 0;
+            return false;
+        }
+
+        rows->clear();
+        while (!pending_.empty() &&
+               static_cast<int>(rows->size()) < max_rows_) {
+            RowRange& range = pending_.front();
+            const int take = std::min(
+                range.end - range.begin,
+                max_rows_ - static_cast<int>(rows->size()));
+            for (int i = 0; i < take; i++) {
+                rows->push_back(range.begin + i);
+            }
+            range.begin += take;
+            pending_rows_ -= take;
+            if (range.begin == range.end) {
+                pending_.pop_front();
+            }
+        }
+        return true;
+    }
+
+    bool exhausted() const override { return exhausted_; }
+
+ private:
+    void append(const RowRange& range) {
+        if (range.end <= range.begin) {
             return;
         }
+        if (!pending_.empty() && pending_.back().end == range.begin) {
+            pending_.back().end = range.end;
+        } else {
+            pending_.push_back(range);
+        }
+        pending_rows_ += range.end - range.begin;
+    }
+
+    void append(const IdBatch& ids) {
+        for (int id : ids) {
+            const int32_t row = table_.row_of(id);
+            if (row != IdIndex::NO_ROW) {
+                append(RowRange{row, row + 1});
+            }
+        }
+    }
 
-        const int count = static_cast<int>(servers.size());
+    const ServerTable& table_;
+    Channel<T>* input_;
+    int max_rows_ = 0;
+    bool exhausted_ = false;
+    std::deque<RowRange> pending_;
+    int pending_rows_ = 0;
+};
 
-        std::vector<int> h_uptimes(count), h_ids(count);
-        std::vector<float> h_loads(count);
+/**
+ * One device's view of the shared work-stealing scheduler. The first
+ * completed batch is the calibration chunk and sets the device's share.
+ * A failed batch's range goes back to the scheduler and the device takes
+ * no more work; the thread retires it once its window has drained.
+ */
+class SchedulerSource : public BatchSource {
+ public:
+    SchedulerSource(WorkScheduler* scheduler, int worker)
+        : scheduler_(scheduler), worker_(worker) {}
 
+    bool next(bool idle, std::vector<int>* rows) override {
+        int begin = 0;
+        int end = 0;
+        if (failed_) {
+            exhausted_ = true;
+            return false;
+        }
+        if (idle) {
+            if (!scheduler_->next(worker_, &begin, &end)) {
+                exhausted_ = true;
+                return false;
+            }
+        } else {
+            auto status = scheduler_->try_next(worker_, &begin, &end);
+            if (status != WorkScheduler::Status::kRange) {
+                exhausted_ = (status == WorkScheduler::Status::kDone);
+                return false;
+            }
+        }
+
+        if (!calibration_started_) {
+            calibration_started_ = true;
+            calibration_start_ = std::chrono::high_resolution_clock::now();
+        }
+
+        rows->resize(end - begin);
+        for (int i = begin; i < end; i++) {
+            (*rows)[i - begin] = i;
+        }
+        return true;
+    }
+
+    bool exhausted() const override { return exhausted_; }
+
+    void on_complete(int first_row, size_t rows, bool ok) override {
+        const int end = first_row + static_cast<int>(rows);
+        if (!ok) {
+            scheduler_->requeue(worker_, first_row, end);
+            failed_ = true;
+            return;
+        }
+        scheduler_->complete(worker_, first_row, end);
+        if (calibrated_) {
+            return;
+        }
+        calibrated_ = true;
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::high_resolution_clock::now() -
+            calibration_start_).count();
+        scheduler_->report(worker_, static_cast<double>(rows) /
+                                        std::max(seconds, 1e-6));
+    }
+
+ private:
+    WorkScheduler* scheduler_;
+    int worker_;
+    bool exhausted_ = false;
+    bool failed_ = false;
+    bool calibration_started_ = false;
+    bool calibrated_ = false;
+    std::chrono::high_resolution_clock::time_point calibration_start_;
+};
+
+bool is_contiguous(const std::vector<int>& rows) {
+    for (size_t i = 1; i < rows.size(); i++) {
+        if (rows[i] != rows[i - 1] + 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Enqueue upload, kernel and read-back for one batch without blocking.
+ * A contiguous row range is used in place (CL_MEM_USE_HOST_PTR, zero-copy
+ * on devices sharing host memory; the table columns stay valid and
+ * unchanged for the whole run), scattered rows (chained input) are
+ * gathered into pinned staging and copied to pooled device blocks.
+ * Results are read back into pinned staging. Commands are chained on
+ * events so batches overlap on the out-of-order queue.
+ * @return CL_SUCCESS, or the error of the first call that failed (the
+ *         commands enqueued before it may still be running)
+ */
+cl_int enqueue_batch(
+    DeviceEngine* engine,
+    const ServerTable& table,
+    const std::vector<int>& rows,
+    Batch* batch) {
+    const cl::Context& context = engine->context;
+    const cl::CommandQueue& queue = engine->queue;
+    BufferPool* pool = engine->pool;
+    cl::Kernel* kernel = &engine->kernel;
+    const int count = static_cast<int>(rows.size());
+    const size_t column = sizeof(int) * count;  // int and float columns
+    static_assert(sizeof(int) == sizeof(float));
+    batch->count = count;
+    batch->first_row = rows[0];
+    batch->pool = pool;
+
+    // Everything the kernel waits for
+    std::vector<cl::Event> ready;
+    cl_int err = CL_SUCCESS;
+
+    if (is_contiguous(rows)) {
+        // The kernel only reads the inputs, so mapped read-only pages are
+        // fine
+        const cl_mem_flags flags = CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR;
+        batch->d_uptimes = cl::Buffer(
+            context, flags, column,
+            const_cast<int*>(table.uptimes().data() + rows[0]), &err);
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+        batch->d_loads = cl::Buffer(
+            context, flags, column,
+            const_cast<float*>(table.loads().data() + rows[0]), &err);
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+        batch->d_ids = cl::Buffer(
+            context, flags, column,
+            const_cast<int*>(table.ids().data() + rows[0]), &err);
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+    } else {
+        const size_t stride = align_up(column);
+        batch->in_staging = pool->pinned(3 * stride);
+        char* staging = static_cast<char*>(batch->in_staging.host);
+        auto* uptimes = reinterpret_cast<int*>(staging);
+        auto* loads = reinterpret_cast<float*>(staging + stride);
+        auto* ids = reinterpret_cast<int*>(staging + 2 * stride);
         for (int i = 0; i < count; i++) {
-            h_uptimes[i] = servers[i].uptime;
-            h_loads[i] = servers[i].load;
-            h_ids[i] = servers[i].id;
-        }
-
-        cl::Buffer d_uptimes(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                             sizeof(int) * count, h_uptimes.data());
-        cl::Buffer d_loads(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                           sizeof(float) * count, h_loads.data());
-        cl::Buffer d_ids(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                         sizeof(int) * count, h_ids.data());
-        cl::Buffer d_reliability(context, CL_MEM_WRITE_ONLY,
-                                 sizeof(float) * count);
-        cl::Buffer d_out_ids(context, CL_MEM_WRITE_ONLY,
-                             sizeof(int) * count);
-        cl::Buffer d_counter(context, CL_MEM_READ_WRITE, sizeof(int));
-
-        int zero = 0;
-        queue.enqueueWriteBuffer(d_counter, CL_TRUE, 0, sizeof(int), &zero);
-
-        cl::Kernel kernel(program, "compute_reliability");
-        kernel.setArg(0, d_uptimes);
-        kernel.setArg(1, d_loads);
-        kernel.setArg(2, d_ids);
-        kernel.setArg(3, d_reliability);
-        kernel.setArg(4, d_out_ids);
-        kernel.setArg(Constants::KERNEL_ARG_COUNTER, d_counter);
-        kernel.setArg(Constants::KERNEL_ARG_COUNT, count);
-
-        // --- Launch configuration ---
-        size_t local_size = 256;
-        size_t global_size = ((count + local_size - 1) / local_size) *
-                             local_size;
-
-        auto start = std::chrono::high_resolution_clock::now();
-        queue.enqueueNDRangeKernel(kernel, cl::NullRange,
-                                   cl::NDRange(global_size),
-                                   cl::NDRange(local_size));
-        queue.finish();
-        auto end = std::chrono::high_resolution_clock::now();
-
-        auto duration_ms =
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                end - start).count();
-
-        int result_count = 0;
-        queue.enqueueReadBuffer(d_counter, CL_TRUE, 0, sizeof(int),
-                                &result_count);
-
-        if (result_count > 0) {
-            std::vector<float> h_reliability(result_count);
-            std::vector<int> h_out_ids(result_count);
-
-            queue.enqueueReadBuffer(d_reliability, CL_TRUE, 0,
-                                    sizeof(float) * result_count,
-                                    h_reliability.data());
-            queue.enqueueReadBuffer(d_out_ids, CL_TRUE, 0,
-                                    sizeof(int) * result_count,
-                                    h_out_ids.data());
-
-            std::scoped_lock lock(*mutex);
-            for (int i = 0; i < result_count; i++) {
-                auto it = results->find(h_out_ids[i]);
-                if (it != results->end()) {
-                    it->second.reliability = h_reliability[i];
-                    it->second.has_opencl_result = true;
+            uptimes[i] = table.uptimes()[rows[i]];
+            loads[i] = table.loads()[rows[i]];
+            ids[i] = table.ids()[rows[i]];
+        }
+
+        for (size_t c = 0; c < batch->in_device.size(); c++) {
+            batch->in_device[c] = pool->device(column);
+            ready.emplace_back();
+            err = queue.enqueueWriteBuffer(
+                batch->in_device[c].buffer, CL_FALSE, 0, column,
+                staging + c * stride, nullptr, &ready.back());
+            if (err != CL_SUCCESS) {
+                return err;
+            }
+            batch->uploads.push_back(ready.back());
+        }
+        batch->d_uptimes = batch->in_device[0].buffer;
+        batch->d_loads = batch->in_device[1].buffer;
+        batch->d_ids = batch->in_device[2].buffer;
+    }
+
+    const bool fused = (engine->filter == DeviceFilter::kBoth);
+    const size_t outputs = fused ? 3 : 2;
+    for (size_t c = 0; c < outputs; c++) {
+        batch->out_device[c] = pool->device(column);
+    }
+    batch->counter = pool->device(sizeof(int));
+    ready.emplace_back();
+    err = queue.enqueueFillBuffer(batch->counter.buffer, 0, 0, sizeof(int),
+                                  nullptr, &ready.back());
+    if (err != CL_SUCCESS) {
+        return err;
+    }
+
+    const std::array<cl_int, 7> args = {
+        kernel->setArg(0, batch->d_uptimes),
+        kernel->setArg(1, batch->d_loads),
+        kernel->setArg(2, batch->d_ids),
+        kernel->setArg(3, batch->out_device[0].buffer),
+        kernel->setArg(4, batch->out_device[1].buffer),
+        kernel->setArg(Constants::KERNEL_ARG_COUNTER, batch->counter.buffer),
+        kernel->setArg(Constants::KERNEL_ARG_COUNT, count)
+    };
+    for (cl_int arg : args) {
+        if (arg != CL_SUCCESS) {
+            return arg;
+        }
+    }
+    if (fused) {
+        batch->single_counts = pool->device(2 * sizeof(int));
+        ready.emplace_back();
+        err = queue.enqueueFillBuffer(batch->single_counts.buffer, 0, 0,
+                                      2 * sizeof(int), nullptr,
+                                      &ready.back());
+        if (err == CL_SUCCESS) {
+            err = kernel->setArg(Constants::KERNEL_ARG_OUT_STABILITY,
+                                 batch->out_device[2].buffer);
+        }
+        if (err == CL_SUCCESS) {
+            err = kernel->setArg(Constants::KERNEL_ARG_SINGLE_COUNTS,
+                                 batch->single_counts.buffer);
+        }
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+    }
+
+    // --- Launch configuration (tuned per device) ---
+    const size_t local_size = engine->launch.local_size;
+    const size_t global_size = launch_global_size(engine->launch, count);
+
+    std::vector<cl::Event> kernel_done(1);
+    batch->kernel_host_ns = MetricsRegistry::now_ns();
+    err = queue.enqueueNDRangeKernel(*kernel, cl::NullRange,
+                                     cl::NDRange(global_size),
+                                     cl::NDRange(local_size),
+                                     &ready, &kernel_done[0]);
+    if (err != CL_SUCCESS) {
+        return err;
+    }
+    batch->kernel_done = kernel_done[0];
+
+    // Staging layout: counters, then one aligned slice per output column
+    const size_t stride = align_up(column);
+    const size_t counters = align_up(3 * sizeof(int));
+    batch->out_staging = pool->pinned(counters + outputs * stride);
+    char* staging = static_cast<char*>(batch->out_staging.host);
+    batch->counts = reinterpret_cast<const int*>(staging);
+    batch->scores = reinterpret_cast<const float*>(staging + counters);
+    batch->out_ids = reinterpret_cast<const int*>(staging + counters +
+                                                  stride);
+    batch->stability = fused ? reinterpret_cast<const float*>(
+                                   staging + counters + 2 * stride)
+                             : nullptr;
+
+    // Read the whole output slice so no host round-trip on the counter
+    // is needed; only the first result_count entries are valid.
+    std::vector<cl::Event> reads(outputs + 1);
+    err = queue.enqueueReadBuffer(batch->counter.buffer, CL_FALSE, 0,
+                                  sizeof(int), staging, &kernel_done,
+                                  &reads[0]);
+    for (size_t c = 0; c < outputs && err == CL_SUCCESS; c++) {
+        err = queue.enqueueReadBuffer(batch->out_device[c].buffer, CL_FALSE,
+                                      0, column,
+                                      staging + counters + c * stride,
+                                      &kernel_done, &reads[c + 1]);
+    }
+    if (fused && err == CL_SUCCESS) {
+        reads.emplace_back();
+        err = queue.enqueueReadBuffer(batch->single_counts.buffer, CL_FALSE,
+                                      0, 2 * sizeof(int),
+                                      staging + sizeof(int), &kernel_done,
+                                      &reads.back());
+    }
+    if (err != CL_SUCCESS) {
+        return err;
+    }
+
+    batch->reads = reads;
+    err = queue.enqueueMarkerWithWaitList(&reads, &batch->done);
+    if (err != CL_SUCCESS) {
+        return err;
+    }
+    return batch->done.setCallback(CL_COMPLETE, on_batch_complete, batch);
+}
+
+/**
+ * Enqueue a batch; one that cannot be enqueued completes right away with
+ * the error, once whatever it did enqueue has drained, so run_window
+ * takes it down the failed-batch path instead of waiting for a callback
+ * that never comes.
+ */
+void submit_batch(
+    DeviceEngine* engine,
+    const ServerTable& table,
+    const std::vector<int>& rows,
+    Batch* batch) {
+    const cl_int err = enqueue_batch(engine, table, rows, batch);
+    if (err == CL_SUCCESS) {
+        return;
+    }
+    // The blocks go back to the pool only when nothing uses them
+    engine->queue.finish();
+    CompletionQueue* completions = batch->completions;
+    {
+        std::scoped_lock lock(completions->mutex);
+        completions->done.emplace_back(batch->slot, err);
+    }
+    completions->cv.notify_one();
+}
+
+/**
+ * Merge one completed batch into the table and forward the ids that
+ * passed to the next pipeline stage.
+ * @return Number of records that passed the kernel's filter(s)
+ */
+int publish_batch(
+    const Batch& batch,
+    DeviceFilter filter,
+    ServerTable* table,
+    Channel<IdBatch>* passed) {
+    if (filter == DeviceFilter::kBoth) {
+        table->count_single_passes(batch.counts[1], batch.counts[2]);
+    }
+    const int result_count = batch.counts[0];
+    if (result_count <= 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < result_count; i++) {
+        const int32_t row = table->row_of(batch.out_ids[i]);
+        if (row == IdIndex::NO_ROW) {
+            continue;
+        }
+        if (filter == DeviceFilter::kStability) {
+            table->set_stability(row, batch.scores[i]);
+        } else {
+            table->set_reliability(row, batch.scores[i]);
+        }
+        if (filter == DeviceFilter::kBoth) {
+            table->set_stability(row, batch.stability[i]);
+        }
+    }
+
+    if (passed != nullptr) {
+        passed->push(IdBatch(batch.out_ids, batch.out_ids + result_count));
+    }
+    return result_count;
+}
+
+/**
+ * Profiling timestamps of one command (device clock, ns).
+ */
+struct CommandTimes {
+    int64_t queued;
+    int64_t submit;
+    int64_t start;
+    int64_t end;
+};
+
+CommandTimes command_times(const cl::Event& event) {
+    return CommandTimes{
+        .queued = static_cast<int64_t>(
+            event.getProfilingInfo<CL_PROFILING_COMMAND_QUEUED>()),
+        .submit = static_cast<int64_t>(
+            event.getProfilingInfo<CL_PROFILING_COMMAND_SUBMIT>()),
+        .start = static_cast<int64_t>(
+            event.getProfilingInfo<CL_PROFILING_COMMAND_START>()),
+        .end = static_cast<int64_t>(
+            event.getProfilingInfo<CL_PROFILING_COMMAND_END>())
+    };
+}
+
+/**
+ * Metrics series of one device and kernel, looked up once per run.
+ */
+struct DeviceMetrics {
+    std::string track;       // Trace row of the device's queue
+    Counter* upload_ns;
+    Counter* kernel_ns;
+    Counter* transfer_ns;
+    Counter* batches;
+    Gauge* in_flight;
+};
+
+DeviceMetrics device_metrics(const DeviceEngine& engine) {
+    const std::string device = "device=\"" + engine.name + "\"";
+    const std::string labels =
+        device + ",kernel=\"" + kernel_name(engine.filter) + "\"";
+    const std::string commands =
+        "lygiagretus_opencl_command_nanoseconds_total";
+    MetricsRegistry& registry = metrics();
+    return DeviceMetrics{
+        .track = engine.name + " " + kernel_name(engine.filter),
+        .upload_ns =
+            registry.counter(commands, labels + ",command=\"write\""),
+        .kernel_ns =
+            registry.counter(commands, labels + ",command=\"kernel\""),
+        .transfer_ns =
+            registry.counter(commands, labels + ",command=\"read\""),
+        .batches =
+            registry.counter("lygiagretus_opencl_batches_total", labels),
+        .in_flight =
+            registry.gauge("lygiagretus_opencl_batches_in_flight", labels)
+    };
+}
+
+/**
+ * Account the commands of a completed batch: device time totals, the
+ * stage's profile and, while tracing, one span per command on the host
+ * timeline.
+ */
+void account_batch(const Batch& batch, const DeviceMetrics& device,
+                   DeviceProfile* profile) {
+    const CommandTimes kernel = command_times(batch.kernel_done);
+    const int64_t offset = batch.kernel_host_ns - kernel.queued;
+    const bool tracing = metrics().tracing();
+
+    auto account = [&](const CommandTimes& times, const char* name,
+                       Counter* total) {
+        total->add(times.end - times.start);
+        if (tracing) {
+            TraceSpan span;
+            span.name = name;
+            span.category = "opencl";
+            span.track = device.track;
+            span.start_ns = times.start + offset;
+            span.end_ns = times.end + offset;
+            span.queued_ns = times.queued + offset;
+            span.submit_ns = times.submit + offset;
+            span.records = batch.count;
+            metrics().span(std::move(span));
+        }
+        return times.end - times.start;
+    };
+
+    int64_t upload = 0;
+    for (const cl::Event& event : batch.uploads) {
+        upload += account(command_times(event), "write", device.upload_ns);
+    }
+    const int64_t kernel_ns = account(kernel, "kernel", device.kernel_ns);
+    int64_t transfer = 0;
+    for (const cl::Event& event : batch.reads) {
+        transfer += account(command_times(event), "read",
+                            device.transfer_ns);
+    }
+    device.batches->add(1);
+
+    if (profile != nullptr) {
+        profile->upload_ns += upload;
+        profile->kernel_ns += kernel_ns;
+        profile->transfer_ns += transfer;
+        profile->records += batch.count;
+    }
+}
+
+/**
+ * Per-device counters for the final log line.
+ */
+struct RunStats {
+    int processed = 0;
+    int passed = 0;
+    int batches = 0;
+    int64_t first_ms = -1;
+    int64_t total_ms = 0;
+};
+
+/**
+ * Keep a bounded number of batches in flight on one device, refill the
+ * window from the source and publish each batch as soon as it completes.
+ */
+RunStats run_window(
+    DeviceEngine* engine,
+    ServerTable* table,
+    BatchSource* source,
+    bool poll_source,
+    Channel<IdBatch>* passed,
+    DeviceProfile* profile) {
+    CompletionQueue completions;
+    std::vector<Batch> slots(Config::OPENCL_MAX_IN_FLIGHT);
+    std::vector<size_t> free_slots;
+    for (size_t i = 0; i < slots.size(); i++) {
+        free_slots.push_back(i);
+    }
+
+    RunStats stats;
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t in_flight = 0;
+    const DeviceMetrics device = device_metrics(*engine);
+
+    std::vector<int> rows;
+    while (true) {
+        while (!free_slots.empty() && source->next(in_flight == 0, &rows)) {
+            const size_t slot = free_slots.back();
+            free_slots.pop_back();
+            slots[slot].completions = &completions;
+            slots[slot].slot = slot;
+            submit_batch(engine, *table, rows, &slots[slot]);
+            stats.batches++;
+            in_flight++;
+            device.in_flight->add(1);
+        }
+        engine->queue.flush();
+
+        if (in_flight == 0) {
+            if (source->exhausted()) {
+                break;
+            }
+            continue;
+        }
+
+        std::pair<size_t, cl_int> done;
+        {
+            std::unique_lock lock(completions.mutex);
+            auto ready = [&] { return !completions.done.empty(); };
+            if (poll_source && !source->exhausted()) {
+                // Wake up periodically to pick up upstream ids
+                if (!completions.cv.wait_for(
+                        lock,
+                        std::chrono::milliseconds(Config::PIPELINE_POLL_MS),
+                        ready)) {
+                    continue;
                 }
+            } else {
+                completions.cv.wait(lock, ready);
+            }
+            done = completions.done.front();
+            completions.done.pop_front();
+        }
+        in_flight--;
+        device.in_flight->add(-1);
+
+        Batch& batch = slots[done.first];
+        const bool ok = (done.second == CL_COMPLETE);
+        if (!ok) {
+            stage_errors()->add(1);
+            std::cerr << Color::RED << "[OpenCL] Batch failed on "
+                      << engine->name << ": " << done.second
+                      << Color::RESET << "\n";
+        } else {
+            stats.processed += batch.count;
+            stats.passed += publish_batch(batch, engine->filter, table,
+                                          passed);
+            account_batch(batch, device, profile);
+        }
+        source->on_complete(batch.first_row, batch.count, ok);
+
+        if (stats.first_ms < 0) {
+            stats.first_ms =
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::high_resolution_clock::now() - start)
+                    .count();
+        }
+
+        // Hand the finished batch's blocks back to the pool
+        release_batch(&batch);
+        free_slots.push_back(done.first);
+    }
+
+    stats.total_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return stats;
+}
+
+/**
+ * Split the dataset across every usable device.
+ */
+void run_multi_device(
+    OpenCLSession* session,
+    ServerTable* table,
+    const OpenCLSettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* passed) {
+    std::vector<cl::Device> devices = select_devices();
+
+    // The split is sized by the final row count: wait for the loader
+    RowRange range{};
+    while (rows->pop(&range)) {
+    }
+
+    const int chunk = (settings.batch_size > 0) ? settings.batch_size
+                                                : Config::MULTI_DEVICE_CHUNK;
+    WorkScheduler scheduler(static_cast<int>(table->size()),
+                            static_cast<int>(devices.size()), chunk);
+
+    std::vector<RunStats> stats(devices.size());
+    std::vector<std::string> names(devices.size());
+    {
+        std::vector<std::jthread> workers;
+        for (size_t d = 0; d < devices.size(); d++) {
+            workers.emplace_back([&, d]() {
+                const int worker = static_cast<int>(d);
+                try {
+                    DeviceEngine engine = session->engine(devices[d], settings);
+                    names[d] = engine.name;
+                    SchedulerSource source(&scheduler, worker);
+                    stats[d] = run_window(&engine, table, &source, false,
+                                          passed, settings.profile);
+                } catch (const std::exception& e) {
+                    stage_errors()->add(1);
+                    std::cerr << Color::RED << "[OpenCL] Device " << d
+                              << ": " << e.what() << Color::RESET << "\n";
+                }
+                // The others steal a failed device's leftover work and take
+                // back the ranges it still held
+                scheduler.retire(worker);
+            });
+        }
+    }  // All device threads join here
+
+    const int lost = scheduler.unfinished();
+    if (lost > 0) {
+        stage_errors()->add(1);
+        std::cerr << Color::RED << "[OpenCL] No live device left, " << lost
+                  << " records got no " << kernel_name(settings.filter)
+                  << " result" << Color::RESET << "\n";
+    }
+
+    int processed = 0;
+    int passed_count = 0;
+    for (size_t d = 0; d < devices.size(); d++) {
+        std::cout << "[OpenCL] " << names[d] << ": " << stats[d].processed
+                  << " records, " << stats[d].batches << " batch(es), "
+                  << static_cast<int64_t>(scheduler.rate(static_cast<int>(d)))
+                  << " rec/s calibrated, " << stats[d].total_ms << " ms\n";
+        processed += stats[d].processed;
+        passed_count += stats[d].passed;
+    }
+    std::cout << "[OpenCL] " << kernel_name(settings.filter) << ": "
+              << passed_count << "/" << processed
+              << " passed on " << devices.size() << " device(s)\n";
+}
+
+template <typename T>
+void run_single_device(
+    OpenCLSession* session,
+    ServerTable* table,
+    const OpenCLSettings& settings,
+    Channel<T>* input,
+    Channel<IdBatch>* passed) {
+    cl::Device device = select_device();
+    DeviceProfile* profile = settings.profile;
+
+    // A CPU device shares its cores with the native Filter 2
+    if (settings.cores != nullptr &&
+        settings.filter == DeviceFilter::kReliability &&
+        (device.getInfo<CL_DEVICE_TYPE>() & CL_DEVICE_TYPE_CPU) != 0) {
+        const int units = settings.cores->device_units(static_cast<int>(
+            device.getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>()));
+        cl::Device partition;
+        if (units > 0 && session->partition(device, units, &partition)) {
+            device = partition;
+            settings.cores->set_device_partition(units);
+        } else if (units > 0) {
+            settings.cores->set_device_partition(0);
+        }
+        if (profile == nullptr) {
+            profile = settings.cores->device_profile();
+        }
+    }
+    DeviceEngine engine = session->engine(device, settings);
+
+    StreamSource<T> source(*table, settings.batch_size, input);
+    RunStats stats = run_window(&engine, table, &source, true, passed,
+                                profile);
+
+    std::cout << "[OpenCL] " << kernel_name(settings.filter) << ": "
+              << stats.passed << "/" << stats.processed
+              << " passed, " << stats.batches << " batch(es), first "
+              << stats.first_ms << " ms, total " << stats.total_ms
+              << " ms\n";
+}
+
+}  // namespace
+
+bool opencl_device_available() {
+    std::vector<cl::Platform> platforms;
+    if (cl::Platform::get(&platforms) != CL_SUCCESS) {
+        return false;
+    }
+    for (const auto& platform : platforms) {
+        for (cl_device_type type : {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_CPU}) {
+            std::vector<cl::Device> devices;
+            platform.getDevices(type, &devices);
+            if (!devices.empty()) {
+                return true;
             }
         }
+    }
+    return false;
+}
+
+void opencl_thread(
+    OpenCLSession* session,
+    ServerTable* table,
+    const OpenCLSettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed) {
+    if (settings.filter != DeviceFilter::kBoth && !opencl_device_available()) {
+        // Native engines take over the stage (and close passed)
+        std::cout << "[OpenCL] No device, " << kernel_name(settings.filter)
+                  << " runs on the CPU\n";
+        if (settings.filter == DeviceFilter::kStability) {
+            const StabilitySettings native{
+                .threads = settings.cpu_threads,
+                .throttle = (settings.cores != nullptr)
+                                ? settings.cores->throttle(CoreSide::kStability)
+                                : nullptr,
+                .params = settings.params
+            };
+            stability_thread(table, native, rows, input, passed);
+        } else {
+            const CpuReliabilitySettings native{
+                .threads = settings.cpu_threads,
+                .throttle = (settings.cores != nullptr)
+                                ? settings.cores->throttle(
+                                      CoreSide::kReliability)
+                                : nullptr,
+                .params = settings.params
+            };
+            cpu_reliability_thread(table, native, rows, input, passed);
+        }
+        return;
+    }
 
-        std::cout << "[OpenCL] " << result_count << "/" << count
-                  << " passed, " << duration_ms << " ms\n";
+    TraceScope scope("opencl", kernel_name(settings.filter));
+    try {
+        if (input != nullptr) {
+            if (settings.multi_device) {
+                std::cout << "[OpenCL] Chained input feeds a single device\n";
+            }
+            run_single_device(session, table, settings, input, passed);
+        } else if (settings.multi_device) {
+            run_multi_device(session, table, settings, rows, passed);
+        } else {
+            run_single_device(session, table, settings, rows, passed);
+        }
     } catch (const std::exception& e) {
+        stage_errors()->add(1);
         std::cerr << "[OpenCL] " << e.what() << "\n";
     }
+    if (settings.cores != nullptr &&
+        settings.filter == DeviceFilter::kReliability) {
+        settings.cores->device_done();
+    }
+
+    // Downstream stage must not wait forever, even after a failure
+    if (passed != nullptr) {
+        passed->close();
+    }
+}
+
+bool summarize_locations_on_device(
+    OpenCLSession* session,
+    const OpenCLSettings& settings,
+    const ServerTable& table,
+    const ResultSnapshot& results,
+    LocationAggregates* out) {
+    if (table.empty() || !opencl_device_available()) {
+        return false;
+    }
+    TraceScope scope("opencl", "summarize_locations");
+    try {
+        const cl::Device device = select_device();
+        const size_t locations = table.location_names().size();
+        const size_t local_bytes =
+            locations * (Constants::SUMMARY_FLOATS * sizeof(float) +
+                         Constants::SUMMARY_INTS * sizeof(int));
+        if (local_bytes > device.getInfo<CL_DEVICE_LOCAL_MEM_SIZE>()) {
+            std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+                      << locations << " locations exceed local memory\n";
+            return false;
+        }
+        DeviceEngine engine = session->summary_engine(device, settings);
+
+        const int count = static_cast<int>(table.size());
+        const size_t local_size = std::min(
+            engine.launch.local_size,
+            engine.kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(
+                device));
+        const size_t groups = std::clamp<size_t>(
+            (count + local_size - 1) / local_size, 1,
+            Config::SUMMARY_MAX_GROUPS);
+
+        // The kernel skips rows whose id was loaded again later
+        std::vector<uint8_t> flags = results.flags;
+        for (int32_t row : table.shadowed_rows()) {
+            flags[row] = Constants::SUMMARY_ROW_SHADOWED;
+        }
+
+        // Inputs are only read: use the columns in place
+        const cl_mem_flags in_place = CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR;
+        const cl::Context& context = engine.context;
+        // The bindings run without exceptions: every call's status is
+        // checked, the first failure sends the caller to the host pass
+        auto failed = [](const char* what, cl_int err) {
+            if (err == CL_SUCCESS) {
+                return false;
+            }
+            stage_errors()->add(1);
+            std::cerr << Color::RED << "[OpenCL] Location summary: " << what
+                      << " failed: " << err << Color::RESET << "\n";
+            return true;
+        };
+        std::array<cl_int, 4> created{};
+        cl::Buffer d_locations(
+            context, in_place, sizeof(uint32_t) * count,
+            const_cast<uint32_t*>(table.location_ids().data()), &created[0]);
+        cl::Buffer d_flags(context, in_place, count, flags.data(),
+                           &created[1]);
+        cl::Buffer d_reliability(
+            context, in_place, sizeof(float) * count,
+            const_cast<float*>(results.reliability.data()), &created[2]);
+        cl::Buffer d_stability(
+            context, in_place, sizeof(float) * count,
+            const_cast<float*>(results.stability.data()), &created[3]);
+        for (cl_int err : created) {
+            if (failed("clCreateBuffer", err)) {
+                return false;
+            }
+        }
+
+        const size_t partials = groups * locations;
+        const size_t sums_bytes =
+            partials * Constants::SUMMARY_FLOATS * sizeof(float);
+        const size_t ints_bytes =
+            partials * Constants::SUMMARY_INTS * sizeof(int);
+        BufferPool::Block d_sums = engine.pool->device(sums_bytes);
+        BufferPool::Block d_ints = engine.pool->device(ints_bytes);
+
+        cl::Kernel& kernel = engine.kernel;
+        const std::array<cl_int, 10> args = {
+            kernel.setArg(0, d_locations),
+            kernel.setArg(1, d_flags),
+            kernel.setArg(2, d_reliability),
+            kernel.setArg(3, d_stability),
+            kernel.setArg(4, count),
+            kernel.setArg(5, static_cast<int>(locations)),
+            kernel.setArg(6, d_sums.buffer),
+            kernel.setArg(7, d_ints.buffer),
+            kernel.setArg(8, cl::Local(locations *
+                                       Constants::SUMMARY_FLOATS *
+                                       sizeof(float))),
+            kernel.setArg(9, cl::Local(locations * Constants::SUMMARY_INTS *
+                                       sizeof(int)))
+        };
+        cl_int err = CL_SUCCESS;
+        for (cl_int arg : args) {
+            err = (err != CL_SUCCESS) ? err : arg;
+        }
+
+        std::vector<float> sums(partials * Constants::SUMMARY_FLOATS);
+        std::vector<int> ints(partials * Constants::SUMMARY_INTS);
+        const char* step = "clSetKernelArg";
+        if (err == CL_SUCCESS) {
+            std::vector<cl::Event> done(1);
+            step = "clEnqueueNDRangeKernel";
+            err = engine.queue.enqueueNDRangeKernel(
+                kernel, cl::NullRange, cl::NDRange(groups * local_size),
+                cl::NDRange(local_size), nullptr, &done[0]);
+            if (err == CL_SUCCESS) {
+                step = "clEnqueueReadBuffer";
+                err = engine.queue.enqueueReadBuffer(
+                    d_sums.buffer, CL_TRUE, 0, sums_bytes, sums.data(),
+                    &done);
+            }
+            if (err == CL_SUCCESS) {
+                err = engine.queue.enqueueReadBuffer(
+                    d_ints.buffer, CL_TRUE, 0, ints_bytes, ints.data(),
+                    &done);
+            }
+            if (err != CL_SUCCESS) {
+                // Nothing may still use the blocks once they are pooled
+                engine.queue.finish();
+            }
+        }
+        engine.pool->release(&d_sums);
+        engine.pool->release(&d_ints);
+        if (failed(step, err)) {
+            return false;
+        }
+
+        // Min/max come back as order-preserving int keys of the floats
+        auto from_key = [](int key) {
+            return std::bit_cast<float>((key >= 0) ? key : key ^ 0x7FFFFFFF);
+        };
+        out->assign(locations, LocationAggregate{});
+        for (size_t p = 0; p < partials; p++) {
+            const float* sum = &sums[p * Constants::SUMMARY_FLOATS];
+            const int* n = &ints[p * Constants::SUMMARY_INTS];
+            LocationAggregate part;
+            part.records = n[0];
+            part.passed = n[1];
+            if (part.passed > 0) {
+                part.reliability_sum = sum[0];
+                part.stability_sum = sum[1];
+                part.reliability_min = from_key(n[2]);
+                part.reliability_max = from_key(n[3]);
+                part.stability_min = from_key(n[4]);
+                part.stability_max = from_key(n[5]);
+            }
+            (*out)[p % locations].merge(part);
+        }
+        std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+                  << "Rolled up " << locations << " locations on "
+                  << engine.name << " (" << groups << " groups)\n";
+        return true;
+    } catch (const std::exception& e) {
+        stage_errors()->add(1);
+        std::cerr << Color::RED << "[OpenCL] Location summary: " << e.what()
+                  << Color::RESET << "\n";
+        return false;
+    }
 }
@@ -3,23 +3,118 @@
 #ifndef CPP_APP_SRC_OPENCL_PROCESSOR_H_
 #define CPP_APP_SRC_OPENCL_PROCESSOR_H_
 
-#include <map>
-#include <mutex>
-#include <vector>
+#include <atomic>
+#include <cstdint>
 
+#include "src/channel.h"
+#include "src/location_summary.h"
+#include "src/score_params.h"
+#include "src/server_table.h"
 #include "src/types.h"
 
+class CoreScheduler;
+class OpenCLSession;
+
+/**
+ * Scores computed by an OpenCL stage (one kernel in kernels.cl each).
+ */
+enum class DeviceFilter {
+    kReliability,   // Filter 1, compute_reliability
+    kStability,     // Filter 2, compute_stability
+    kBoth           // Both filters in one pass, compute_both
+};
+
+/**
+ * Device time of the commands of every batch, from the queue's profiling
+ * counters. Summed over batches, so overlapping batches can add up to more
+ * than the wall time. Contiguous inputs are used in place and add no
+ * upload time.
+ */
+struct DeviceProfile {
+    std::atomic<int64_t> upload_ns{0};     // Staging to device copies
+    std::atomic<int64_t> kernel_ns{0};
+    std::atomic<int64_t> transfer_ns{0};   // Result read-back
+    std::atomic<int64_t> records{0};       // Completed batches' records
+};
+
+/**
+ * Tunables for the OpenCL stage.
+ */
+struct OpenCLSettings {
+    int batch_size;          // Records per batch (0 = all available rows)
+    bool program_cache;      // Reuse compiled binaries between runs
+    bool multi_device;       // Split work across every usable device
+    bool autotune;           // Tune the launch geometry per device
+    DeviceFilter filter;     // Kernel to run
+    int cpu_threads;         // Native fallback threads (0 = one per core)
+    DeviceProfile* profile;  // Command timings (nullptr = not collected)
+    CoreScheduler* cores;    // Shares a CPU device's cores (nullptr = no)
+    ScoreParameters params;  // Iterations and thresholds (-D options)
+};
+
 /**
  * OpenCL thread function.
- * Computes reliability scores and applies Filter 1 (reliability >= 50).
+ * Computes reliability scores and applies Filter 1 (reliability >= 50),
+ * or runs Filter 2 (stability >= 50) or both filters in a single fused
+ * pass, as selected by settings.filter. A fused pass publishes only the
+ * records passing both filters and counts the rest. The work-group size
+ * and records per work-item are tuned once per device and kernel (see
+ * launch_tuner.h). Without any OpenCL
+ * device, Filter 1 falls back to cpu_reliability_thread and Filter 2 to
+ * stability_thread.
+ * Records are processed in batches that overlap on an out-of-order queue;
+ * each batch is merged into the table as soon as it completes. In
+ * multi-device mode every GPU/CPU device gets a share sized by its
+ * measured throughput and idle devices steal remaining work; that split
+ * starts once loading has finished. With settings.cores, a CPU device
+ * running Filter 1 is partitioned so that it shares the cores with a
+ * native Filter 2 instead of competing for all of them.
  *
- * @param servers Input server data
- * @param results Output map for results (thread-safe access)
- * @param mutex Mutex for thread-safe result updates
+ * @param session Contexts, programs, tuned kernels and buffer pools kept
+ *                across jobs (shared by OpenCL stages)
+ * @param table Server table; results are written lock-free
+ * @param settings Kernel, batching and program build settings;
+ *                 settings.profile sums the command times of every batch
+ * @param rows Row ranges published by the loader (used when input is
+ *             nullptr)
+ * @param input Ids to evaluate, pushed by an upstream stage
+ *              (nullptr = evaluate every loaded record)
+ * @param passed Receives the ids that passed each batch
+ *               (nullptr = not chained); closed when the thread ends
  */
 void opencl_thread(
-    const std::vector<ServerData>& servers,
-    std::map<int, ServerResult>* results,
-    std::mutex* mutex);
+    OpenCLSession* session,
+    ServerTable* table,
+    const OpenCLSettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed);
+
+/**
+ * Whether any platform (if an ICD is installed at all) has a GPU or CPU
+ * device; without one the non-fused stages run on their native engines.
+ */
+bool opencl_device_available();
+
+/**
+ * Per-location rollup of a finished job on the first OpenCL device
+ * (summarize_locations in kernels.cl): every work-group reduces its
+ * share of the rows in local memory, grouped by location id, and the
+ * partials of the groups are merged here. Sums are float within a group,
+ * so means can differ from the host pass in the last digits.
+ *
+ * @param session Contexts and programs kept across jobs
+ * @param settings Program build settings (params, program_cache)
+ * @param results The job's result columns
+ * @param out Aggregates by location id
+ * @return false without a device or if the locations do not fit in the
+ *         device's local memory
+ */
+bool summarize_locations_on_device(
+    OpenCLSession* session,
+    const OpenCLSettings& settings,
+    const ServerTable& table,
+    const ResultSnapshot& results,
+    LocationAggregates* out);
 
 #endif  // CPP_APP_SRC_OPENCL_PROCESSOR_H_
@@ -0,0 +1,324 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/opencl_session.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/config.h"
+#include "src/metrics.h"
+#include "src/program_cache.h"
+#include "src/score_params.h"
+#include "src/utils.h"
+
+namespace {
+
+constexpr size_t MIN_BLOCK_SIZE = 64;
+constexpr const char* SUMMARY_KERNEL = "summarize_locations";
+
+std::string load_kernel_source() {
+    std::ifstream kernel_file(Config::KERNEL_SOURCE_FILE);
+    if (!kernel_file) {
+        throw std::runtime_error("Cannot open kernels.cl");
+    }
+    return std::string(
+        std::istreambuf_iterator<char>(kernel_file),
+        std::istreambuf_iterator<char>());
+}
+
+/**
+ * Time launch geometries for the engine's kernel on a short-iteration
+ * build of the same source and synthetic records.
+ */
+LaunchConfig tune_engine(const DeviceEngine& engine,
+                         const cl::Device& device,
+                         const std::string& source,
+                         const OpenCLSettings& settings) {
+    const char* name = kernel_name(engine.filter);
+    ScoreParameters tune_params = settings.params;
+    tune_params.reliability_iterations = Config::TUNE_RELIABILITY_ITERATIONS;
+    tune_params.stability_iterations = Config::TUNE_STABILITY_ITERATIONS;
+    cl::Program program = build_program(
+        engine.context, device, source,
+        Config::OPENCL_BUILD_OPTIONS + kernel_defines(tune_params),
+        settings.program_cache);
+    cl::Kernel kernel(program, name);
+
+    const int count = Config::TUNE_SAMPLE_ROWS;
+    std::vector<int> uptimes(count);
+    std::vector<float> loads(count);
+    std::vector<int> ids(count);
+    for (int i = 0; i < count; i++) {
+        uptimes[i] = 1000 + (i * 37) % 9000;
+        loads[i] = static_cast<float>(i % 100);
+        ids[i] = i;
+    }
+
+    const cl::Context& context = engine.context;
+    cl::Buffer d_uptimes(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                         sizeof(int) * count, uptimes.data());
+    cl::Buffer d_loads(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                       sizeof(float) * count, loads.data());
+    cl::Buffer d_ids(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                     sizeof(int) * count, ids.data());
+    cl::Buffer d_scores(context, CL_MEM_WRITE_ONLY, sizeof(float) * count);
+    cl::Buffer d_out_ids(context, CL_MEM_WRITE_ONLY, sizeof(int) * count);
+    cl::Buffer d_counter(context, CL_MEM_READ_WRITE, sizeof(int));
+    cl::Buffer d_stability(context, CL_MEM_WRITE_ONLY,
+                           sizeof(float) * count);
+    cl::Buffer d_single_counts(context, CL_MEM_READ_WRITE, sizeof(int) * 2);
+
+    kernel.setArg(0, d_uptimes);
+    kernel.setArg(1, d_loads);
+    kernel.setArg(2, d_ids);
+    kernel.setArg(3, d_scores);
+    kernel.setArg(4, d_out_ids);
+    kernel.setArg(Constants::KERNEL_ARG_COUNTER, d_counter);
+    kernel.setArg(Constants::KERNEL_ARG_COUNT, count);
+    if (engine.filter == DeviceFilter::kBoth) {
+        kernel.setArg(Constants::KERNEL_ARG_OUT_STABILITY, d_stability);
+        kernel.setArg(Constants::KERNEL_ARG_SINGLE_COUNTS, d_single_counts);
+    }
+
+    const std::string key = std::string(name) + '\n' +
+                            cache_hash_hex(source) + '\n' +
+                            Config::OPENCL_BUILD_OPTIONS;
+    const int zero = 0;
+    return tune_launch(device, engine.kernel, key,
+                       [&](const LaunchConfig& config, size_t global,
+                           cl::Event* done) {
+        // The compaction counter indexes the outputs: reset every launch
+        const cl_int err = engine.queue.enqueueWriteBuffer(
+            d_counter, CL_TRUE, 0, sizeof(int), &zero);
+        if (err != CL_SUCCESS) {
+            return err;
+        }
+        return engine.queue.enqueueNDRangeKernel(
+            kernel, cl::NullRange, cl::NDRange(global),
+            cl::NDRange(config.local_size), nullptr, done);
+    });
+}
+
+LockMetrics* pool_lock() {
+    static LockMetrics* const lock = metrics().lock("buffer_pool");
+    return lock;
+}
+
+}  // namespace
+
+const char* kernel_name(DeviceFilter filter) {
+    switch (filter) {
+        case DeviceFilter::kStability:
+            return "compute_stability";
+        case DeviceFilter::kBoth:
+            return "compute_both";
+        case DeviceFilter::kReliability:
+        default:
+            return "compute_reliability";
+    }
+}
+
+BufferPool::~BufferPool() {
+    for (Block& block : mapped_) {
+        queue_.enqueueUnmapMemObject(block.buffer, block.host);
+    }
+    queue_.finish();
+}
+
+size_t BufferPool::size_class(size_t bytes) {
+    size_t size = MIN_BLOCK_SIZE;
+    while (size < bytes) {
+        size *= 2;
+    }
+    return size;
+}
+
+BufferPool::Block BufferPool::device(size_t bytes) {
+    const size_t size = size_class(bytes);
+    {
+        auto lock = timed_lock(mutex_, pool_lock());
+        auto& free = free_device_[size];
+        if (!free.empty()) {
+            Block block = std::move(free.back());
+            free.pop_back();
+            return block;
+        }
+    }
+    Block block;
+    block.buffer = cl::Buffer(context_, CL_MEM_READ_WRITE, size);
+    block.bytes = size;
+    return block;
+}
+
+BufferPool::Block BufferPool::pinned(size_t bytes) {
+    const size_t size = size_class(bytes);
+    auto lock = timed_lock(mutex_, pool_lock());
+    auto& free = free_pinned_[size];
+    if (!free.empty()) {
+        Block block = std::move(free.back());
+        free.pop_back();
+        return block;
+    }
+
+    Block block;
+    block.buffer = cl::Buffer(context_,
+                              CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR,
+                              size);
+    cl_int err = CL_SUCCESS;
+    block.host = queue_.enqueueMapBuffer(
+        block.buffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size,
+        nullptr, nullptr, &err);
+    if (err != CL_SUCCESS || block.host == nullptr) {
+        throw std::runtime_error("Cannot map pinned staging buffer");
+    }
+    block.bytes = size;
+    mapped_.push_back(block);
+    return block;
+}
+
+void BufferPool::release(Block* block) {
+    if (block->bytes == 0) {
+        return;
+    }
+    auto lock = timed_lock(mutex_, pool_lock());
+    auto& free = (block->host != nullptr) ? free_pinned_ : free_device_;
+    free[block->bytes].push_back(std::move(*block));
+    *block = Block{};
+}
+
+bool OpenCLSession::partition(const cl::Device& device, int units,
+                              cl::Device* out) {
+    std::scoped_lock lock(mutex_);
+    auto it = partitions_.find({device(), units});
+    if (it == partitions_.end()) {
+        if (device.getInfo<CL_DEVICE_PARTITION_MAX_SUB_DEVICES>() < 2) {
+            return false;
+        }
+        const cl_device_partition_property properties[] = {
+            CL_DEVICE_PARTITION_BY_COUNTS,
+            static_cast<cl_device_partition_property>(units),
+            CL_DEVICE_PARTITION_BY_COUNTS_LIST_END,
+            0
+        };
+        std::vector<cl::Device> sub_devices;
+        cl::Device parent = device;
+        if (parent.createSubDevices(properties, &sub_devices) != CL_SUCCESS ||
+            sub_devices.empty()) {
+            return false;
+        }
+        it = partitions_.emplace(std::make_pair(device(), units),
+                                 sub_devices[0]).first;
+    }
+    *out = it->second;
+    return true;
+}
+
+OpenCLSession::DeviceState* OpenCLSession::device_state(
+    const cl::Device& device) {
+    DeviceState* state = nullptr;
+    {
+        std::scoped_lock lock(mutex_);
+        auto& slot = devices_[device()];
+        if (!slot) {
+            slot = std::make_unique<DeviceState>();
+        }
+        state = slot.get();
+    }
+
+    std::scoped_lock lock(state->mutex);
+    if (!state->pool) {
+        state->name = device.getInfo<CL_DEVICE_NAME>();
+        state->context = cl::Context(device);
+
+        // Enable profiling + out-of-order execution
+        cl_command_queue_properties props =
+            CL_QUEUE_PROFILING_ENABLE | CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+        state->queue = cl::CommandQueue(state->context, device, props);
+
+        state->source = load_kernel_source();
+        state->pool = std::make_unique<BufferPool>(state->context,
+                                                   state->queue);
+    } else {
+        std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+                  << "Reusing session for " << state->name << "\n";
+    }
+    return state;
+}
+
+const cl::Program& OpenCLSession::program(DeviceState* state,
+                                          const cl::Device& device,
+                                          const OpenCLSettings& settings) {
+    const std::string defines = kernel_defines(settings.params);
+    auto program = state->programs.find(defines);
+    if (program == state->programs.end()) {
+        if (!state->programs.empty()) {
+            std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+                      << "Specializing " << state->name << " for "
+                      << score_preset_name(settings.params) << " precision ("
+                      << settings.params.reliability_iterations << "/"
+                      << settings.params.stability_iterations
+                      << " iterations)\n";
+        }
+        program = state->programs.emplace(
+            defines,
+            build_program(state->context, device, state->source,
+                          Config::OPENCL_BUILD_OPTIONS + defines,
+                          settings.program_cache)).first;
+    }
+    return program->second;
+}
+
+DeviceEngine OpenCLSession::engine(const cl::Device& device,
+                                   const OpenCLSettings& settings) {
+    DeviceState* state = device_state(device);
+    std::scoped_lock lock(state->mutex);
+    const std::string defines = kernel_defines(settings.params);
+    const auto key = std::make_pair(settings.filter, defines);
+    auto it = state->engines.find(key);
+    if (it != state->engines.end()) {
+        return it->second;
+    }
+
+    DeviceEngine engine;
+    engine.name = state->name;
+    engine.filter = settings.filter;
+    engine.context = state->context;
+    engine.queue = state->queue;
+    engine.kernel = cl::Kernel(program(state, device, settings),
+                               kernel_name(settings.filter));
+    engine.launch = LaunchConfig{Config::DEFAULT_LOCAL_SIZE, 1};
+    engine.pool = state->pool.get();
+
+    // The geometry does not depend on the iteration counts
+    auto launch = state->launches.find(settings.filter);
+    if (launch != state->launches.end()) {
+        engine.launch = launch->second;
+    } else if (settings.autotune) {
+        engine.launch = tune_engine(engine, device, state->source, settings);
+        state->launches.emplace(settings.filter, engine.launch);
+    }
+    state->engines.emplace(key, engine);
+    return engine;
+}
+
+DeviceEngine OpenCLSession::summary_engine(const cl::Device& device,
+                                           const OpenCLSettings& settings) {
+    DeviceState* state = device_state(device);
+    std::scoped_lock lock(state->mutex);
+    DeviceEngine engine;
+    engine.name = state->name;
+    engine.filter = settings.filter;
+    engine.context = state->context;
+    engine.queue = state->queue;
+    engine.kernel = cl::Kernel(program(state, device, settings),
+                               SUMMARY_KERNEL);
+    engine.launch = LaunchConfig{Config::DEFAULT_LOCAL_SIZE, 1};
+    engine.pool = state->pool.get();
+    return engine;
+}
@@ -0,0 +1,156 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_OPENCL_SESSION_H_
+#define CPP_APP_SRC_OPENCL_SESSION_H_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/launch_tuner.h"
+#include "src/opencl_common.h"
+#include "src/opencl_processor.h"
+
+/**
+ * Size-class pool of device buffers and mapped pinned staging buffers
+ * for one device. Blocks are rounded up to a power of two and handed out
+ * again after release, so repeated batches and jobs allocate nothing.
+ * Thread-safe.
+ */
+class BufferPool {
+ public:
+    /**
+     * A pooled buffer; host is the persistent mapping of a pinned block
+     * (nullptr for device blocks).
+     */
+    struct Block {
+        cl::Buffer buffer;
+        void* host = nullptr;
+        size_t bytes = 0;         // Size class, >= the requested size
+    };
+
+    BufferPool(const cl::Context& context, const cl::CommandQueue& queue)
+        : context_(context), queue_(queue) {}
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * Device-side read/write buffer of at least bytes.
+     */
+    Block device(size_t bytes);
+
+    /**
+     * Pinned (CL_MEM_ALLOC_HOST_PTR) staging buffer of at least bytes,
+     * mapped once. Use host as the source or destination of transfers to
+     * device blocks; the buffer itself is never a kernel argument.
+     */
+    Block pinned(size_t bytes);
+
+    /**
+     * Return a block to its size class (empty blocks are ignored).
+     */
+    void release(Block* block);
+
+ private:
+    static size_t size_class(size_t bytes);
+
+    cl::Context context_;
+    cl::CommandQueue queue_;
+    std::mutex mutex_;
+    std::map<size_t, std::vector<Block>> free_device_;
+    std::map<size_t, std::vector<Block>> free_pinned_;
+    std::vector<Block> mapped_;   // Every pinned block, unmapped at exit
+};
+
+/**
+ * What one OpenCL stage needs to run a kernel on one device.
+ */
+struct DeviceEngine {
+    std::string name;
+    DeviceFilter filter = DeviceFilter::kReliability;
+    cl::Context context;
+    cl::CommandQueue queue;
+    cl::Kernel kernel;
+    LaunchConfig launch{0, 1};
+    BufferPool* pool = nullptr;
+};
+
+/**
+ * Kernel function name for a filter.
+ */
+const char* kernel_name(DeviceFilter filter);
+
+/**
+ * OpenCL state that outlives a single job: per device one context, one
+ * profiling out-of-order queue, a buffer pool and one built program per
+ * score parameter set; per device and kernel the tuned launch geometry,
+ * per parameter set the kernel object. Tuning settings are taken from the
+ * first request.
+ */
+class OpenCLSession {
+ public:
+    OpenCLSession() = default;
+    OpenCLSession(const OpenCLSession&) = delete;
+    OpenCLSession& operator=(const OpenCLSession&) = delete;
+
+    /**
+     * Engine for a device, settings.filter and settings.params, created
+     * on first use (a new parameter set builds a specialized program).
+     * Thread-safe; one thread at a time may use a given engine.
+     */
+    DeviceEngine engine(const cl::Device& device,
+                        const OpenCLSettings& settings);
+
+    /**
+     * Engine running summarize_locations (kernels.cl) on a device with
+     * the default geometry, from the program of settings.params.
+     * Thread-safe.
+     */
+    DeviceEngine summary_engine(const cl::Device& device,
+                                const OpenCLSettings& settings);
+
+    /**
+     * Sub-device of the first units compute units of a device (device
+     * fission), created on first use and kept like the device's engines.
+     * @return false if the device cannot be partitioned
+     */
+    bool partition(const cl::Device& device, int units, cl::Device* out);
+
+ private:
+    struct DeviceState {
+        std::mutex mutex;         // Serializes setup of this device only
+        std::string name;
+        cl::Context context;
+        cl::CommandQueue queue;
+        std::string source;
+        std::unique_ptr<BufferPool> pool;
+        std::map<std::string, cl::Program> programs;  // By -D options
+        std::map<DeviceFilter, LaunchConfig> launches;
+        std::map<std::pair<DeviceFilter, std::string>, DeviceEngine>
+            engines;
+    };
+
+    /**
+     * State of a device, set up on first use (context, queue, pool).
+     */
+    DeviceState* device_state(const cl::Device& device);
+
+    /**
+     * Program of settings.params, built on first use. Caller holds
+     * state->mutex.
+     */
+    const cl::Program& program(DeviceState* state, const cl::Device& device,
+                               const OpenCLSettings& settings);
+
+    std::mutex mutex_;
+    std::map<cl_device_id, std::unique_ptr<DeviceState>> devices_;
+    std::map<std::pair<cl_device_id, int>, cl::Device> partitions_;
+};
+
+#endif  // CPP_APP_SRC_OPENCL_SESSION_H_
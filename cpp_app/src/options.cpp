@@ -0,0 +1,342 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/options.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "src/config.h"
+#include "src/utils.h"
+
+namespace {
+
+bool parse_int(const std::string& name, const char* value, int min_value,
+               int* out) {
+    if (value == nullptr) {
+        std::cerr << Color::RED << "[Error] Missing value for " << name
+                  << Color::RESET << "\n";
+        return false;
+    }
+    try {
+        size_t pos = 0;
+        int parsed = std::stoi(value, &pos);
+        if (value[pos] != '\0' || parsed < min_value) {
+            throw std::invalid_argument(value);
+        }
+        *out = parsed;
+        return true;
+    } catch (const std::exception&) {
+        std::cerr << Color::RED << "[Error] Invalid value for " << name
+                  << ": " << value << Color::RESET << "\n";
+        return false;
+    }
+}
+
+bool parse_pipeline(const char* value, PipelineMode* out) {
+    const std::string name = (value != nullptr) ? value : "";
+    for (PipelineMode mode : {PipelineMode::kParallel,
+                              PipelineMode::kOpenCLFirst,
+                              PipelineMode::kPythonFirst,
+                              PipelineMode::kFused}) {
+        if (name == pipeline_name(mode)) {
+            *out = mode;
+            return true;
+        }
+    }
+    std::cerr << Color::RED << "[Error] Invalid value for --pipeline: "
+              << name << " (parallel, opencl-first, python-first, fused)"
+              << Color::RESET << "\n";
+    return false;
+}
+
+bool parse_stability(const char* value, StabilityBackend* out) {
+    const std::string name = (value != nullptr) ? value : "";
+    for (StabilityBackend backend : {StabilityBackend::kPython,
+                                     StabilityBackend::kNative,
+                                     StabilityBackend::kOpenCL,
+                                     StabilityBackend::kCluster}) {
+        if (name == stability_name(backend)) {
+            *out = backend;
+            return true;
+        }
+    }
+    std::cerr << Color::RED << "[Error] Invalid value for --stability: "
+              << name << " (python, native, opencl, cluster)" << Color::RESET
+              << "\n";
+    return false;
+}
+
+bool parse_transport(const char* value, WireTransport* out) {
+    const std::string name = (value != nullptr) ? value : "";
+    for (WireTransport transport : {WireTransport::kTcp,
+                                    WireTransport::kIpc,
+                                    WireTransport::kShm}) {
+        if (name == transport_name(transport)) {
+            *out = transport;
+            return true;
+        }
+    }
+    std::cerr << Color::RED << "[Error] Invalid value for --wire-transport: "
+              << name << " (tcp, ipc, shm)" << Color::RESET << "\n";
+    return false;
+}
+
+bool parse_summary(const char* value, SummaryMode* out) {
+    const std::string name = (value != nullptr) ? value : "";
+    for (SummaryMode mode : {SummaryMode::kHost, SummaryMode::kDevice}) {
+        if (name == summary_name(mode)) {
+            *out = mode;
+            return true;
+        }
+    }
+    std::cerr << Color::RED << "[Error] Invalid value for --summary: "
+              << name << " (host, device)" << Color::RESET << "\n";
+    return false;
+}
+
+bool parse_precision(const char* value, ScoreParameters* out) {
+    const std::string name = (value != nullptr) ? value : "";
+    if (score_preset(name, out)) {
+        return true;
+    }
+    std::cerr << Color::RED << "[Error] Invalid value for --precision: "
+              << name << " (full, quick)" << Color::RESET << "\n";
+    return false;
+}
+
+bool python_workers(const Options& options) {
+    return options.pipeline != PipelineMode::kFused &&
+           (options.stability == StabilityBackend::kPython ||
+            options.stability == StabilityBackend::kCluster);
+}
+
+}  // namespace
+
+ScoreParameters job_score_parameters(const Options& options) {
+    ScoreParameters params = options.params;
+    if (python_workers(options)) {
+        params.stability_iterations = Constants::STABILITY_ITERATIONS;
+        params.stability_threshold = Constants::STABILITY_THRESHOLD;
+        params.stability_exit_checks = 0;
+    }
+    return params;
+}
+
+const char* summary_name(SummaryMode mode) {
+    return (mode == SummaryMode::kDevice) ? "device" : "host";
+}
+
+const char* transport_name(WireTransport transport) {
+    switch (transport) {
+        case WireTransport::kIpc:
+            return "ipc";
+        case WireTransport::kShm:
+            return "shm";
+        case WireTransport::kTcp:
+        default:
+            return "tcp";
+    }
+}
+
+const char* stability_name(StabilityBackend backend) {
+    switch (backend) {
+        case StabilityBackend::kNative:
+            return "native";
+        case StabilityBackend::kOpenCL:
+            return "opencl";
+        case StabilityBackend::kCluster:
+            return "cluster";
+        case StabilityBackend::kPython:
+        default:
+            return "python";
+    }
+}
+
+const char* pipeline_name(PipelineMode mode) {
+    switch (mode) {
+        case PipelineMode::kOpenCLFirst:
+            return "opencl-first";
+        case PipelineMode::kPythonFirst:
+            return "python-first";
+        case PipelineMode::kFused:
+            return "fused";
+        case PipelineMode::kParallel:
+        default:
+            return "parallel";
+    }
+}
+
+bool parse_options(int argc, char* argv[], Options* options) {
+    options->input_file = Config::DEFAULT_INPUT_FILE;
+    options->batch_size = Config::OPENCL_BATCH_SIZE;
+    options->pipeline = PipelineMode::kParallel;
+    options->program_cache = true;
+    options->multi_device = false;
+    options->autotune = true;
+    options->wire_batch = Config::WIRE_BATCH_SIZE;
+    options->wire_multipart = false;
+    options->wire_credits = true;
+    options->wire_transport = WireTransport::kTcp;
+    options->stability = StabilityBackend::kPython;
+    options->stability_threads = 0;
+    options->cpu_reliability = false;
+    options->cpu_threads = 0;
+    options->co_schedule = true;
+    options->params = ScoreParameters{};
+    options->score_cache = true;
+    options->delta.clear();
+    options->serve = false;
+    options->stream.clear();
+    options->trace.clear();
+    options->summary = SummaryMode::kHost;
+    options->memory_budget = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (arg == "--batch-size") {
+            if (!parse_int(arg, next, 0, &options->batch_size)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--pipeline") {
+            if (!parse_pipeline(next, &options->pipeline)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--no-program-cache") {
+            options->program_cache = false;
+        } else if (arg == "--multi-device") {
+            options->multi_device = true;
+        } else if (arg == "--no-autotune") {
+            options->autotune = false;
+        } else if (arg == "--wire-batch") {
+            if (!parse_int(arg, next, 1, &options->wire_batch)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--wire-multipart") {
+            options->wire_multipart = true;
+        } else if (arg == "--no-wire-credits") {
+            options->wire_credits = false;
+        } else if (arg == "--wire-transport") {
+            if (!parse_transport(next, &options->wire_transport)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--stability") {
+            if (!parse_stability(next, &options->stability)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--stability-threads") {
+            if (!parse_int(arg, next, 0, &options->stability_threads)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--cpu-reliability") {
+            options->cpu_reliability = true;
+        } else if (arg == "--cpu-threads") {
+            if (!parse_int(arg, next, 0, &options->cpu_threads)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--no-co-schedule") {
+            options->co_schedule = false;
+        } else if (arg == "--precision") {
+            if (!parse_precision(next, &options->params)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--iterations") {
+            if (!parse_int(arg, next, 1,
+                           &options->params.reliability_iterations)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--stability-iterations") {
+            if (!parse_int(arg, next, 1,
+                           &options->params.stability_iterations)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--early-exit") {
+            int checks = 0;
+            if (!parse_int(arg, next, 1, &checks)) {
+                return false;
+            }
+            options->params.reliability_exit_checks = checks;
+            options->params.stability_exit_checks = checks;
+            i++;
+        } else if (arg == "--no-score-cache") {
+            options->score_cache = false;
+        } else if (arg == "--delta") {
+            if (next == nullptr) {
+                std::cerr << Color::RED << "[Error] Missing value for "
+                          << arg << Color::RESET << "\n";
+                return false;
+            }
+            options->delta = next;
+            i++;
+        } else if (arg == "--serve") {
+            options->serve = true;
+        } else if (arg == "--stream") {
+            if (next == nullptr) {
+                std::cerr << Color::RED << "[Error] Missing value for "
+                          << arg << Color::RESET << "\n";
+                return false;
+            }
+            options->stream = next;
+            i++;
+        } else if (arg == "--trace") {
+            if (next == nullptr) {
+                std::cerr << Color::RED << "[Error] Missing value for "
+                          << arg << Color::RESET << "\n";
+                return false;
+            }
+            options->trace = next;
+            i++;
+        } else if (arg == "--summary") {
+            if (!parse_summary(next, &options->summary)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--memory-budget") {
+            if (!parse_int(arg, next, 1, &options->memory_budget)) {
+                return false;
+            }
+            i++;
+        } else if (arg[0] != '-') {
+            options->input_file = arg;
+        } else {
+            std::cerr << Color::RED << "[Error] Unknown option: " << arg
+                      << Color::RESET << "\n";
+            return false;
+        }
+    }
+
+    if (options->cpu_reliability &&
+        options->pipeline == PipelineMode::kFused) {
+        std::cerr << Color::RED << "[Error] --pipeline fused runs both "
+                  << "filters on OpenCL, drop --cpu-reliability"
+                  << Color::RESET << "\n";
+        return false;
+    }
+    if (options->memory_budget > 0 &&
+        (options->serve || !options->delta.empty())) {
+        std::cerr << Color::RED << "[Error] --memory-budget runs one "
+                  << "inventory in windows, drop --serve and --delta"
+                  << Color::RESET << "\n";
+        return false;
+    }
+    if (python_workers(*options) &&
+        options->params.stability_iterations !=
+            Constants::STABILITY_ITERATIONS) {
+        std::cout << Color::YELLOW << "[Main] " << Color::RESET
+                  << "The Python workers use their own stability "
+                  << "iterations (python_app/config.py)\n";
+    }
+    return true;
+}
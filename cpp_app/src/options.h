@@ -0,0 +1,114 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_OPTIONS_H_
+#define CPP_APP_SRC_OPTIONS_H_
+
+#include <string>
+
+#include "src/score_params.h"
+
+/**
+ * Order in which the two filters are applied.
+ */
+enum class PipelineMode {
+    kParallel,      // Both filters evaluate every record concurrently
+    kOpenCLFirst,   // Only records passing Filter 1 are sent to Python
+    kPythonFirst,   // Only records passing Filter 2 are run on OpenCL
+    kFused          // One OpenCL pass computes both filters
+};
+
+/**
+ * Where Filter 2 (stability) is computed.
+ */
+enum class StabilityBackend {
+    kPython,        // Python workers over ZMQ (remote offload possible)
+    kNative,        // In-process thread pool
+    kOpenCL,        // compute_stability kernel
+    kCluster        // Python worker nodes behind a ROUTER socket
+};
+
+/**
+ * How records and results travel between C++ and the Python workers.
+ */
+enum class WireTransport {
+    kTcp,           // Loopback or remote TCP
+    kIpc,           // Unix domain sockets (same host)
+    kShm            // Shared-memory ring, slot frames over IPC (same host)
+};
+
+/**
+ * Where the per-location rollup is computed (LocationRollup).
+ */
+enum class SummaryMode {
+    kHost,          // As results arrive, on the publishing threads
+    kDevice         // summarize_locations kernel over the final results
+};
+
+/**
+ * Runtime options parsed from the command line.
+ */
+struct Options {
+    std::string input_file;
+    int batch_size;          // Records per OpenCL batch (0 = all available)
+    PipelineMode pipeline;
+    bool program_cache;      // Reuse compiled OpenCL binaries
+    bool multi_device;       // Use every OpenCL device
+    bool autotune;           // Tune OpenCL launch geometry per device
+    int wire_batch;          // Records per ZMQ batch frame (1 = legacy)
+    bool wire_multipart;     // Send batch columns as multipart messages
+    bool wire_credits;       // Credit-based flow control for batch frames
+    WireTransport wire_transport;
+    StabilityBackend stability;
+    int stability_threads;   // Native stability threads (0 = one per core)
+    bool cpu_reliability;    // Filter 1 on the CPU even with OpenCL
+    int cpu_threads;         // CPU reliability threads (0 = one per core)
+    bool co_schedule;        // Split the cores when both filters use them
+    ScoreParameters params;  // Iterations and thresholds (--precision)
+    bool score_cache;        // Reuse scores of earlier runs (ScoreCache)
+    std::string delta;       // Previous run's snapshot ("" = score all)
+    bool serve;              // Stay up and take jobs on the control socket
+    std::string stream;      // Incremental result sink ("" = none)
+    std::string trace;       // Chrome trace of each job ("" = none)
+    SummaryMode summary;     // Per-location rollup (--summary)
+    int memory_budget;       // MiB per out-of-core window (0 = in memory)
+};
+
+/**
+ * Human readable pipeline mode name (as accepted by --pipeline).
+ */
+const char* pipeline_name(PipelineMode mode);
+
+/**
+ * Stability backend name (as accepted by --stability).
+ */
+const char* stability_name(StabilityBackend backend);
+
+/**
+ * Transport name (as accepted by --wire-transport).
+ */
+const char* transport_name(WireTransport transport);
+
+/**
+ * Rollup mode name (as accepted by --summary).
+ */
+const char* summary_name(SummaryMode mode);
+
+/**
+ * Score parameters a job runs with: options.params, except that Filter 2
+ * on the Python workers keeps their STABILITY_ITERATIONS
+ * (python_app/config.py) and runs exact.
+ */
+ScoreParameters job_score_parameters(const Options& options);
+
+/**
+ * Parse command line arguments.
+ * Positional argument is the input file, flags start with "--".
+ *
+ * @param argc Argument count
+ * @param argv Argument values
+ * @param options Output options (defaults applied first)
+ * @return true on success, false on invalid arguments
+ */
+bool parse_options(int argc, char* argv[], Options* options);
+
+#endif  // CPP_APP_SRC_OPTIONS_H_
@@ -0,0 +1,118 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/out_of_core.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "src/binary_format.h"
+#include "src/config.h"
+#include "src/data_io.h"
+#include "src/location_summary.h"
+#include "src/pipeline.h"
+#include "src/server_table.h"
+#include "src/utils.h"
+
+namespace {
+
+/**
+ * Peak resident set size of the process so far, in MiB.
+ */
+int64_t peak_rss_mb() {
+    struct rusage usage {};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;   // Linux reports KiB
+}
+
+}  // namespace
+
+size_t window_rows(int budget_mb) {
+    const size_t budget = static_cast<size_t>(budget_mb) << 20;
+    return std::clamp<size_t>(budget / Config::OUT_OF_CORE_ROW_BYTES,
+                              Config::LOAD_CHUNK_ROWS, INT32_MAX);
+}
+
+bool run_out_of_core(
+    const Options& options,
+    Executor* executor,
+    OpenCLSession* session,
+    WorkerLink* workers,
+    WorkerCluster* cluster,
+    CoreScheduler* cores,
+    ScoreCache* scores,
+    ResultStream* stream,
+    LocationRollup* rollup,
+    const std::string& output) {
+    if (!is_binary_inventory(options.input_file)) {
+        std::cerr << Color::RED << "[Error] --memory-budget needs a binary "
+                  << "inventory, convert it with convert_app first"
+                  << Color::RESET << "\n";
+        return false;
+    }
+    BinaryInventory inventory;
+    if (!inventory.open(options.input_file)) {
+        return false;
+    }
+    const size_t total = inventory.rows();
+    if (total == 0) {
+        std::cerr << Color::RED << "[Error] No data" << Color::RESET << "\n";
+        return false;
+    }
+    const size_t window = window_rows(options.memory_budget);
+    const size_t windows = (total + window - 1) / window;
+    std::cout << Color::BLUE << "[OutOfCore] " << Color::RESET << total
+              << " servers in " << windows << " window(s) of " << window
+              << " rows (" << options.memory_budget << " MiB budget)\n";
+
+    LocationAggregates locations;
+    try {
+        SpilledReport report(output);
+        for (size_t begin = 0, w = 1; begin < total; begin += window, w++) {
+            const size_t end = std::min(total, begin + window);
+            {
+                ServerTable table;
+                if (!run_pipeline(
+                        options, executor, session, workers, cluster, cores,
+                        scores, stream, rollup, &table,
+                        [&inventory, begin, end](
+                            ServerTable* out,
+                            const std::vector<Channel<RowRange>*>& to) {
+                            return inventory.load(out, begin, end, to);
+                        })) {
+                    return false;
+                }
+                const ResultSnapshot results = table.snapshot();
+                report.add_window(table, results);
+
+                const LocationAggregates& part = rollup->locations();
+                locations.resize(std::max(locations.size(), part.size()));
+                for (size_t l = 0; l < part.size(); l++) {
+                    locations[l].merge(part[l]);
+                }
+                std::cout << Color::BLUE << "[OutOfCore] " << Color::RESET
+                          << "Window " << w << "/" << windows << ": "
+                          << results.counts.both << "/" << table.size()
+                          << " passed both, peak RSS " << peak_rss_mb()
+                          << " MiB\n";
+            }
+            // The window's table is gone; drop its pages too
+            inventory.release(begin, end);
+        }
+        if (!report.finish(inventory.locations())) {
+            return false;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[OutOfCore] " << e.what() << Color::RESET
+                  << "\n";
+        return false;
+    }
+    write_location_summary(inventory.locations(), locations,
+                           summary_path(output));
+    return true;
+}
@@ -0,0 +1,53 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_OUT_OF_CORE_H_
+#define CPP_APP_SRC_OUT_OF_CORE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "src/options.h"
+
+class CoreScheduler;
+class Executor;
+class LocationRollup;
+class OpenCLSession;
+class ResultStream;
+class ScoreCache;
+class WorkerCluster;
+class WorkerLink;
+
+/**
+ * Rows per window for a memory budget of budget_mb MiB
+ * (Config::OUT_OF_CORE_ROW_BYTES per row, at least
+ * Config::LOAD_CHUNK_ROWS).
+ */
+size_t window_rows(int budget_mb);
+
+/**
+ * Out-of-core run (--memory-budget) of a binary inventory larger than
+ * RAM. The rows are attached from the mapping one window at a time and
+ * each window runs through run_pipeline as a job of its own, so the
+ * table, result columns, OpenCL buffers and wire batches never hold
+ * more than a window. A finished window's report lines and summary are
+ * spilled (SpilledReport, LocationRollup) and its mapped pages released
+ * before the next one is attached, so peak RSS follows the budget and
+ * not the inventory size.
+ *
+ * The parameters are those of run_pipeline; the report and the location
+ * summary are written to output and its summary_path().
+ * @return true on success
+ */
+bool run_out_of_core(
+    const Options& options,
+    Executor* executor,
+    OpenCLSession* session,
+    WorkerLink* workers,
+    WorkerCluster* cluster,
+    CoreScheduler* cores,
+    ScoreCache* scores,
+    ResultStream* stream,
+    LocationRollup* rollup,
+    const std::string& output);
+
+#endif  // CPP_APP_SRC_OUT_OF_CORE_H_
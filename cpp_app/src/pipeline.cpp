@@ -0,0 +1,308 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/pipeline.h"
+
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/config.h"
+#include "src/core_scheduler.h"
+#include "src/cpu_reliability.h"
+#include "src/executor.h"
+#include "src/location_summary.h"
+#include "src/metrics.h"
+#include "src/opencl_processor.h"
+#include "src/opencl_session.h"
+#include "src/program_cache.h"
+#include "src/result_stream.h"
+#include "src/run_snapshot.h"
+#include "src/score_cache.h"
+#include "src/stability_engine.h"
+#include "src/utils.h"
+#include "src/worker_cluster.h"
+#include "src/zmq_comm.h"
+
+namespace {
+
+/**
+ * Hash of a source file's contents ("missing" if it cannot be read).
+ */
+std::string source_hash(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return "missing";
+    }
+    return cache_hash_hex(std::string(std::istreambuf_iterator<char>(file),
+                                      std::istreambuf_iterator<char>()));
+}
+
+}  // namespace
+
+std::string job_score_engines(const Options& options) {
+    // The same choices the stages make, including the native fallback of
+    // the non-fused OpenCL stages without a device
+    const bool device = opencl_device_available();
+    const std::string kernels =
+        "opencl:" + source_hash(Config::KERNEL_SOURCE_FILE);
+    if (options.pipeline == PipelineMode::kFused) {
+        return "fused=" + kernels;
+    }
+    const std::string reliability =
+        (options.cpu_reliability || !device) ? "cpu" : kernels;
+    std::string stability;
+    switch (options.stability) {
+        case StabilityBackend::kPython:
+        case StabilityBackend::kCluster:
+            stability = "python:" +
+                        source_hash(Config::PYTHON_FUNCTIONS_FILE);
+            break;
+        case StabilityBackend::kOpenCL:
+            stability = device ? kernels : "native";
+            break;
+        case StabilityBackend::kNative:
+        default:
+            stability = "native";
+            break;
+    }
+    return "reliability=" + reliability + " stability=" + stability;
+}
+
+bool run_pipeline(
+    const Options& options,
+    Executor* executor,
+    OpenCLSession* session,
+    WorkerLink* workers,
+    WorkerCluster* cluster,
+    CoreScheduler* cores,
+    ScoreCache* scores,
+    ResultStream* stream,
+    LocationRollup* rollup,
+    ServerTable* table,
+    const TableLoader& load) {
+    // Chained modes forward ids that passed the first filter to the other
+    // (python_passed: Filter 2, from the Python workers or the native pool)
+    Channel<IdBatch> passed_ids;
+    Channel<IdBatch>* opencl_passed =
+        (options.pipeline == PipelineMode::kOpenCLFirst) ? &passed_ids
+                                                         : nullptr;
+    Channel<IdBatch>* python_passed =
+        (options.pipeline == PipelineMode::kPythonFirst) ? &passed_ids
+                                                         : nullptr;
+
+    // The fused pass runs both filters in the OpenCL stage
+    const bool fused = (options.pipeline == PipelineMode::kFused);
+
+    // The loader streams row ranges to the stages that run first
+    Channel<RowRange> opencl_rows;
+    Channel<RowRange> stability_rows;
+    std::vector<Channel<RowRange>*> loaded_rows;
+    if (python_passed == nullptr) {
+        loaded_rows.push_back(&opencl_rows);
+    }
+    if (opencl_passed == nullptr && !fused) {
+        loaded_rows.push_back(&stability_rows);
+    }
+
+    // With the score cache the loader feeds it, and it feeds the stages
+    // the records it cannot answer (from its memo or the previous run)
+    Channel<RowRange> cached_rows;
+    PreviousRun previous;
+    const ScoreParameters params = job_score_parameters(options);
+    const std::string engines = job_score_engines(options);
+    if (scores != nullptr && !options.delta.empty() &&
+        !previous.open(options.delta, params, engines)) {
+        std::cout << Color::YELLOW << "[Data] " << Color::RESET
+                  << "Scoring every record\n";
+    }
+    if (scores != nullptr) {
+        const CacheRoutes routes{
+            .reliability_rows =
+                (python_passed == nullptr) ? &opencl_rows : nullptr,
+            .stability_rows =
+                (opencl_passed == nullptr && !fused) ? &stability_rows
+                                                     : nullptr,
+            .reliability_passed = opencl_passed,
+            .stability_passed = python_passed,
+            .fused = fused
+        };
+        scores->begin(table, routes,
+                      (previous.size() > 0) ? &previous : nullptr, params,
+                      engines);
+        loaded_rows = {&cached_rows};
+    }
+
+    // Filter 2 on this host competes with a CPU Filter 1 for the cores
+    const bool native_stability =
+        !fused && options.stability == StabilityBackend::kNative;
+    const bool python_stability =
+        !fused && options.stability == StabilityBackend::kPython;
+    if (cores != nullptr) {
+        cores->begin(native_stability || python_stability);
+    }
+    auto throttle = [cores](bool pool, CoreSide side) -> PoolThrottle* {
+        return (cores != nullptr && pool) ? cores->throttle(side) : nullptr;
+    };
+
+    const OpenCLSettings opencl_settings{
+        .batch_size = options.batch_size,
+        .program_cache = options.program_cache,
+        .multi_device = options.multi_device,
+        .autotune = options.autotune,
+        .filter = fused ? DeviceFilter::kBoth : DeviceFilter::kReliability,
+        .cpu_threads = options.cpu_threads,
+        .profile = nullptr,
+        .cores = cores,
+        .params = params
+    };
+
+    OpenCLSettings opencl_stability_settings = opencl_settings;
+    opencl_stability_settings.filter = DeviceFilter::kStability;
+    opencl_stability_settings.cpu_threads = options.stability_threads;
+
+    const CpuReliabilitySettings cpu_settings{
+        .threads = options.cpu_threads,
+        .throttle = throttle(options.cpu_reliability, CoreSide::kReliability),
+        .params = params
+    };
+
+    const WireSettings wire_settings{
+        .batch_size = options.wire_batch,
+        .multipart = options.wire_multipart,
+        .credits = options.wire_credits
+    };
+    CreditGate credits(executor);
+
+    const StabilitySettings stability_settings{
+        .threads = options.stability_threads,
+        .throttle = throttle(native_stability, CoreSide::kStability),
+        .params = params
+    };
+
+    const ClusterSettings cluster_settings{
+        .batch_size = (options.wire_batch > 1) ? options.wire_batch
+                                               : Config::CLUSTER_BATCH_SIZE
+    };
+
+    metrics().set_tracing(!options.trace.empty());
+    metrics().begin_job();
+
+    // Hook in before any stage can publish a result
+    if (stream != nullptr && stream->enabled()) {
+        try {
+            stream->begin(table);
+        } catch (const std::exception& e) {
+            std::cerr << Color::RED << "[Stream] " << e.what()
+                      << Color::RESET << "\n";
+            stream = nullptr;
+        }
+    } else {
+        stream = nullptr;
+    }
+    if (rollup != nullptr) {
+        rollup->begin(table);
+    }
+
+    // Filter 1 (OpenCL falls back to the CPU engine without a device)
+    std::jthread t_opencl;
+    if (options.cpu_reliability) {
+        t_opencl = std::jthread(cpu_reliability_thread,
+                                table,
+                                std::cref(cpu_settings),
+                                &opencl_rows,
+                                python_passed,
+                                opencl_passed);
+    } else {
+        t_opencl = std::jthread(opencl_thread,
+                                session,
+                                table,
+                                std::cref(opencl_settings),
+                                &opencl_rows,
+                                python_passed,
+                                opencl_passed);
+    }
+    std::jthread t_stability;
+    std::vector<std::future<void>> coroutines;   // On the executor
+    if (fused) {
+        // Nothing to start: Filter 2 runs in t_opencl
+    } else if (options.stability == StabilityBackend::kOpenCL) {
+        t_stability = std::jthread(opencl_thread,
+                                   session,
+                                   table,
+                                   std::cref(opencl_stability_settings),
+                                   &stability_rows,
+                                   opencl_passed,
+                                   python_passed);
+    } else if (options.stability == StabilityBackend::kCluster) {
+        t_stability = std::jthread(cluster_thread,
+                                   cluster,
+                                   table,
+                                   std::cref(cluster_settings),
+                                   &stability_rows,
+                                   opencl_passed,
+                                   python_passed);
+    } else if (options.stability == StabilityBackend::kNative) {
+        t_stability = std::jthread(stability_thread,
+                                   table,
+                                   std::cref(stability_settings),
+                                   &stability_rows,
+                                   opencl_passed,
+                                   python_passed);
+    } else {
+        coroutines.push_back(executor->start(
+            send_tasks(executor, workers, &credits, *table, wire_settings,
+                       &stability_rows, opencl_passed)));
+        coroutines.push_back(executor->start(
+            receive_results(executor, workers, &credits, table,
+                            python_passed)));
+    }
+
+    std::jthread t_cache;
+    if (scores != nullptr) {
+        t_cache = std::jthread([scores, table, &cached_rows] {
+            scores->lookup(table, &cached_rows);
+        });
+    }
+
+    // Load data; the stages start on the first chunk
+    bool loaded = false;
+    {
+        TraceScope scope("loader", "load");
+        loaded = load(table, loaded_rows);
+    }
+
+    // Every result is final once the stages are done
+    for (std::jthread* stage : {&t_cache, &t_opencl, &t_stability}) {
+        if (stage->joinable()) {
+            stage->join();
+        }
+    }
+    for (std::future<void>& stage : coroutines) {
+        stage.get();
+    }
+    if (stream != nullptr) {
+        stream->finish();
+    }
+    table->clear_completion_hooks();
+    if (rollup != nullptr) {
+        rollup->finish(*table, session, opencl_settings);
+    }
+    if (cores != nullptr) {
+        cores->finish();
+    }
+    if (scores != nullptr) {
+        scores->finish(*table);
+    }
+
+    metrics().end_job();
+    if (!options.trace.empty()) {
+        metrics().write_trace(options.trace);
+    }
+    return loaded;
+}
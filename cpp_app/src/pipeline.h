@@ -0,0 +1,76 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_PIPELINE_H_
+#define CPP_APP_SRC_PIPELINE_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "src/channel.h"
+#include "src/options.h"
+#include "src/server_table.h"
+#include "src/types.h"
+
+class CoreScheduler;
+class Executor;
+class LocationRollup;
+class OpenCLSession;
+class ResultStream;
+class ScoreCache;
+class WorkerCluster;
+class WorkerLink;
+
+/**
+ * Fills the table and publishes row ranges to the consumers, closing
+ * them on return (load_data, load_binary).
+ * @return true on success
+ */
+using TableLoader = std::function<bool(
+    ServerTable* table, const std::vector<Channel<RowRange>*>& consumers)>;
+
+/**
+ * Engines that score a job's records and a hash of their sources, e.g.
+ * "reliability=opencl:<kernels.cl> stability=python:<functions.py>".
+ * The engines' results differ in the last digits (relaxed-math device
+ * code, CPU SIMD, native and Python double), so scores are only reused
+ * between jobs with equal engines; it goes into score_parameters_hash()
+ * beside the parameters.
+ */
+std::string job_score_engines(const Options& options);
+
+/**
+ * Run one job: start the filter stages selected by the options, load the
+ * table while they run and wait until every stage has finished. With a
+ * stream, records are emitted as they complete.
+ *
+ * @param options Pipeline and backend selection
+ * @param executor Runs the socket I/O to the Python workers
+ * @param session OpenCL state shared by the OpenCL stages
+ * @param workers Sockets to the Python workers (Filter 2 over ZMQ)
+ * @param cluster Router for the worker nodes (--stability cluster)
+ * @param cores Splits this host's cores between the filters when both
+ *              run on them, kept across jobs; nullptr = never split
+ * @param scores Scores of earlier runs; only the records it cannot answer
+ *               reach the stages. nullptr or disabled = compute all
+ * @param stream Incremental result sink (--stream), nullptr = none
+ * @param rollup Per-location rollup of the job (--summary), nullptr =
+ *               none; its locations() are set on return
+ * @param table Empty table receiving the records and scores
+ * @param load Loads the records
+ * @return Result of load
+ */
+bool run_pipeline(
+    const Options& options,
+    Executor* executor,
+    OpenCLSession* session,
+    WorkerLink* workers,
+    WorkerCluster* cluster,
+    CoreScheduler* cores,
+    ScoreCache* scores,
+    ResultStream* stream,
+    LocationRollup* rollup,
+    ServerTable* table,
+    const TableLoader& load);
+
+#endif  // CPP_APP_SRC_PIPELINE_H_
@@ -0,0 +1,225 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/program_cache.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>  // NOLINT(build/c++17)
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/config.h"
+#include "src/utils.h"
+
+namespace {
+
+constexpr char CACHE_MAGIC[4] = {'C', 'L', 'B', 'C'};
+constexpr uint32_t CACHE_VERSION = 2;
+
+uint64_t fnv1a(const unsigned char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t fnv1a(const std::string& data) {
+    return fnv1a(reinterpret_cast<const unsigned char*>(data.data()),
+                 data.size());
+}
+
+std::string to_hex(uint64_t value) {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx",
+                  static_cast<unsigned long long>(value));  // NOLINT
+    return buf;
+}
+
+std::string make_key(const cl::Device& device, const std::string& source,
+                     const std::string& build_options) {
+    std::ostringstream key;
+    key << device.getInfo<CL_DEVICE_NAME>() << '\n'
+        << device.getInfo<CL_DRIVER_VERSION>() << '\n'
+        << build_options << '\n'
+        << to_hex(fnv1a(source));
+    return key.str();
+}
+
+std::filesystem::path cache_path(const std::string& key) {
+    return std::filesystem::path(Config::PROGRAM_CACHE_DIR) /
+           (to_hex(fnv1a(key)) + ".clbin");
+}
+
+/**
+ * Read a cached binary; empty result when missing, the key differs or
+ * the binary does not match its checksum.
+ * File layout: magic(4) version(4) key_size(4) key binary_size(8)
+ * checksum(8, FNV-1a of the binary) binary
+ */
+std::vector<unsigned char> read_cache(const std::filesystem::path& path,
+                                      const std::string& key) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return {};
+    }
+
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint32_t key_size = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+    if (!file || std::string(magic, 4) != std::string(CACHE_MAGIC, 4) ||
+        version != CACHE_VERSION || key_size != key.size()) {
+        return {};
+    }
+
+    std::string stored_key(key_size, '\0');
+    file.read(stored_key.data(), key_size);
+    if (!file || stored_key != key) {
+        return {};
+    }
+
+    uint64_t binary_size = 0;
+    uint64_t checksum = 0;
+    file.read(reinterpret_cast<char*>(&binary_size), sizeof(binary_size));
+    file.read(reinterpret_cast<char*>(&checksum), sizeof(checksum));
+    if (!file || binary_size == 0) {
+        return {};
+    }
+
+    std::vector<unsigned char> binary(binary_size);
+    file.read(reinterpret_cast<char*>(binary.data()),
+              static_cast<std::streamsize>(binary_size));
+    if (!file || fnv1a(binary.data(), binary.size()) != checksum) {
+        return {};
+    }
+    return binary;
+}
+
+void write_cache(const std::filesystem::path& path, const std::string& key,
+                 const std::vector<unsigned char>& binary) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    const std::filesystem::path tmp = cache_temp_path(path);
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return;
+        }
+        const auto key_size = static_cast<uint32_t>(key.size());
+        const auto binary_size = static_cast<uint64_t>(binary.size());
+        const uint64_t checksum = fnv1a(binary.data(), binary.size());
+        file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&CACHE_VERSION),
+                   sizeof(CACHE_VERSION));
+        file.write(reinterpret_cast<const char*>(&key_size),
+                   sizeof(key_size));
+        file.write(key.data(), key_size);
+        file.write(reinterpret_cast<const char*>(&binary_size),
+                   sizeof(binary_size));
+        file.write(reinterpret_cast<const char*>(&checksum),
+                   sizeof(checksum));
+        file.write(reinterpret_cast<const char*>(binary.data()),
+                   static_cast<std::streamsize>(binary.size()));
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+    }
+}
+
+bool build_from_binary(const cl::Context& context, const cl::Device& device,
+                       const std::vector<unsigned char>& binary,
+                       const std::string& build_options,
+                       cl::Program* program) {
+    std::vector<cl_int> status;
+    cl_int err = CL_SUCCESS;
+    cl::Program::Binaries binaries{binary};
+    cl::Program candidate(context, {device}, binaries, &status, &err);
+    if (err != CL_SUCCESS || status.empty() || status[0] != CL_SUCCESS) {
+        return false;
+    }
+    if (candidate.build({device}, build_options.c_str()) != CL_SUCCESS) {
+        return false;
+    }
+    *program = candidate;
+    return true;
+}
+
+}  // namespace
+
+std::string cache_hash_hex(const std::string& data) {
+    return to_hex(fnv1a(data));
+}
+
+std::filesystem::path cache_temp_path(const std::filesystem::path& path) {
+    std::filesystem::path tmp = path;
+    tmp += "." + std::to_string(::getpid()) + "." +
+           to_hex(std::random_device{}()) + ".tmp";
+    return tmp;
+}
+
+cl::Program build_program(
+    const cl::Context& context,
+    const cl::Device& device,
+    const std::string& source,
+    const std::string& build_options,
+    bool use_cache) {
+    auto start = std::chrono::high_resolution_clock::now();
+    auto elapsed_ms = [&start]() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    const std::string key =
+        use_cache ? make_key(device, source, build_options) : "";
+    const std::filesystem::path path =
+        use_cache ? cache_path(key) : std::filesystem::path();
+
+    if (use_cache) {
+        std::vector<unsigned char> binary = read_cache(path, key);
+        cl::Program program;
+        if (!binary.empty() &&
+            build_from_binary(context, device, binary, build_options,
+                              &program)) {
+            std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+                      << "Program cache hit, " << elapsed_ms() << " ms\n";
+            return program;
+        }
+    }
+
+    cl::Program program(context, source);
+    if (program.build({device}, build_options.c_str()) != CL_SUCCESS) {
+        throw std::runtime_error(
+            "Build error:\n" +
+            program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device));
+    }
+
+    if (use_cache) {
+        auto binaries = program.getInfo<CL_PROGRAM_BINARIES>();
+        if (!binaries.empty() && !binaries[0].empty()) {
+            write_cache(path, key, binaries[0]);
+        }
+    }
+
+    std::cout << Color::CYAN << "[OpenCL] " << Color::RESET
+              << "Program built from source, " << elapsed_ms() << " ms\n";
+    return program;
+}
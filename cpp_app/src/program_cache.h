@@ -0,0 +1,43 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_PROGRAM_CACHE_H_
+#define CPP_APP_SRC_PROGRAM_CACHE_H_
+
+#include <filesystem>  // NOLINT(build/c++17)
+#include <string>
+
+#include "src/opencl_common.h"
+
+/**
+ * Build an OpenCL program for one device, reusing compiled binaries.
+ * The cache key is the device name, driver version, build options and a
+ * hash of the kernel source. On a miss (or an unusable cached binary) the
+ * program is built from source and its CL_PROGRAM_BINARIES are saved.
+ *
+ * @param context Context owning the device
+ * @param device Target device
+ * @param source Kernel source code
+ * @param build_options Compiler options passed to clBuildProgram
+ * @param use_cache false = always build from source, never touch the cache
+ * @return Built program, throws std::runtime_error with the build log
+ */
+cl::Program build_program(
+    const cl::Context& context,
+    const cl::Device& device,
+    const std::string& source,
+    const std::string& build_options,
+    bool use_cache);
+
+/**
+ * Hex FNV-1a hash of a cache key, as used for cache file names.
+ */
+std::string cache_hash_hex(const std::string& data);
+
+/**
+ * Temporary file next to path that only this writer uses (pid and a
+ * random suffix); written completely, then renamed over path, so
+ * concurrent runs never see a partial or mixed file.
+ */
+std::filesystem::path cache_temp_path(const std::filesystem::path& path);
+
+#endif  // CPP_APP_SRC_PROGRAM_CACHE_H_
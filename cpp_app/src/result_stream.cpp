@@ -0,0 +1,194 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/result_stream.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "src/metrics.h"
+#include "src/utils.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+bool is_endpoint(const std::string& target) {
+    return target.starts_with("tcp://") || target.starts_with("ipc://");
+}
+
+SocketMetrics* stream_socket() {
+    static SocketMetrics* const socket = metrics().socket("stream");
+    return socket;
+}
+
+/**
+ * Value at quantile q of sorted values (nearest rank).
+ */
+int64_t quantile(const std::vector<int64_t>& sorted, double q) {
+    const auto rank = static_cast<size_t>(
+        q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+}  // namespace
+
+void ResultStream::open_sink() {
+    if (open_) {
+        return;
+    }
+    if (is_endpoint(target_)) {
+        publisher_ = zmq::socket_t(executor_->context(), ZMQ_PUB);
+        publisher_.bind(target_);
+    } else {
+        const std::filesystem::path path(target_);
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path());
+        }
+        file_.open(target_, std::ios::app);
+        if (!file_) {
+            throw std::runtime_error("Cannot open stream file " + target_);
+        }
+    }
+    open_ = true;
+    std::cout << Color::GREEN << "[Stream] " << Color::RESET
+              << "Streaming results to " << target_ << "\n";
+}
+
+void ResultStream::begin(ServerTable* table) {
+    open_sink();
+    table_ = table;
+    job_++;
+    latencies_.clear();
+    completions_ = std::make_unique<Channel<Completion>>();
+    start_ = Clock::now();
+
+    table->add_completion_hook([this](int32_t row) {
+        const auto micros =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - start_).count();
+        completions_->push(Completion{.row = row, .micros = micros});
+    });
+    writer_ = executor_->start(write_loop());
+}
+
+Task ResultStream::write_loop() {
+    Completion done{};
+    bool failed = false;
+    bool unflushed = false;
+    while (true) {
+        const auto status = completions_->try_pop(&done);
+        if (status == Channel<Completion>::PopResult::kClosed) {
+            break;
+        }
+        if (status == Channel<Completion>::PopResult::kEmpty) {
+            // Nothing else pending: hand what we have to the reader now
+            if (unflushed && file_.is_open()) {
+                file_.flush();
+            }
+            unflushed = false;
+            co_await executor_->ready(completions_.get());
+            continue;
+        }
+        // After a failure keep taking completions so the stages never
+        // notice
+        latencies_.push_back(done.micros);
+        if (failed) {
+            continue;
+        }
+        try {
+            emit(done.row, true, done.micros);
+            unflushed = true;
+        } catch (const std::exception& e) {
+            std::cerr << Color::RED << "[Stream] " << e.what()
+                      << Color::RESET << "\n";
+            failed = true;
+        }
+    }
+}
+
+void ResultStream::finish() {
+    if (table_ == nullptr) {
+        return;
+    }
+    completions_->close();
+    writer_.get();
+
+    // The outcome of every other record is final now
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - start_).count();
+    const auto ids = table_->ids();
+    int64_t rejected = 0;
+    try {
+        for (size_t r = 0; r < table_->size(); r++) {
+            const auto row = static_cast<int32_t>(r);
+            if (table_->flags(row) == (RESULT_OPENCL | RESULT_PYTHON) ||
+                table_->row_of(ids[r]) != row) {
+                continue;
+            }
+            emit(row, false, micros);
+            rejected++;
+        }
+        if (file_.is_open()) {
+            file_.flush();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Stream] " << e.what() << Color::RESET
+                  << "\n";
+    }
+
+    // Formatted apart so that the fixed precision stays off std::cout
+    std::ostringstream out;
+    out << Color::GREEN << "[Stream] " << Color::RESET
+        << latencies_.size() << " passed as completed";
+    if (!latencies_.empty()) {
+        std::sort(latencies_.begin(), latencies_.end());
+        out << std::fixed << std::setprecision(1)
+            << ", time to result p50 "
+            << quantile(latencies_, 0.50) / 1000.0 << " ms, p90 "
+            << quantile(latencies_, 0.90) / 1000.0 << " ms, p99 "
+            << quantile(latencies_, 0.99) / 1000.0 << " ms, max "
+            << latencies_.back() / 1000.0 << " ms";
+    }
+    out << "; " << rejected << " rejected at job end\n";
+    std::cout << out.str();
+    table_ = nullptr;
+}
+
+void ResultStream::emit(int32_t row, bool passed, int64_t micros) {
+    const uint8_t flags = table_->flags(row);
+    json record = {
+        {"job", job_},
+        {"id", table_->ids()[row]},
+        {"location", table_->location_name(row)},
+        {"uptime", table_->uptimes()[row]},
+        {"load", table_->loads()[row]},
+        {"passed", passed},
+        {"filter1", (flags & RESULT_OPENCL) != 0},
+        {"filter2", (flags & RESULT_PYTHON) != 0},
+        {"latency_ms", static_cast<double>(micros) / 1000.0}
+    };
+    if (flags & RESULT_OPENCL) {
+        record["reliability"] = table_->reliability(row);
+    }
+    if (flags & RESULT_PYTHON) {
+        record["stability"] = table_->stability(row);
+    }
+    send(record.dump());
+}
+
+void ResultStream::send(const std::string& line) {
+    if (file_.is_open()) {
+        file_ << line << '\n';
+    } else {
+        publisher_.send(zmq::buffer(line), zmq::send_flags::none);
+        stream_socket()->sent(line.size());
+    }
+}
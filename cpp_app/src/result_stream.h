@@ -0,0 +1,83 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_RESULT_STREAM_H_
+#define CPP_APP_SRC_RESULT_STREAM_H_
+
+#include <zmq.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/channel.h"
+#include "src/executor.h"
+#include "src/server_table.h"
+
+/**
+ * Incremental result join (--stream TARGET).
+ * A record is emitted as one JSON line the moment it has passed both
+ * filters, in completion order, with its time to result since the job
+ * started. Records that did not pass both are only known for certain once
+ * every stage has finished, so they follow at the end of the job with the
+ * filters they did pass.
+ *
+ * TARGET is a file (JSON lines, appended and flushed as records arrive)
+ * or a tcp:// / ipc:// endpoint for a ZMQ PUB socket (one record per
+ * message). The sink is opened once and kept for every job (daemon mode).
+ * Records are written by a coroutine on the executor.
+ */
+class ResultStream {
+ public:
+    ResultStream(Executor* executor, std::string target)
+        : executor_(executor), target_(std::move(target)) {}
+
+    ResultStream(const ResultStream&) = delete;
+    ResultStream& operator=(const ResultStream&) = delete;
+
+    bool enabled() const { return !target_.empty(); }
+
+    /**
+     * Start a job: hook into the table before any stage starts and start
+     * the writer.
+     */
+    void begin(ServerTable* table);
+
+    /**
+     * End a job once every stage has finished: emit the records that did
+     * not pass both filters, stop the writer and log the latencies.
+     */
+    void finish();
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Completion {
+        int32_t row;
+        int64_t micros;      // Since begin()
+    };
+
+    Task write_loop();
+    void emit(int32_t row, bool passed, int64_t micros);
+    void send(const std::string& line);
+    void open_sink();
+
+    Executor* executor_;
+    std::string target_;
+    zmq::socket_t publisher_;
+    std::ofstream file_;
+    bool open_ = false;
+
+    ServerTable* table_ = nullptr;
+    Clock::time_point start_;
+    std::unique_ptr<Channel<Completion>> completions_;
+    std::future<void> writer_;
+    std::vector<int64_t> latencies_;   // Passed records, writer only
+    int job_ = 0;
+};
+
+#endif  // CPP_APP_SRC_RESULT_STREAM_H_
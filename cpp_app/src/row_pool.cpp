@@ -0,0 +1,237 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/row_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * Threads of the native pools, kept for later stages and jobs. A pool
+ * borrows one thread per worker and new ones start only when too few are
+ * idle, so a stage never waits for another stage's workers.
+ */
+class WorkerThreads {
+ public:
+    ~WorkerThreads() {
+        for (std::jthread& thread : threads_) {
+            thread.request_stop();
+        }
+        cv_.notify_all();
+    }
+
+    /**
+     * Call work(w) for w in [0, count) on count threads; done counts
+     * down as each call returns or throws. The first exception thrown is
+     * stored in error, which is read once done has reached zero.
+     */
+    void start(int count, std::function<void(int)> work, std::latch* done,
+               std::exception_ptr* error) {
+        auto shared = std::make_shared<std::function<void(int)>>(
+            std::move(work));
+        {
+            std::scoped_lock lock(mutex_);
+            for (int w = 0; w < count; w++) {
+                jobs_.push_back(Job{.work = shared, .worker = w,
+                                    .done = done, .error = error});
+            }
+            const int missing = static_cast<int>(jobs_.size()) - available_;
+            for (int t = 0; t < missing; t++) {
+                threads_.emplace_back(
+                    [this](std::stop_token stop) { serve(stop); });
+                available_++;
+            }
+        }
+        cv_.notify_all();
+    }
+
+ private:
+    struct Job {
+        std::shared_ptr<std::function<void(int)>> work;
+        int worker;
+        std::latch* done;
+        std::exception_ptr* error;  // First exception of the job's calls
+    };
+
+    void serve(std::stop_token stop) {
+        std::unique_lock lock(mutex_);
+        while (cv_.wait(lock, stop, [this] { return !jobs_.empty(); })) {
+            Job job = std::move(jobs_.front());
+            jobs_.pop_front();
+            available_--;
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                (*job.work)(job.worker);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::latch* done = job.done;
+            std::exception_ptr* first = job.error;
+            job = Job{};
+            if (error) {
+                std::scoped_lock first_lock(mutex_);
+                if (!*first) {
+                    *first = std::move(error);
+                }
+            }
+            done->count_down();  // The waiter may free done and first now
+            lock.lock();
+            available_++;
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable_any cv_;
+    std::deque<Job> jobs_;
+    int available_ = 0;           // Threads idle or starting
+    std::vector<std::jthread> threads_;
+};
+
+WorkerThreads& worker_threads() {
+    static WorkerThreads threads;
+    return threads;
+}
+
+/**
+ * Split upstream items into small row tasks for the pool.
+ */
+class TaskSplitter {
+ public:
+    TaskSplitter(const ServerTable& table, int task_rows,
+                 Channel<RowTask>* tasks)
+        : table_(table), task_rows_(task_rows), tasks_(tasks) {}
+
+    void add(const RowRange& range) {
+        for (int32_t row = range.begin; row < range.end; row++) {
+            add_row(row);
+        }
+    }
+
+    void add(const IdBatch& ids) {
+        for (int id : ids) {
+            const int32_t row = table_.row_of(id);
+            if (row != IdIndex::NO_ROW) {
+                add_row(row);
+            }
+        }
+    }
+
+    void flush() {
+        if (!pending_.empty()) {
+            tasks_->push(std::move(pending_));
+            pending_.clear();
+        }
+    }
+
+ private:
+    void add_row(int32_t row) {
+        pending_.push_back(row);
+        if (static_cast<int>(pending_.size()) >= task_rows_) {
+            flush();
+        }
+    }
+
+    const ServerTable& table_;
+    int task_rows_;
+    Channel<RowTask>* tasks_;
+    RowTask pending_;
+};
+
+template <typename T>
+void split_stream(Channel<T>* input, TaskSplitter* splitter) {
+    T item;
+    while (input->pop(&item)) {
+        do {
+            splitter->add(item);
+        } while (input->try_pop(&item) == Channel<T>::PopResult::kItem);
+        // Upstream is momentarily dry: do not hold rows back
+        splitter->flush();
+    }
+}
+
+}  // namespace
+
+int pool_threads(int requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+void run_row_pool(
+    const ServerTable& table,
+    int threads,
+    int task_rows,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    PoolThrottle* throttle,
+    const std::function<void(const RowTask&)>& work) {
+    Channel<RowTask> tasks;
+    auto worker = [&](int w) {
+        RowTask task;
+        while (true) {
+            if (throttle != nullptr) {
+                throttle->wait_turn(w);
+            }
+            if (!tasks.pop(&task)) {
+                break;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            try {
+                work(task);
+            } catch (...) {
+                // The other workers must not wait for this one's turns
+                if (throttle != nullptr) {
+                    throttle->release();
+                }
+                throw;
+            }
+            if (throttle != nullptr) {
+                throttle->task_done(
+                    static_cast<int>(task.size()),
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count());
+            }
+        }
+        // Drained: let the waiting workers see it too
+        if (throttle != nullptr) {
+            throttle->release();
+        }
+    };
+    std::latch done(threads);
+    std::exception_ptr error;
+    worker_threads().start(threads, worker, &done, &error);
+
+    try {
+        TaskSplitter splitter(table, task_rows, &tasks);
+        if (input == nullptr) {
+            split_stream(rows, &splitter);
+        } else {
+            split_stream(input, &splitter);
+        }
+        splitter.flush();
+    } catch (...) {
+        tasks.close();  // Workers finish the queued tasks
+        done.wait();
+        throw;
+    }
+    tasks.close();
+    done.wait();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_ROW_POOL_H_
+#define CPP_APP_SRC_ROW_POOL_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "src/channel.h"
+#include "src/server_table.h"
+#include "src/types.h"
+
+using RowTask = std::vector<int32_t>;
+
+/**
+ * Limits how many workers of a pool take tasks at a time (see
+ * CoreScheduler).
+ */
+class PoolThrottle {
+ public:
+    virtual ~PoolThrottle() = default;
+
+    /**
+     * Block the worker until it may take another task.
+     */
+    virtual void wait_turn(int worker) = 0;
+
+    /**
+     * A task of records was done in busy_ns of the worker's time.
+     */
+    virtual void task_done(int records, int64_t busy_ns) = 0;
+
+    /**
+     * No tasks are left: wake every waiting worker so it can exit.
+     */
+    virtual void release() = 0;
+};
+
+/**
+ * Worker count for a native pool.
+ * @param requested Requested threads (0 = one per core)
+ */
+int pool_threads(int requested);
+
+/**
+ * Run a native filter stage on a thread pool. Upstream items (loader row
+ * ranges, or ids forwarded by a chained filter) are split into tasks of
+ * task_rows table rows; work is called for every task on one of the
+ * workers. Worker threads are kept and reused by later pools. Returns
+ * once upstream has closed and every task is done.
+ * Exceptions from the upstream side, or else the first one thrown by
+ * work, are rethrown after the workers have finished; the other workers
+ * keep taking tasks.
+ *
+ * @param table Server table the rows belong to
+ * @param threads Worker threads
+ * @param task_rows Rows per task
+ * @param rows Row ranges published by the loader (used when input is
+ *             nullptr)
+ * @param input Ids to evaluate, pushed by an upstream stage
+ * @param throttle Limits the workers taking tasks (nullptr = all)
+ * @param work Called concurrently with one task each
+ */
+void run_row_pool(
+    const ServerTable& table,
+    int threads,
+    int task_rows,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    PoolThrottle* throttle,
+    const std::function<void(const RowTask&)>& work);
+
+#endif  // CPP_APP_SRC_ROW_POOL_H_
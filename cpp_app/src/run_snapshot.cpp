@@ -0,0 +1,159 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/run_snapshot.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/utils.h"
+
+std::string snapshot_path(const std::string& output) {
+    return std::filesystem::path(output).replace_extension(".srvsnap")
+        .string();
+}
+
+bool write_run_snapshot(const ServerTable& table,
+                        const ResultSnapshot& results,
+                        const std::vector<uint8_t>& known,
+                        const ScoreParameters& params,
+                        const std::string& engines,
+                        const std::string& filename) {
+    const auto ids = table.ids();
+    const auto location_ids = table.location_ids();
+    std::vector<RunSnapshot::Record> records;
+    records.reserve(results.flags.size());
+    for (size_t r = 0; r < results.flags.size(); r++) {
+        const auto row = static_cast<int32_t>(r);
+        if (table.row_of(ids[r]) != row) {
+            continue;  // Replaced by a later record with the same id
+        }
+        RunSnapshot::Record record{};
+        record.id = ids[r];
+        record.uptime = table.uptimes()[r];
+        record.load = table.loads()[r];
+        record.location_id = location_ids[r];
+        record.flags = results.flags[r];
+        record.reliability = results.reliability[r];
+        record.stability = results.stability[r];
+        record.known = (r < known.size()) ? known[r] : 0;
+        records.push_back(record);
+    }
+
+    const auto& names = table.location_names();
+    std::vector<uint32_t> offsets;
+    offsets.reserve(names.size() + 1);
+    std::string chars;
+    for (const auto& name : names) {
+        offsets.push_back(static_cast<uint32_t>(chars.size()));
+        chars += name;
+    }
+    offsets.push_back(static_cast<uint32_t>(chars.size()));
+
+    RunSnapshot::Header header{};
+    std::memcpy(header.magic, RunSnapshot::MAGIC, sizeof(header.magic));
+    header.version = RunSnapshot::VERSION;
+    header.rows = records.size();
+    header.parameters = score_parameters_hash(params, engines);
+    header.location_count = static_cast<uint32_t>(names.size());
+    header.strings_size = sizeof(uint32_t) * offsets.size() + chars.size();
+
+    const std::filesystem::path path(filename);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    // Replace the previous snapshot only once the new one is complete
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << Color::RED << "[Error] Cannot create: " << temporary
+                      << Color::RESET << "\n";
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(records.data()),
+                  static_cast<std::streamsize>(records.size() *
+                                               sizeof(RunSnapshot::Record)));
+        out.write(reinterpret_cast<const char*>(offsets.data()),
+                  static_cast<std::streamsize>(offsets.size() *
+                                               sizeof(uint32_t)));
+        out.write(chars.data(), static_cast<std::streamsize>(chars.size()));
+        if (!out) {
+            std::cerr << Color::RED << "[Error] Cannot write: " << temporary
+                      << Color::RESET << "\n";
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, filename, ec);
+    if (ec) {
+        std::cerr << Color::RED << "[Error] Cannot replace " << filename
+                  << ": " << ec.message() << Color::RESET << "\n";
+        return false;
+    }
+    std::cout << Color::GREEN << "[Data] " << Color::RESET << "Snapshot of "
+              << records.size() << " servers -> " << filename << "\n";
+    return true;
+}
+
+bool PreviousRun::open(const std::string& filename,
+                       const ScoreParameters& params,
+                       const std::string& engines) {
+    records_ = {};
+    index_.clear();
+    if (!file_.open(filename)) {
+        std::cerr << Color::RED << "[Error] Cannot open: " << filename
+                  << Color::RESET << "\n";
+        return false;
+    }
+    try {
+        RunSnapshot::Header header{};
+        if (file_.size() < sizeof(header)) {
+            throw std::runtime_error("File too small");
+        }
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if (std::memcmp(header.magic, RunSnapshot::MAGIC,
+                        sizeof(header.magic)) != 0 ||
+            header.version != RunSnapshot::VERSION) {
+            throw std::runtime_error("Unsupported format or version");
+        }
+        if (header.parameters != score_parameters_hash(params, engines)) {
+            throw std::runtime_error(
+                "Scored with other parameters, engines or sources");
+        }
+        if (header.rows > (file_.size() - sizeof(header)) /
+                              sizeof(RunSnapshot::Record)) {
+            throw std::runtime_error("Truncated records");
+        }
+
+        records_ = std::span<const RunSnapshot::Record>(
+            reinterpret_cast<const RunSnapshot::Record*>(file_.data() +
+                                                         sizeof(header)),
+            header.rows);
+        index_.reserve(records_.size());
+        for (size_t i = 0; i < records_.size(); i++) {
+            index_[records_[i].id] = static_cast<uint32_t>(i);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Error] Snapshot " << filename << ": "
+                  << e.what() << Color::RESET << "\n";
+        records_ = {};
+        file_.close();
+        return false;
+    }
+
+    std::cout << Color::GREEN << "[Data] " << Color::RESET
+              << "Previous run: " << records_.size() << " servers from "
+              << filename << "\n";
+    return true;
+}
+
+const RunSnapshot::Record* PreviousRun::find(int id) const {
+    const auto it = index_.find(id);
+    return (it == index_.end()) ? nullptr : &records_[it->second];
+}
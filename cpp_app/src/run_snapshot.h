@@ -0,0 +1,114 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_RUN_SNAPSHOT_H_
+#define CPP_APP_SRC_RUN_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/mapped_file.h"
+#include "src/score_params.h"
+#include "src/server_table.h"
+
+/**
+ * Results of a run (.srvsnap), written next to the report so that the
+ * next run can re-score only what changed (--delta).
+ *
+ * A fixed header is followed by one record per reported server (the
+ * ServerResult fields: inputs, both scores and their flags) and the
+ * location strings: offsets[location_count + 1](u32) then the bytes.
+ * Values are host byte order. The header holds score_parameters_hash() of
+ * the run's parameters and engines, the same key as the score cache; a
+ * snapshot scored with other parameters, engines or sources is not used.
+ */
+namespace RunSnapshot {
+
+constexpr char MAGIC[4] = {'S', 'R', 'V', 'S'};
+constexpr uint32_t VERSION = 1;
+
+// Record::known: the filter's outcome is known, passed or not
+constexpr uint8_t KNOWN_RELIABILITY = 0x01;
+constexpr uint8_t KNOWN_STABILITY = 0x02;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t rows;
+    uint64_t parameters;
+    uint32_t location_count;
+    uint32_t reserved;
+    uint64_t strings_size;
+};
+static_assert(sizeof(Header) == 40, "RunSnapshot::Header must be 40 bytes");
+
+struct Record {
+    int32_t id;
+    int32_t uptime;
+    float load;
+    uint32_t location_id;
+    float reliability;       // Valid with RESULT_OPENCL in flags
+    float stability;         // Valid with RESULT_PYTHON in flags
+    uint8_t flags;           // As in ServerTable
+    uint8_t known;
+    uint16_t reserved;
+};
+static_assert(sizeof(Record) == 28, "RunSnapshot::Record must be 28 bytes");
+
+}  // namespace RunSnapshot
+
+/**
+ * Snapshot path for a report, e.g. results/output.txt ->
+ * results/output.srvsnap.
+ */
+std::string snapshot_path(const std::string& output);
+
+/**
+ * Write every reported record (duplicate ids keep their last row).
+ * @param known Per row, RunSnapshot::KNOWN_* of the filters whose outcome
+ *              the run established (ScoreCache::known())
+ * @param params Score parameters the run used
+ * @param engines The run's job_score_engines()
+ * @return true on success, false on failure
+ */
+bool write_run_snapshot(const ServerTable& table,
+                        const ResultSnapshot& results,
+                        const std::vector<uint8_t>& known,
+                        const ScoreParameters& params,
+                        const std::string& engines,
+                        const std::string& filename);
+
+/**
+ * A previous run's snapshot, mapped and indexed by id.
+ */
+class PreviousRun {
+ public:
+    PreviousRun() = default;
+
+    PreviousRun(const PreviousRun&) = delete;
+    PreviousRun& operator=(const PreviousRun&) = delete;
+
+    /**
+     * @return false if the file cannot be read, has another version or
+     *         was scored with other parameters or engines
+     */
+    bool open(const std::string& filename, const ScoreParameters& params,
+              const std::string& engines);
+
+    size_t size() const { return records_.size(); }
+
+    /**
+     * Record of an id, nullptr if the previous run did not have it.
+     */
+    const RunSnapshot::Record* find(int id) const;
+
+ private:
+    MappedFile file_;
+    std::span<const RunSnapshot::Record> records_;
+    std::unordered_map<int, uint32_t> index_;
+};
+
+#endif  // CPP_APP_SRC_RUN_SNAPSHOT_H_
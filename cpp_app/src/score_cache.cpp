@@ -0,0 +1,549 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/score_cache.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/config.h"
+#include "src/metrics.h"
+#include "src/run_snapshot.h"
+#include "src/score_params.h"
+#include "src/utils.h"
+
+namespace {
+
+constexpr char MAGIC[8] = {'L', 'Y', 'S', 'C', 'O', 'R', 'E', '1'};
+
+// Slot kinds: reliability, then stability per id % 10
+constexpr uint32_t KIND_RELIABILITY = 1;
+constexpr uint32_t KIND_STABILITY = 2;
+constexpr uint32_t KIND_MASK = 0xFF;
+constexpr uint32_t PASSED = 0x100;   // Score is valid, else below threshold
+
+// Per row and filter (reliability, stability): sent on to the stage,
+// answered here; table flag; snapshot bit
+constexpr uint8_t SENT[2] = {0x01, 0x02};
+constexpr uint8_t ANSWERED[2] = {0x04, 0x08};
+constexpr uint8_t FLAG[2] = {RESULT_OPENCL, RESULT_PYTHON};
+constexpr uint8_t KNOWN[2] = {RunSnapshot::KNOWN_RELIABILITY,
+                              RunSnapshot::KNOWN_STABILITY};
+
+/**
+ * Stability seed of an id, as compute_stability uses it.
+ */
+uint32_t stability_kind(int id) {
+    return KIND_STABILITY + static_cast<uint32_t>(((id % 10) + 10) % 10);
+}
+
+uint64_t input_key(int uptime, float load) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(uptime)) << 32) |
+           std::bit_cast<uint32_t>(load);
+}
+
+uint64_t mix(uint64_t key, uint32_t kind) {
+    // splitmix64 finalizer
+    uint64_t z = key ^ (static_cast<uint64_t>(kind) * 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+Counter* hit_counter(int filter) {
+    static Counter* const counters[2] = {
+        metrics().counter("lygiagretus_score_cache_hits_total",
+                          "filter=\"reliability\""),
+        metrics().counter("lygiagretus_score_cache_hits_total",
+                          "filter=\"stability\"")
+    };
+    return counters[filter];
+}
+
+Counter* lookup_counter(int filter) {
+    static Counter* const counters[2] = {
+        metrics().counter("lygiagretus_score_cache_lookups_total",
+                          "filter=\"reliability\""),
+        metrics().counter("lygiagretus_score_cache_lookups_total",
+                          "filter=\"stability\"")
+    };
+    return counters[filter];
+}
+
+}  // namespace
+
+struct ScoreCache::Header {
+    char magic[8];
+    uint64_t parameters;
+    uint64_t capacity;   // Slots, a power of two
+    uint64_t count;
+};
+
+struct ScoreCache::Slot {
+    uint64_t key;        // uptime bits << 32 | load bits
+    uint32_t tag;        // Kind | PASSED, 0 = empty
+    float score;
+};
+
+ScoreCache::ScoreCache(bool enabled) {
+    if (enabled && !open_file(Config::SCORE_CACHE_FILE)) {
+        unmap();
+    }
+}
+
+ScoreCache::~ScoreCache() {
+    unmap();
+}
+
+bool ScoreCache::open_file(const std::string& path) {
+    const std::filesystem::path file(path);
+    std::error_code ec;
+    if (file.has_parent_path()) {
+        std::filesystem::create_directories(file.parent_path(), ec);
+    }
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        std::cerr << Color::RED << "[Cache] Cannot open " << path
+                  << Color::RESET << "\n";
+        return false;
+    }
+    if (::flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+        std::cout << Color::CYAN << "[Cache] " << Color::RESET << path
+                  << " is in use by another process, running without it\n";
+        return false;
+    }
+
+    // Keep the entries only if they were computed the same way
+    struct stat st {};
+    Header header{};
+    bool valid = ::fstat(fd_, &st) == 0 &&
+                 static_cast<size_t>(st.st_size) >= sizeof(Header) &&
+                 ::pread(fd_, &header, sizeof(header), 0) ==
+                     static_cast<ssize_t>(sizeof(header));
+    // (the parameters they were computed with are checked per job)
+    valid = valid && std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+            std::has_single_bit(header.capacity) &&
+            static_cast<size_t>(st.st_size) ==
+                sizeof(Header) + header.capacity * sizeof(Slot);
+    if (!valid && st.st_size > 0) {
+        std::cout << Color::CYAN << "[Cache] " << Color::RESET
+                  << "Unknown layout, clearing " << path << "\n";
+    }
+    parameters_ = valid ? header.parameters : 0;
+    if (!map(valid ? header.capacity : Config::SCORE_CACHE_INITIAL_SLOTS,
+             !valid)) {
+        std::cerr << Color::RED << "[Cache] Cannot map " << path
+                  << Color::RESET << "\n";
+        return false;
+    }
+    std::cout << Color::CYAN << "[Cache] " << Color::RESET
+              << header_->count << " scores in " << path << "\n";
+    return true;
+}
+
+bool ScoreCache::map(size_t capacity, bool clear) {
+    if (header_ != nullptr) {
+        ::munmap(header_, mapped_bytes_);
+        header_ = nullptr;
+        slots_ = nullptr;
+    }
+    const size_t bytes = sizeof(Header) + capacity * sizeof(Slot);
+    if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+        return false;
+    }
+    void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd_, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    // Probes land anywhere in the table
+    ::madvise(addr, bytes, MADV_RANDOM);
+
+    mapped_bytes_ = bytes;
+    header_ = static_cast<Header*>(addr);
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(addr) +
+                                     sizeof(Header));
+    if (clear) {
+        std::memset(addr, 0, bytes);
+        std::memcpy(header_->magic, MAGIC, sizeof(MAGIC));
+        header_->parameters = parameters_;
+        header_->capacity = capacity;
+        header_->count = 0;
+    }
+    return true;
+}
+
+void ScoreCache::unmap() {
+    if (header_ != nullptr) {
+        ::munmap(header_, mapped_bytes_);
+        header_ = nullptr;
+        slots_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);  // Releases the lock
+        fd_ = -1;
+    }
+}
+
+bool ScoreCache::grow() {
+    const size_t capacity = header_->capacity;
+    std::vector<Slot> entries;
+    entries.reserve(header_->count);
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots_[i].tag != 0) {
+            entries.push_back(slots_[i]);
+        }
+    }
+    if (!map(capacity * 2, true)) {
+        std::cerr << Color::RED << "[Cache] Cannot grow the score table"
+                  << Color::RESET << "\n";
+        unmap();
+        return false;
+    }
+    for (const Slot& slot : entries) {
+        insert(slot.key, slot.tag & KIND_MASK, (slot.tag & PASSED) != 0,
+               slot.score);
+    }
+    return true;
+}
+
+const ScoreCache::Slot* ScoreCache::find(uint64_t key, uint32_t kind) const {
+    if (!memo_) {
+        return nullptr;
+    }
+    const size_t mask = header_->capacity - 1;
+    for (size_t i = mix(key, kind) & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (slot.tag == 0) {
+            return nullptr;
+        }
+        if (slot.key == key && (slot.tag & KIND_MASK) == kind) {
+            return &slot;
+        }
+    }
+}
+
+bool ScoreCache::insert(uint64_t key, uint32_t kind, bool passed,
+                        float score) {
+    if (!memo_ || !enabled()) {
+        return false;
+    }
+    // Keep probes short: at most 70 % full
+    if ((header_->count + 1) * 10 > header_->capacity * 7) {
+        if (header_->capacity * 7 / 10 >= Config::SCORE_CACHE_MAX_ENTRIES) {
+            if (!full_) {
+                full_ = true;
+                std::cout << Color::CYAN << "[Cache] " << Color::RESET
+                          << "Full at " << header_->count
+                          << " scores, new ones are not kept\n";
+            }
+            return false;
+        }
+        if (!grow()) {
+            return false;
+        }
+    }
+
+    const size_t mask = header_->capacity - 1;
+    for (size_t i = mix(key, kind) & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots_[i];
+        if (slot.tag == 0) {
+            header_->count++;
+        } else if (slot.key != key || (slot.tag & KIND_MASK) != kind) {
+            continue;
+        }
+        slot.key = key;
+        slot.tag = kind | (passed ? PASSED : 0);
+        slot.score = passed ? score : 0.0f;
+        return true;
+    }
+}
+
+void ScoreCache::begin(const ServerTable* table, const CacheRoutes& routes,
+                       const PreviousRun* previous,
+                       const ScoreParameters& params,
+                       const std::string& engines) {
+    routes_ = routes;
+    previous_ = previous;
+    // The file holds full-precision scores only
+    memo_ = enabled() && params == ScoreParameters{};
+    if (enabled() && !memo_) {
+        std::cout << Color::CYAN << "[Cache] " << Color::RESET
+                  << "Not used at " << score_preset_name(params)
+                  << " precision\n";
+    }
+    const uint64_t parameters = score_parameters_hash(params, engines);
+    if (memo_ && header_->parameters != parameters) {
+        // Computed by other engines, sources or build options
+        if (header_->count > 0) {
+            std::cout << Color::CYAN << "[Cache] " << Color::RESET
+                      << "Score engines or sources changed (" << engines
+                      << "), clearing " << header_->count << " scores\n";
+        }
+        std::memset(slots_, 0, header_->capacity * sizeof(Slot));
+        header_->count = 0;
+        header_->parameters = parameters;
+        parameters_ = parameters;
+    }
+    stage_errors_ = stage_errors()->value.load();
+    rows_.clear();
+    rows_.reserve(table->capacity());
+    known_.clear();
+    for (int f = 0; f < 2; f++) {
+        hits_[f] = 0;
+        carried_[f] = 0;
+        lookups_[f] = 0;
+    }
+}
+
+void ScoreCache::lookup(ServerTable* table, Channel<RowRange>* loaded) {
+    TraceScope scope("loader", "score cache");
+    Channel<RowRange>* targets[2] = {routes_.reliability_rows,
+                                     routes_.stability_rows};
+
+    RowRange range{};
+    while (loaded->pop(&range)) {
+        if (rows_.size() < static_cast<size_t>(range.end)) {
+            rows_.resize(range.end, 0);
+        }
+        IdBatch reliability_ids;
+        IdBatch stability_ids;
+        int32_t run[2] = {-1, -1};   // Start of the current run of misses
+        for (int32_t row = range.begin; row < range.end; row++) {
+            answer(table, row, &reliability_ids, &stability_ids);
+            for (int f = 0; f < 2; f++) {
+                if (targets[f] == nullptr) {
+                    continue;
+                }
+                const bool miss = (rows_[row] & SENT[f]) != 0;
+                if (miss && run[f] < 0) {
+                    run[f] = row;
+                } else if (!miss && run[f] >= 0) {
+                    targets[f]->push(RowRange{run[f], row});
+                    run[f] = -1;
+                }
+            }
+        }
+        for (int f = 0; f < 2; f++) {
+            if (targets[f] != nullptr && run[f] >= 0) {
+                targets[f]->push(RowRange{run[f], range.end});
+            }
+        }
+
+        // Hits chained on to the other filter, before its input closes
+        if (!reliability_ids.empty()) {
+            routes_.reliability_passed->push(std::move(reliability_ids));
+        }
+        if (!stability_ids.empty()) {
+            routes_.stability_passed->push(std::move(stability_ids));
+        }
+    }
+
+    for (Channel<RowRange>* target : targets) {
+        if (target != nullptr) {
+            target->close();
+        }
+    }
+}
+
+ScoreCache::Answer ScoreCache::recall(const RunSnapshot::Record* record,
+                                      int filter, uint64_t key,
+                                      uint32_t kind) const {
+    Answer answer;
+    if (record != nullptr && (record->known & KNOWN[filter]) != 0) {
+        answer.known = true;
+        answer.carried = true;
+        answer.passed = (record->flags & FLAG[filter]) != 0;
+        answer.score = (filter == 0) ? record->reliability
+                                     : record->stability;
+    } else if (const Slot* slot = find(key, kind)) {
+        answer.known = true;
+        answer.passed = (slot->tag & PASSED) != 0;
+        answer.score = slot->score;
+    }
+    return answer;
+}
+
+void ScoreCache::answer(ServerTable* table, int32_t row,
+                        IdBatch* reliability_ids, IdBatch* stability_ids) {
+    const int id = table->ids()[row];
+    const int uptime = table->uptimes()[row];
+    const float load = table->loads()[row];
+    const uint64_t key = input_key(uptime, load);
+
+    // A previous run's outcome holds while the inputs are the same
+    const RunSnapshot::Record* record =
+        (previous_ != nullptr) ? previous_->find(id) : nullptr;
+    if (record != nullptr && input_key(record->uptime, record->load) != key) {
+        record = nullptr;
+    }
+    const Answer answers[2] = {
+        recall(record, 0, key, KIND_RELIABILITY),
+        recall(record, 1, key, stability_kind(id))
+    };
+
+    uint8_t& state = rows_[row];
+    auto use = [&](int f) {
+        lookups_[f]++;
+        if (!answers[f].known) {
+            return false;
+        }
+        state |= ANSWERED[f];
+        (answers[f].carried ? carried_[f] : hits_[f])++;
+        return true;
+    };
+    auto publish = [&](int f) {
+        if (f == 0) {
+            table->set_reliability(row, answers[f].score);
+        } else {
+            table->set_stability(row, answers[f].score);
+        }
+    };
+
+    if (routes_.fused) {
+        // One pass computes both, so both must be known
+        if (!answers[0].known || !answers[1].known) {
+            lookups_[0]++;
+            lookups_[1]++;
+            state |= SENT[0] | SENT[1];
+            return;
+        }
+        use(0);
+        use(1);
+        if (answers[0].passed && answers[1].passed) {
+            publish(0);
+            publish(1);
+        } else {
+            table->count_single_passes(answers[0].passed ? 1 : 0,
+                                       answers[1].passed ? 1 : 0);
+        }
+        return;
+    }
+
+    // The filter that runs first (both run first in parallel mode)
+    const bool first[2] = {routes_.reliability_rows != nullptr,
+                           routes_.stability_rows != nullptr};
+    IdBatch* chained[2] = {reliability_ids, stability_ids};
+    for (int f = 0; f < 2; f++) {
+        if (!first[f]) {
+            continue;
+        }
+        if (!use(f)) {
+            state |= SENT[f];
+            continue;
+        }
+        if (!answers[f].passed) {
+            continue;
+        }
+        publish(f);
+
+        // Chained: the other filter only sees records passing this one
+        const int other = 1 - f;
+        if (first[other]) {
+            continue;
+        }
+        if (!use(other)) {
+            state |= SENT[other];
+            chained[f]->push_back(id);
+        } else if (answers[other].passed) {
+            publish(other);
+        }
+    }
+}
+
+void ScoreCache::finish(const ServerTable& table) {
+    // Unflagged rows only failed if no stage lost records on the way
+    const bool complete = stage_errors()->value.load() == stage_errors_;
+    const bool first[2] = {routes_.reliability_rows != nullptr,
+                           routes_.stability_rows != nullptr};
+
+    const uint64_t before = memo_ ? header_->count : 0;
+    const size_t rows = std::min(rows_.size(), table.size());
+    known_.assign(table.size(), 0);
+    const auto ids = table.ids();
+    for (size_t r = 0; r < rows; r++) {
+        const uint8_t state = rows_[r];
+        const auto row = static_cast<int32_t>(r);
+        const uint8_t flags = table.flags(row);
+        const uint64_t key = input_key(table.uptimes()[r], table.loads()[r]);
+        const uint32_t kinds[2] = {KIND_RELIABILITY, stability_kind(ids[r])};
+        const float scores[2] = {table.reliability(row),
+                                 table.stability(row)};
+        uint8_t known = 0;
+        for (int f = 0; f < 2; f++) {
+            if (state & ANSWERED[f]) {
+                known |= KNOWN[f];
+            }
+        }
+
+        if (routes_.fused) {
+            // Only records passing both are read back
+            if ((state & SENT[0]) &&
+                flags == (RESULT_OPENCL | RESULT_PYTHON)) {
+                insert(key, kinds[0], true, scores[0]);
+                insert(key, kinds[1], true, scores[1]);
+                known = KNOWN[0] | KNOWN[1];
+            }
+            known_[r] = known;
+            continue;
+        }
+        for (int f = 0; f < 2; f++) {
+            const int other = 1 - f;
+            // A chained filter evaluates the rows of the ids passed on
+            const bool evaluated =
+                first[f] ? (state & SENT[f]) != 0
+                         : (flags & FLAG[other]) != 0 &&
+                               table.row_of(ids[r]) == row &&
+                               (state & (SENT[f] | SENT[other])) != 0;
+            if (!evaluated) {
+                continue;
+            }
+            if ((flags & FLAG[f]) != 0) {
+                insert(key, kinds[f], true, scores[f]);
+                known |= KNOWN[f];
+            } else if (complete) {
+                insert(key, kinds[f], false, 0.0f);
+                known |= KNOWN[f];
+            }
+        }
+        known_[r] = known;
+    }
+
+    for (int f = 0; f < 2; f++) {
+        hit_counter(f)->add(hits_[f]);
+        lookup_counter(f)->add(lookups_[f]);
+    }
+    if (!memo_ && previous_ == nullptr) {
+        return;
+    }
+    std::cout << Color::CYAN << "[Cache] " << Color::RESET;
+    const char* names[2] = {"Reliability", "stability"};
+    for (int f = 0; f < 2; f++) {
+        std::cout << (f == 0 ? "" : "; ") << names[f] << " " << hits_[f]
+                  << " cached";
+        if (previous_ != nullptr) {
+            std::cout << ", " << carried_[f] << " carried";
+        }
+        std::cout << " of " << lookups_[f];
+    }
+    if (memo_ && enabled()) {
+        std::cout << "; " << header_->count - before << " new, "
+                  << header_->count << " scores";
+    }
+    std::cout << "\n";
+    if (!complete) {
+        std::cout << Color::CYAN << "[Cache] " << Color::RESET
+                  << "A stage failed; only passing scores were kept\n";
+    }
+}
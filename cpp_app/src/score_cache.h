@@ -0,0 +1,146 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_SCORE_CACHE_H_
+#define CPP_APP_SRC_SCORE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "src/channel.h"
+#include "src/score_params.h"
+#include "src/server_table.h"
+#include "src/types.h"
+
+class PreviousRun;
+namespace RunSnapshot {
+struct Record;
+}
+
+/**
+ * Where the cache forwards the rows it could not answer, by pipeline mode.
+ * A filter that runs first reads row ranges; the one chained after it
+ * reads the ids that passed the first (see run_pipeline).
+ */
+struct CacheRoutes {
+    Channel<RowRange>* reliability_rows;  // Filter 1 input (nullptr = chained)
+    Channel<RowRange>* stability_rows;    // Filter 2 input (nullptr = chained)
+    Channel<IdBatch>* reliability_passed; // Filter 1 -> 2 (opencl-first)
+    Channel<IdBatch>* stability_passed;   // Filter 2 -> 1 (python-first)
+    bool fused;                           // Both filters in one OpenCL pass
+};
+
+/**
+ * Persistent memo of both scores (--no-score-cache turns it off).
+ * Scores are pure functions of a record's inputs: reliability of
+ * (uptime, load), stability of (uptime, load, id % 10). Entries are keyed
+ * on their exact bit patterns and stored in an open-addressing hash table
+ * in a memory-mapped file (Config::SCORE_CACHE_FILE) that survives between
+ * runs. The header holds score_parameters_hash() of the parameters and
+ * the job's engines and their sources (job_score_engines()): a job with
+ * another hash clears the file before it is used.
+ * Only full-precision scores are kept; jobs at other parameters (e.g.
+ * --precision quick) skip the memo.
+ *
+ * Only pass/fail is kept for records below a threshold, like the table.
+ * The file is locked for the process's lifetime; a second process runs
+ * without the cache.
+ *
+ * With a previous run (--delta), records whose id is in its snapshot with
+ * the same inputs carry that run's outcome forward before the memo is
+ * asked. Either way the cache tracks which outcomes each job established,
+ * for the next snapshot (known()).
+ */
+class ScoreCache {
+ public:
+    explicit ScoreCache(bool enabled);
+    ~ScoreCache();
+
+    ScoreCache(const ScoreCache&) = delete;
+    ScoreCache& operator=(const ScoreCache&) = delete;
+
+    /**
+     * The memo file is open (lookups without it only carry a previous run
+     * forward).
+     */
+    bool enabled() const { return slots_ != nullptr; }
+
+    /**
+     * Start a job (before any stage starts).
+     * @param previous Outcomes to carry forward by id (nullptr = none),
+     *                 kept until finish()
+     * @param params The job's score parameters
+     * @param engines The job's job_score_engines()
+     */
+    void begin(const ServerTable* table, const CacheRoutes& routes,
+               const PreviousRun* previous, const ScoreParameters& params,
+               const std::string& engines);
+
+    /**
+     * Answer the loaded rows from the cache: hits are published to the
+     * table (and chained on to the other filter), misses are forwarded
+     * to the filter stages as row ranges. Closes the forwarded row
+     * channels when loaded is closed, like a loader.
+     */
+    void lookup(ServerTable* table, Channel<RowRange>* loaded);
+
+    /**
+     * End a job once every stage has finished: add the scores computed
+     * for the misses and log the hit rates.
+     */
+    void finish(const ServerTable& table);
+
+    /**
+     * Per row of the last job, RunSnapshot::KNOWN_* of the filters whose
+     * outcome it established (computed, cached or carried forward).
+     */
+    const std::vector<uint8_t>& known() const { return known_; }
+
+ private:
+    struct Header;
+    struct Slot;
+
+    /**
+     * Outcome of one filter for a record, if known.
+     */
+    struct Answer {
+        bool known = false;
+        bool carried = false;    // From the previous run, else the memo
+        bool passed = false;
+        float score = 0.0f;
+    };
+
+    bool open_file(const std::string& path);
+    bool map(size_t capacity, bool clear);
+    void unmap();
+    bool grow();
+
+    const Slot* find(uint64_t key, uint32_t kind) const;
+    bool insert(uint64_t key, uint32_t kind, bool passed, float score);
+
+    Answer recall(const RunSnapshot::Record* record, int filter,
+                  uint64_t key, uint32_t kind) const;
+    void answer(ServerTable* table, int32_t row, IdBatch* reliability_ids,
+                IdBatch* stability_ids);
+
+    int fd_ = -1;
+    Header* header_ = nullptr;
+    Slot* slots_ = nullptr;
+    size_t mapped_bytes_ = 0;
+    uint64_t parameters_ = 0;      // Header hash of the entries
+    bool full_ = false;            // At SCORE_CACHE_MAX_ENTRIES, logged once
+
+    // Current job
+    CacheRoutes routes_{};
+    const PreviousRun* previous_ = nullptr;
+    bool memo_ = false;            // The memo answers this job
+    int64_t stage_errors_ = 0;     // stage_errors() at begin()
+    std::vector<uint8_t> rows_;    // Per row: filters sent on or answered
+    std::vector<uint8_t> known_;   // Per row, after finish()
+    int64_t hits_[2] = {0, 0};
+    int64_t carried_[2] = {0, 0};
+    int64_t lookups_[2] = {0, 0};
+};
+
+#endif  // CPP_APP_SRC_SCORE_CACHE_H_
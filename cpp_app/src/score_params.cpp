@@ -0,0 +1,82 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/score_params.h"
+
+#include <sstream>
+#include <string>
+
+#include "src/config.h"
+
+static_assert(Config::EXIT_CHECK_ITERATIONS % Config::KERNEL_UNROLL == 0,
+              "Early-exit checks must fall between unrolled blocks");
+
+namespace {
+
+int unroll_for(int iterations) {
+    return (iterations % Config::KERNEL_UNROLL == 0) ? Config::KERNEL_UNROLL
+                                                     : 1;
+}
+
+}  // namespace
+
+bool score_preset(const std::string& name, ScoreParameters* out) {
+    // Early exit is set on its own
+    ScoreParameters preset;
+    if (name == "quick") {
+        preset.reliability_iterations = Config::QUICK_RELIABILITY_ITERATIONS;
+        preset.stability_iterations = Config::QUICK_STABILITY_ITERATIONS;
+    } else if (name != "full") {
+        return false;
+    }
+    preset.reliability_exit_checks = out->reliability_exit_checks;
+    preset.stability_exit_checks = out->stability_exit_checks;
+    *out = preset;
+    return true;
+}
+
+const char* score_preset_name(const ScoreParameters& params) {
+    if (params.reliability_exit_checks > 0 ||
+        params.stability_exit_checks > 0) {
+        return "approximate";
+    }
+    for (const char* name : {"full", "quick"}) {
+        ScoreParameters preset;
+        score_preset(name, &preset);
+        if (params == preset) {
+            return name;
+        }
+    }
+    return "custom";
+}
+
+std::string kernel_defines(const ScoreParameters& params) {
+    // Hex literals carry the thresholds' exact bits
+    std::ostringstream text;
+    text << std::hexfloat
+         << " -DITERATIONS=" << params.reliability_iterations
+         << " -DUNROLL=" << unroll_for(params.reliability_iterations)
+         << " -DTHRESHOLD=" << params.reliability_threshold << "f"
+         << " -DSTABILITY_ITERATIONS=" << params.stability_iterations
+         << " -DSTABILITY_UNROLL=" << unroll_for(params.stability_iterations)
+         << " -DSTABILITY_THRESHOLD=" << params.stability_threshold;
+    // Exact builds keep the options (and cached binaries) they had
+    if (params.reliability_exit_checks > 0 ||
+        params.stability_exit_checks > 0) {
+        text << " -DEXIT_CHECK=" << Config::EXIT_CHECK_ITERATIONS
+             << " -DEXIT_CHECKS=" << params.reliability_exit_checks
+             << " -DSTABILITY_EXIT_CHECKS=" << params.stability_exit_checks;
+    }
+    return text.str();
+}
+
+uint64_t score_parameters_hash(const ScoreParameters& params,
+                               const std::string& engines) {
+    const std::string text = Config::OPENCL_BUILD_OPTIONS +
+                             kernel_defines(params) + '\n' + engines;
+    uint64_t hash = 14695981039346656037ULL;  // FNV-1a
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,62 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_SCORE_PARAMS_H_
+#define CPP_APP_SRC_SCORE_PARAMS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "src/utils.h"
+
+/**
+ * Iteration counts and thresholds of both filters for a job. The one
+ * place they are set: the kernels get them as -D build options, the
+ * native engines as template arguments for the preset counts.
+ *
+ * Early exit (approximate, off by default): every
+ * Config::EXIT_CHECK_ITERATIONS iterations the recurrence checks the
+ * range its state covered since the last check. Once the state stayed on
+ * one side of the threshold for *_exit_checks checks in a row, the loop
+ * stops with that decision and the current state as the score. A larger
+ * count is the stricter confidence.
+ */
+struct ScoreParameters {
+    int reliability_iterations = Constants::RELIABILITY_ITERATIONS;
+    float reliability_threshold = Constants::RELIABILITY_THRESHOLD;
+    int stability_iterations = Constants::STABILITY_ITERATIONS;
+    double stability_threshold = Constants::STABILITY_THRESHOLD;
+    int reliability_exit_checks = 0;   // 0 = exact
+    int stability_exit_checks = 0;     // 0 = exact
+
+    bool operator==(const ScoreParameters&) const = default;
+};
+
+/**
+ * Parameters of a named preset: "full" (the defaults) or "quick"
+ * (Config::QUICK_*_ITERATIONS, for cheap health checks). The early exit
+ * settings of out are kept.
+ * @return false if the name is unknown
+ */
+bool score_preset(const std::string& name, ScoreParameters* out);
+
+/**
+ * Preset name of a parameter set: "approximate" with early exit, else
+ * "custom" if it matches none.
+ */
+const char* score_preset_name(const ScoreParameters& params);
+
+/**
+ * -D build options specializing kernels.cl for a parameter set, with the
+ * inner loops unrolled by Config::KERNEL_UNROLL where the counts allow.
+ */
+std::string kernel_defines(const ScoreParameters& params);
+
+/**
+ * Hash of everything a score depends on besides the record: iteration
+ * counts, thresholds, kernel build options and the engines with their
+ * sources (job_score_engines()).
+ */
+uint64_t score_parameters_hash(const ScoreParameters& params,
+                               const std::string& engines);
+
+#endif  // CPP_APP_SRC_SCORE_PARAMS_H_
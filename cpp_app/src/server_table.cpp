@@ -0,0 +1,303 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/server_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+float load(const std::vector<float>& column, int32_t row) {
+    return std::atomic_ref<float>(const_cast<float&>(column[row]))
+        .load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+void IdIndex::reserve(size_t rows) {
+    if (dense_ || rows * 2 > rows_.size()) {
+        rehash(rows);
+    }
+}
+
+void IdIndex::reserve(size_t rows, int min_id, int max_id) {
+    const auto spread = static_cast<size_t>(
+        static_cast<int64_t>(max_id) - min_id + 1);
+    if (used_ > 0 || rows == 0 || min_id > max_id ||
+        spread > DENSE_SPREAD * rows) {
+        reserve(rows);
+        return;
+    }
+    dense_ = true;
+    base_ = min_id;
+    keys_.clear();
+    rows_.assign(spread, NO_ROW);
+}
+
+size_t IdIndex::slot_of(int id) const {
+    // Fibonacci hashing: the top bits of the product pick the slot
+    const uint64_t key = static_cast<uint32_t>(id);
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+}
+
+void IdIndex::rehash(size_t rows) {
+    std::vector<std::pair<int, int32_t>> entries;
+    entries.reserve(used_);
+    for (size_t i = 0; i < rows_.size(); i++) {
+        if (rows_[i] != NO_ROW) {
+            entries.emplace_back(dense_ ? static_cast<int>(base_ + i)
+                                        : keys_[i],
+                                 rows_[i]);
+        }
+    }
+
+    size_t slots = MIN_SLOTS;
+    shift_ = 64 - std::countr_zero(slots);
+    while (slots < std::max(rows, entries.size()) * 2) {
+        slots *= 2;
+        shift_--;
+    }
+    dense_ = false;
+    used_ = 0;
+    rows_.assign(slots, NO_ROW);
+    keys_.assign(slots, 0);
+    for (const auto& [id, row] : entries) {
+        set(id, row);
+    }
+}
+
+void IdIndex::set(int id, int32_t row) {
+    if (dense_) {
+        const int64_t offset = static_cast<int64_t>(id) - base_;
+        if (offset >= 0 && offset < static_cast<int64_t>(rows_.size())) {
+            std::atomic_ref<int32_t>(rows_[offset])
+                .store(row, std::memory_order_release);
+            return;
+        }
+        // Outside the reserved range: move everything to the hash table
+        rehash(0);
+    }
+    if ((used_ + 1) * 2 > rows_.size()) {
+        rehash(std::max(MIN_SLOTS, rows_.size()));
+    }
+
+    const size_t mask = rows_.size() - 1;
+    for (size_t slot = slot_of(id);; slot = (slot + 1) & mask) {
+        // Only this thread writes, plain reads see its own stores
+        if (rows_[slot] == NO_ROW) {
+            // The key is published by the release store of the row
+            std::atomic_ref<int32_t>(keys_[slot])
+                .store(id, std::memory_order_relaxed);
+            std::atomic_ref<int32_t>(rows_[slot])
+                .store(row, std::memory_order_release);
+            used_++;
+            return;
+        }
+        if (keys_[slot] == id) {
+            std::atomic_ref<int32_t>(rows_[slot])
+                .store(row, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+int32_t IdIndex::find(int id) const {
+    auto load = [](const int32_t& value, std::memory_order order) {
+        return std::atomic_ref<int32_t>(const_cast<int32_t&>(value))
+            .load(order);
+    };
+    if (dense_) {
+        const int64_t offset = static_cast<int64_t>(id) - base_;
+        if (offset < 0 || offset >= static_cast<int64_t>(rows_.size())) {
+            return NO_ROW;
+        }
+        return load(rows_[offset], std::memory_order_acquire);
+    }
+    if (rows_.empty()) {
+        return NO_ROW;
+    }
+
+    const size_t mask = rows_.size() - 1;
+    for (size_t slot = slot_of(id);; slot = (slot + 1) & mask) {
+        const int32_t row = load(rows_[slot], std::memory_order_acquire);
+        if (row == NO_ROW) {
+            return NO_ROW;
+        }
+        if (load(keys_[slot], std::memory_order_relaxed) == id) {
+            return row;
+        }
+    }
+}
+
+int32_t ServerTable::add(int id, std::string_view location, int uptime,
+                         float load) {
+    const auto row = static_cast<int32_t>(ids_.size());
+
+    uint32_t location_id = 0;
+    auto it = location_lookup_.find(location);
+    if (it != location_lookup_.end()) {
+        location_id = it->second;
+    } else {
+        location_id = static_cast<uint32_t>(location_names_.size());
+        {
+            std::unique_lock lock(location_mutex_);
+            location_names_.emplace_back(location);
+        }
+        location_lookup_.emplace(location_names_.back(), location_id);
+    }
+
+    ids_.push_back(id);
+    uptimes_.push_back(uptime);
+    loads_.push_back(load);
+    location_ids_.push_back(location_id);
+    reliability_.push_back(0.0f);
+    stability_.push_back(0.0f);
+    flags_.push_back(0);
+
+    index_row(id, row);
+    rows_.store(ids_.size(), std::memory_order_release);
+    return row;
+}
+
+void ServerTable::reserve(size_t rows) {
+    ids_.reserve(rows);
+    uptimes_.reserve(rows);
+    loads_.reserve(rows);
+    location_ids_.reserve(rows);
+    reliability_.reserve(rows);
+    stability_.reserve(rows);
+    flags_.reserve(rows);
+    index_.reserve(rows);
+}
+
+uint8_t ServerTable::flags(int32_t row) const {
+    return std::atomic_ref<uint8_t>(const_cast<uint8_t&>(flags_[row]))
+        .load(std::memory_order_acquire);
+}
+
+std::string ServerTable::location_name(int32_t row) const {
+    std::shared_lock lock(location_mutex_);
+    return location_names_[location_ids()[row]];
+}
+
+float ServerTable::reliability(int32_t row) const {
+    return load(reliability_, row);
+}
+
+float ServerTable::stability(int32_t row) const {
+    return load(stability_, row);
+}
+
+void ServerTable::attach(std::shared_ptr<const void> backing,
+                         std::span<const int> ids,
+                         std::span<const int> uptimes,
+                         std::span<const float> loads,
+                         std::span<const uint32_t> location_ids,
+                         std::vector<std::string> location_names) {
+    backing_ = std::move(backing);
+    external_ = ExternalColumns{
+        .ids = ids,
+        .uptimes = uptimes,
+        .loads = loads,
+        .location_ids = location_ids
+    };
+    location_names_ = std::move(location_names);
+
+    const size_t rows = ids.size();
+    if (rows > 0) {
+        const auto [min_id, max_id] = std::minmax_element(ids.begin(),
+                                                          ids.end());
+        index_.reserve(rows, *min_id, *max_id);
+    }
+    reliability_.assign(rows, 0.0f);
+    stability_.assign(rows, 0.0f);
+    flags_.assign(rows, 0);
+    for (size_t row = 0; row < rows; row++) {
+        index_row(ids[row], static_cast<int32_t>(row));
+    }
+    rows_.store(rows, std::memory_order_release);
+}
+
+void ServerTable::index_row(int id, int32_t row) {
+    const int32_t previous = index_.find(id);
+    if (previous != IdIndex::NO_ROW) {
+        shadowed_.push_back(previous);
+    }
+    index_.set(id, row);
+}
+
+// Values go through atomic_ref as well: duplicate ids map to one row, so
+// two batches may write the same cell.
+void ServerTable::publish(std::vector<float>* column, int32_t row,
+                          float value, uint8_t flag,
+                          std::atomic<int64_t>* counter) {
+    std::atomic_ref<float>((*column)[row]).store(value,
+                                                 std::memory_order_relaxed);
+    const uint8_t previous = std::atomic_ref<uint8_t>(flags_[row]).fetch_or(
+        flag, std::memory_order_release);
+    if (previous & flag) {
+        return;  // Row already counted for this filter
+    }
+    counter->fetch_add(1, std::memory_order_relaxed);
+    if (previous != 0) {
+        // The other filter got there first: exactly one writer sees this
+        both_passed_.fetch_add(1, std::memory_order_relaxed);
+        for (const auto& hook : on_both_) {
+            hook(row);
+        }
+    }
+}
+
+void ServerTable::set_reliability(int32_t row, float value) {
+    publish(&reliability_, row, value, RESULT_OPENCL, &opencl_passed_);
+}
+
+void ServerTable::set_stability(int32_t row, float value) {
+    publish(&stability_, row, value, RESULT_PYTHON, &python_passed_);
+}
+
+void ServerTable::count_single_passes(int64_t opencl, int64_t python) {
+    opencl_passed_.fetch_add(opencl, std::memory_order_relaxed);
+    python_passed_.fetch_add(python, std::memory_order_relaxed);
+}
+
+ResultSnapshot ServerTable::snapshot() const {
+    const size_t rows = size();
+    ResultSnapshot snap;
+    snap.counts = ResultCounts{
+        .opencl = opencl_passed_.load(std::memory_order_relaxed),
+        .python = python_passed_.load(std::memory_order_relaxed),
+        .both = both_passed_.load(std::memory_order_relaxed)
+    };
+    snap.flags.resize(rows);
+    snap.reliability.assign(rows, 0.0f);
+    snap.stability.assign(rows, 0.0f);
+    for (size_t row = 0; row < rows; row++) {
+        const auto r = static_cast<int32_t>(row);
+        const uint8_t f = flags(r);
+        snap.flags[row] = f;
+        // Values are read after the acquire load of their flag
+        if (f & RESULT_OPENCL) {
+            snap.reliability[row] = load(reliability_, r);
+        }
+        if (f & RESULT_PYTHON) {
+            snap.stability[row] = load(stability_, r);
+        }
+    }
+
+    // Counts cover every row; drop the ones shadowed by a duplicate id
+    for (int32_t row : shadowed_) {
+        const uint8_t f = snap.flags[row];
+        snap.counts.opencl -= (f & RESULT_OPENCL) ? 1 : 0;
+        snap.counts.python -= (f & RESULT_PYTHON) ? 1 : 0;
+        snap.counts.both -= (f == (RESULT_OPENCL | RESULT_PYTHON)) ? 1 : 0;
+    }
+    return snap;
+}
@@ -0,0 +1,294 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_SERVER_TABLE_H_
+#define CPP_APP_SRC_SERVER_TABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * id -> row index, sized by the row count rather than the id values.
+ * When the ids are known up front and [min_id, max_id] spans at most
+ * DENSE_SPREAD times the row count, it is one array over that range (a
+ * single read per lookup). Otherwise it is an open-addressed hash table
+ * with linear probing, kept at most half full.
+ *
+ * One writer may set entries while other threads look ids up, as long as
+ * reserve() covered every id set; a row found by find() has its columns
+ * written. Growing past the reservation rebuilds the table and must not
+ * race with find().
+ */
+class IdIndex {
+ public:
+    static constexpr int32_t NO_ROW = -1;
+
+    IdIndex() = default;
+
+    IdIndex(const IdIndex&) = delete;
+    IdIndex& operator=(const IdIndex&) = delete;
+
+    /**
+     * Make room for rows distinct ids in all (hash table).
+     */
+    void reserve(size_t rows);
+
+    /**
+     * Make room for rows ids, all within [min_id, max_id]; dense when the
+     * range is narrow enough.
+     */
+    void reserve(size_t rows, int min_id, int max_id);
+
+    void set(int id, int32_t row);
+    int32_t find(int id) const;
+
+ private:
+    static constexpr size_t DENSE_SPREAD = 4;
+    static constexpr size_t MIN_SLOTS = 16;
+
+    size_t slot_of(int id) const;
+    void rehash(size_t rows);
+
+    bool dense_ = false;
+    int64_t base_ = 0;                // Dense: id of rows_[0]
+    size_t used_ = 0;                 // Hash: occupied slots
+    int shift_ = 64;                  // Hash: 64 - log2(slots)
+    std::vector<int32_t> rows_;       // Row per id (dense) or per slot
+    std::vector<int32_t> keys_;       // Hash: id of each occupied slot
+};
+
+// Per-row result flags
+constexpr uint8_t RESULT_OPENCL = 0x01;  // Passed Filter 1
+constexpr uint8_t RESULT_PYTHON = 0x02;  // Passed Filter 2
+
+/**
+ * Filter pass counts over the rows not shadowed by a duplicate id.
+ */
+struct ResultCounts {
+    int64_t opencl = 0;
+    int64_t python = 0;
+    int64_t both = 0;
+};
+
+/**
+ * Copy of the result columns taken at one point in time.
+ */
+struct ResultSnapshot {
+    ResultCounts counts;
+    std::vector<uint8_t> flags;
+    std::vector<float> reliability;
+    std::vector<float> stability;
+
+    bool has_opencl_result(int32_t row) const {
+        return flags[row] & RESULT_OPENCL;
+    }
+    bool has_python_result(int32_t row) const {
+        return flags[row] & RESULT_PYTHON;
+    }
+};
+
+/**
+ * Structure-of-arrays server inventory with computed scores.
+ * Input columns are laid out exactly as the OpenCL buffers and ZMQ batch
+ * frames expect, locations are interned into a dictionary.
+ *
+ * Result writes need no lock: every producer owns its value column and
+ * publishes a row by setting its bit in the row's flag byte with release
+ * ordering, so any reader that sees the bit also sees the value. Pass
+ * counts are kept as results arrive, so reports need no counting pass.
+ *
+ * Rows may be appended by one loader thread while others read and write
+ * already published rows, as long as the columns never reallocate:
+ * reserve() an upper bound of the row count up front and never add()
+ * past capacity(). Readers never look at the vectors' sizes, which
+ * push_back writes; size() and the column spans come from a row count
+ * the loader publishes with release ordering once a row is complete.
+ *
+ * Input columns are either owned (filled by add()) or attached from
+ * external memory such as a mapped binary inventory, without a copy.
+ */
+class ServerTable {
+ public:
+    /**
+     * Append a record.
+     * A later record with the same id replaces the earlier one in the index.
+     * @return Row of the new record
+     */
+    int32_t add(int id, std::string_view location, int uptime, float load);
+
+    void reserve(size_t rows);
+
+    /**
+     * Use external input columns instead of owned ones. The table must be
+     * empty and add() must not be called afterwards.
+     * @param backing Keeps the column memory alive as long as the table
+     * @param location_ids Indices into location_names, validated by the
+     *                     caller
+     */
+    void attach(std::shared_ptr<const void> backing,
+                std::span<const int> ids,
+                std::span<const int> uptimes,
+                std::span<const float> loads,
+                std::span<const uint32_t> location_ids,
+                std::vector<std::string> location_names);
+
+    size_t size() const { return rows_.load(std::memory_order_acquire); }
+    size_t capacity() const {
+        return backing_ ? external_.ids.size() : ids_.capacity();
+    }
+    bool empty() const { return size() == 0; }
+
+    // Input columns, up to the published row count
+    std::span<const int> ids() const {
+        return backing_ ? external_.ids
+                        : std::span<const int>(ids_.data(), size());
+    }
+    std::span<const int> uptimes() const {
+        return backing_ ? external_.uptimes
+                        : std::span<const int>(uptimes_.data(), size());
+    }
+    std::span<const float> loads() const {
+        return backing_ ? external_.loads
+                        : std::span<const float>(loads_.data(), size());
+    }
+    std::span<const uint32_t> location_ids() const {
+        return backing_ ? external_.location_ids
+                        : std::span<const uint32_t>(location_ids_.data(),
+                                                    size());
+    }
+    const std::vector<std::string>& location_names() const {
+        return location_names_;
+    }
+
+    /**
+     * Owner of attached input columns (nullptr = owned columns); holding
+     * it keeps ids(), uptimes(), loads() and location_ids() valid after
+     * the table is gone.
+     */
+    const std::shared_ptr<const void>& backing() const { return backing_; }
+    const std::string& location(int32_t row) const {
+        return location_names_[location_ids()[row]];
+    }
+
+    /**
+     * Copy of a row's location; safe while the loader is still adding
+     * rows (location() is not, a new name may grow the dictionary).
+     */
+    std::string location_name(int32_t row) const;
+
+    // Result columns (a flag is set only for records passing the filter)
+    uint8_t flags(int32_t row) const;
+    bool has_opencl_result(int32_t row) const {
+        return flags(row) & RESULT_OPENCL;
+    }
+    bool has_python_result(int32_t row) const {
+        return flags(row) & RESULT_PYTHON;
+    }
+
+    /**
+     * Published score of a row; valid once flags(row) has the filter's bit.
+     */
+    float reliability(int32_t row) const;
+    float stability(int32_t row) const;
+
+    /**
+     * Lock-free result writes, safe from any thread.
+     */
+    void set_reliability(int32_t row, float value);
+    void set_stability(int32_t row, float value);
+
+    /**
+     * Count records that passed only one filter without publishing their
+     * value (fused device pass: only rows passing both are read back).
+     * Such records are not tied to a row, so duplicate ids are not
+     * deducted from these counts.
+     */
+    void count_single_passes(int64_t opencl, int64_t python);
+
+    /**
+     * Called with a row the moment it has passed both filters, on the
+     * thread that published the second result; exactly once per row.
+     * Hooks are added before any result is written (see ResultStream,
+     * LocationRollup) and removed together once the stages are done.
+     */
+    void add_completion_hook(std::function<void(int32_t)> hook) {
+        on_both_.push_back(std::move(hook));
+    }
+    void clear_completion_hooks() { on_both_.clear(); }
+
+    /**
+     * Copy the result columns and counts once loading has finished. Every
+     * row is internally consistent (a set flag comes with its value); rows
+     * published during the copy may or may not be included.
+     */
+    ResultSnapshot snapshot() const;
+
+    /**
+     * Row holding an id, IdIndex::NO_ROW if unknown. O(1).
+     */
+    int32_t row_of(int id) const { return index_.find(id); }
+
+    /**
+     * Rows whose id was added again later; complete once loading has
+     * finished.
+     */
+    const std::vector<int32_t>& shadowed_rows() const { return shadowed_; }
+
+ private:
+    void publish(std::vector<float>* column, int32_t row, float value,
+                 uint8_t flag, std::atomic<int64_t>* counter);
+    void index_row(int id, int32_t row);
+
+    struct ExternalColumns {
+        std::span<const int> ids;
+        std::span<const int> uptimes;
+        std::span<const float> loads;
+        std::span<const uint32_t> location_ids;
+    };
+
+    std::shared_ptr<const void> backing_;
+    ExternalColumns external_;
+
+    std::vector<int> ids_;
+    std::vector<int> uptimes_;
+    std::vector<float> loads_;
+    std::vector<uint32_t> location_ids_;
+    std::vector<float> reliability_;
+    std::vector<float> stability_;
+    std::vector<uint8_t> flags_;
+    std::atomic<size_t> rows_{0};     // Published rows
+
+    std::vector<std::function<void(int32_t)>> on_both_;
+
+    // Rows whose id was added again later; excluded from the counts
+    std::vector<int32_t> shadowed_;
+
+    // Producers touch different counters, keep them on separate lines
+    alignas(64) std::atomic<int64_t> opencl_passed_{0};
+    alignas(64) std::atomic<int64_t> python_passed_{0};
+    alignas(64) std::atomic<int64_t> both_passed_{0};
+
+    std::vector<std::string> location_names_;
+    mutable std::shared_mutex location_mutex_;   // Guards growing names
+    // Looked up by string_view, without a string per record
+    struct LocationHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+    std::unordered_map<std::string, uint32_t, LocationHash, std::equal_to<>>
+        location_lookup_;
+
+    IdIndex index_;
+};
+
+#endif  // CPP_APP_SRC_SERVER_TABLE_H_
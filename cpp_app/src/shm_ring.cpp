@@ -0,0 +1,129 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/shm_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "src/metrics.h"
+#include "src/utils.h"
+
+namespace {
+
+LockMetrics* ring_lock() {
+    static LockMetrics* const lock = metrics().lock("shm_ring");
+    return lock;
+}
+
+Gauge* slots_in_flight() {
+    static Gauge* const gauge =
+        metrics().gauge("lygiagretus_shm_slots_in_flight", "");
+    return gauge;
+}
+
+}  // namespace
+
+ShmRing::~ShmRing() {
+    close();
+}
+
+size_t ShmRing::slot_bytes(uint32_t slot_records) {
+    // Four 4 byte columns and one pass flag per record
+    const size_t bytes = static_cast<size_t>(slot_records) * 17;
+    return (bytes + 63) / 64 * 64;
+}
+
+void ShmRing::create(const std::string& name, uint32_t slots,
+                     uint32_t slot_records) {
+    close();
+
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create shared memory " + name);
+    }
+    slot_bytes_ = slot_bytes(slot_records);
+    size_ = HEADER_SIZE + slot_bytes_ * slots;
+    if (::ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot size shared memory " + name);
+    }
+    void* addr = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+    ::close(fd);  // The mapping keeps the segment referenced
+    if (addr == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Cannot map shared memory " + name);
+    }
+
+    name_ = name;
+    base_ = static_cast<char*>(addr);
+    slots_ = slots;
+    slot_records_ = slot_records;
+
+    const RingHeader header{
+        .magic = MAGIC,
+        .version = Constants::PROTOCOL_VERSION,
+        .slots = slots,
+        .slot_records = slot_records,
+        .slot_bytes = slot_bytes_
+    };
+    std::memcpy(base_, &header, sizeof(header));
+    reset();
+}
+
+void ShmRing::close() {
+    if (base_ != nullptr) {
+        ::munmap(base_, size_);
+        ::shm_unlink(name_.c_str());
+        base_ = nullptr;
+        size_ = 0;
+    }
+}
+
+ShmRing::Acquire ShmRing::try_acquire(uint32_t* slot) {
+    auto lock = timed_lock(mutex_, ring_lock());
+    if (stopped_) {
+        return Acquire::kStopped;
+    }
+    if (free_.empty()) {
+        stalls_++;
+        return Acquire::kFull;
+    }
+    *slot = free_.back();
+    free_.pop_back();
+    slots_in_flight()->set(slots_ - free_.size());
+    return Acquire::kSlot;
+}
+
+void ShmRing::release(uint32_t slot) {
+    auto lock = timed_lock(mutex_, ring_lock());
+    free_.push_back(slot);
+    slots_in_flight()->set(slots_ - free_.size());
+}
+
+void ShmRing::stop() {
+    auto lock = timed_lock(mutex_, ring_lock());
+    stopped_ = true;
+}
+
+void ShmRing::reset() {
+    std::scoped_lock lock(mutex_);
+    free_.clear();
+    // Lowest slots are handed out first
+    for (uint32_t slot = slots_; slot > 0; slot--) {
+        free_.push_back(slot - 1);
+    }
+    stopped_ = false;
+    stalls_ = 0;
+}
+
+int ShmRing::stalls() const {
+    std::scoped_lock lock(mutex_);
+    return stalls_;
+}
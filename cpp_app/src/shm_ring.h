@@ -0,0 +1,123 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_SHM_RING_H_
+#define CPP_APP_SRC_SHM_RING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * POSIX shared-memory ring of record slots for same-host workers
+ * (--wire-transport shm). Every slot holds the task columns of up to
+ * slot_records() records and the result columns the workers fill in:
+ *
+ *   header: RingHeader (64 bytes)
+ *   slot:   ids[n](i32) loads[n](f32) uptimes[n](i32)
+ *           stabilities[n](f32) passed[n](u8), padded to 64 bytes
+ *
+ * Only small slot frames travel over ZMQ (see wire_protocol.h). A slot is
+ * owned by the sender from try_acquire() until its task frame is sent, by
+ * the workers until their result frame arrives and is free after
+ * release(). The free slots are the flow control window; the sender waits
+ * for a release without blocking (see CreditGate).
+ */
+class ShmRing {
+ public:
+    static constexpr uint32_t MAGIC = 0x474E4952;  // "RING"
+    static constexpr uint32_t HEADER_SIZE = 64;
+
+    enum class Acquire { kSlot, kFull, kStopped };
+
+    struct RingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slots;
+        uint32_t slot_records;
+        uint64_t slot_bytes;
+    };
+
+    ShmRing() = default;
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /**
+     * Create (or replace) the named segment and mark every slot free.
+     * @throws std::runtime_error if the segment cannot be created
+     */
+    void create(const std::string& name, uint32_t slots,
+                uint32_t slot_records);
+
+    /**
+     * Unmap and unlink the segment.
+     */
+    void close();
+
+    bool is_open() const { return base_ != nullptr; }
+    uint32_t slots() const { return slots_; }
+    uint32_t slot_records() const { return slot_records_; }
+
+    int* ids(uint32_t slot) { return column<int>(slot, 0); }
+    float* loads(uint32_t slot) { return column<float>(slot, 4); }
+    int* uptimes(uint32_t slot) { return column<int>(slot, 8); }
+    const float* stabilities(uint32_t slot) {
+        return column<float>(slot, 12);
+    }
+    const uint8_t* passed(uint32_t slot) { return column<uint8_t>(slot, 16); }
+
+    /**
+     * Take a free slot. kFull counts as a stall; retry after a release().
+     * @return kStopped once the ring is closed for the job
+     */
+    Acquire try_acquire(uint32_t* slot);
+
+    /**
+     * Return a slot the workers have answered.
+     */
+    void release(uint32_t slot);
+
+    /**
+     * Refuse try_acquire() until reset(), e.g. when the workers have gone
+     * away.
+     */
+    void stop();
+
+    /**
+     * Mark every slot free again for a new job.
+     */
+    void reset();
+
+    /**
+     * Number of times try_acquire() found no free slot.
+     */
+    int stalls() const;
+
+ private:
+    static size_t slot_bytes(uint32_t slot_records);
+
+    // Column offsets are multiples of slot_records by record width
+    template <typename T>
+    T* column(uint32_t slot, size_t width) {
+        return reinterpret_cast<T*>(
+            base_ + HEADER_SIZE + slot_bytes_ * slot +
+            width * slot_records_);
+    }
+
+    std::string name_;
+    char* base_ = nullptr;
+    size_t size_ = 0;
+    size_t slot_bytes_ = 0;
+    uint32_t slots_ = 0;
+    uint32_t slot_records_ = 0;
+
+    mutable std::mutex mutex_;
+    std::vector<uint32_t> free_;
+    bool stopped_ = false;
+    int stalls_ = 0;
+};
+
+#endif  // CPP_APP_SRC_SHM_RING_H_
@@ -0,0 +1,139 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/stability_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+#include "src/config.h"
+#include "src/metrics.h"
+#include "src/row_pool.h"
+#include "src/utils.h"
+
+namespace {
+
+/**
+ * The recurrence; Iterations > 0 fixes the trip count at compile time,
+ * 0 takes it from params.
+ */
+template <int Iterations>
+double stability_loop(int id, float load, int uptime,
+                      const ScoreParameters& params) {
+    const int count =
+        (Iterations > 0) ? Iterations : params.stability_iterations;
+    const int checks = params.stability_exit_checks;
+    // Python's % is never negative for a positive modulus
+    const int seed = ((id % 10) + 10) % 10;
+    double stability = 0.5 + seed * 0.01;
+    double lo = 2.0;
+    double hi = -1.0;
+    int side = 0;
+    int streak = 0;
+
+    const double load_d = load;
+    for (int i = 0; i < count; i++) {
+        const double factor1 = std::cos(load_d * 0.001 * i);
+        const double factor2 = std::sin(uptime / 10000.0 * i);
+        const double factor3 =
+            (std::fabs(stability) < 100) ? std::tan(stability * 0.01) : 0.0;
+        stability = std::fabs(
+            std::sin(stability + factor1 * factor2 - factor3 * 0.001));
+        if (checks <= 0) {
+            continue;
+        }
+
+        // Early exit once the state kept to one side of the threshold
+        lo = std::min(lo, stability);
+        hi = std::max(hi, stability);
+        if ((i + 1) % Config::EXIT_CHECK_ITERATIONS == 0) {
+            const double threshold = params.stability_threshold;
+            const int now = (lo * 100.0 >= threshold)  ? 1
+                            : (hi * 100.0 < threshold) ? -1
+                                                       : 0;
+            streak = (now != 0 && now == side) ? streak + 1 : (now != 0);
+            side = now;
+            lo = 2.0;
+            hi = -1.0;
+            if (streak >= checks) {
+                break;
+            }
+        }
+    }
+
+    return stability * 100.0;
+}
+
+}  // namespace
+
+double compute_stability(int id, float load, int uptime,
+                         const ScoreParameters& params) {
+    if (params.stability_iterations == Constants::STABILITY_ITERATIONS) {
+        return stability_loop<Constants::STABILITY_ITERATIONS>(id, load,
+                                                               uptime, params);
+    }
+    if (params.stability_iterations == Config::QUICK_STABILITY_ITERATIONS) {
+        return stability_loop<Config::QUICK_STABILITY_ITERATIONS>(
+            id, load, uptime, params);
+    }
+    return stability_loop<0>(id, load, uptime, params);
+}
+
+void stability_thread(
+    ServerTable* table,
+    const StabilitySettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed) {
+    TraceScope scope("stability", "native stability");
+    const int threads = pool_threads(settings.threads);
+
+    std::cout << Color::CYAN << "[Stability] " << Color::RESET
+              << "Native engine, " << threads << " thread(s)\n";
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::atomic<int> processed{0};
+    std::atomic<int> accepted{0};
+
+    try {
+        run_row_pool(*table, threads, Config::STABILITY_TASK_ROWS, rows,
+                     input, settings.throttle, [&](const RowTask& task) {
+            IdBatch ids;
+            for (int32_t row : task) {
+                const int id = table->ids()[row];
+                const double stability = compute_stability(
+                    id, table->loads()[row], table->uptimes()[row],
+                    settings.params);
+                // Results travel as f32, like the ZMQ frames
+                if (stability >= settings.params.stability_threshold) {
+                    table->set_stability(row, static_cast<float>(stability));
+                    ids.push_back(id);
+                }
+            }
+            processed += static_cast<int>(task.size());
+            accepted += static_cast<int>(ids.size());
+            if (passed != nullptr && !ids.empty()) {
+                passed->push(std::move(ids));
+            }
+        });
+    } catch (const std::exception& e) {
+        stage_errors()->add(1);
+        std::cerr << Color::RED << "[Stability] " << e.what()
+                  << Color::RESET << "\n";
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << Color::CYAN << "[Stability] " << Color::RESET
+              << accepted << "/" << processed << " passed, " << elapsed
+              << " ms\n";
+
+    // Downstream stage must not wait forever, even after a failure
+    if (passed != nullptr) {
+        passed->close();
+    }
+}
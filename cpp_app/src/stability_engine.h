@@ -0,0 +1,55 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_STABILITY_ENGINE_H_
+#define CPP_APP_SRC_STABILITY_ENGINE_H_
+
+#include "src/channel.h"
+#include "src/score_params.h"
+#include "src/server_table.h"
+#include "src/types.h"
+
+class PoolThrottle;
+
+/**
+ * Tunables for the native stability stage.
+ */
+struct StabilitySettings {
+    int threads;             // Worker threads (0 = one per core)
+    PoolThrottle* throttle;  // Limits the busy workers (nullptr = all)
+    ScoreParameters params;  // Iterations and threshold
+};
+
+/**
+ * Stability score of one record.
+ * Same recurrence, double precision and libm calls as
+ * compute_stability_score in python_app/functions.py, so scores match
+ * the Python workers. The preset iteration counts run a loop with a
+ * compile-time trip count; with params.stability_exit_checks the loop
+ * may end early (see ScoreParameters).
+ */
+double compute_stability(int id, float load, int uptime,
+                         const ScoreParameters& params = ScoreParameters{});
+
+/**
+ * Native stability thread function (alternative to the ZMQ workers).
+ * Computes stability scores on a thread pool and applies Filter 2
+ * (stability >= threshold). Results are written to the table as each task
+ * completes.
+ *
+ * @param table Server table; stability results are written lock-free
+ * @param settings Thread pool settings
+ * @param rows Row ranges published by the loader (used when input is
+ *             nullptr)
+ * @param input Ids to evaluate, pushed by an upstream stage
+ *              (nullptr = evaluate every loaded record)
+ * @param passed Receives the ids that passed each task
+ *               (nullptr = not chained); closed when the thread ends
+ */
+void stability_thread(
+    ServerTable* table,
+    const StabilitySettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed);
+
+#endif  // CPP_APP_SRC_STABILITY_ENGINE_H_
@@ -3,30 +3,20 @@
 #ifndef CPP_APP_SRC_TYPES_H_
 #define CPP_APP_SRC_TYPES_H_
 
-#include <string>
+#include <cstdint>
+#include <vector>
 
 /**
- * Input server data loaded from JSON.
+ * Batch of server ids handed between pipeline stages.
  */
-struct ServerData {
-    int id;
-    std::string location;
-    int uptime;
-    float load;
-};
+using IdBatch = std::vector<int>;
 
 /**
- * Server result with computed scores.
+ * Half-open range of table rows [begin, end) published by the loader.
  */
-struct ServerResult {
-    int id;
-    std::string location;
-    int uptime;
-    float load;
-    float reliability;       // Computed by OpenCL (Filter 1)
-    float stability;         // Computed by Python (Filter 2)
-    bool has_opencl_result;
-    bool has_python_result;
+struct RowRange {
+    int32_t begin;
+    int32_t end;
 };
 
 #endif  // CPP_APP_SRC_TYPES_H_
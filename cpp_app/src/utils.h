@@ -30,10 +30,29 @@ constexpr int SLEEP_MS = 500;
 
 // Protocol
 constexpr unsigned char STOP_SIGNAL = 0xFF;
+constexpr unsigned char BATCH_MAGIC = 0xB7;
+constexpr unsigned char PROTOCOL_VERSION = 1;
+
+// Filter 1 (defaults of ScoreParameters)
+constexpr int RELIABILITY_ITERATIONS = 4000000;
+constexpr float RELIABILITY_THRESHOLD = 50.0f;
+
+// Filter 2 (defaults of ScoreParameters, same values as
+// python_app/config.py)
+constexpr int STABILITY_ITERATIONS = 600000;
+constexpr double STABILITY_THRESHOLD = 50.0;
 
 // OpenCL kernel arguments
 constexpr int KERNEL_ARG_COUNTER = 5;
 constexpr int KERNEL_ARG_COUNT = 6;
+constexpr int KERNEL_ARG_OUT_STABILITY = 7;   // compute_both only
+constexpr int KERNEL_ARG_SINGLE_COUNTS = 8;   // compute_both only
+
+// summarize_locations (kernels.cl): values per location of a group's
+// partial, and the flag of rows the kernel skips
+constexpr int SUMMARY_FLOATS = 2;   // Reliability, stability sums
+constexpr int SUMMARY_INTS = 6;     // Records, passed, min/max keys
+constexpr unsigned char SUMMARY_ROW_SHADOWED = 0x80;
 
 // Output formatting
 constexpr int LINE_WIDTH = 80;
@@ -0,0 +1,306 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+/**
+ * Validates early exit (main_app --early-exit) against exact scoring on
+ * JSON inventories, by default every .json set in data/. Both filters run
+ * on the native engines (the same recurrences as the kernels), once exact
+ * and once with early exit. Per file and filter the report counts the
+ * scores that differ from the exact ones (a record that stopped early on
+ * a fixed point keeps its exact score), the pass/fail decisions that
+ * changed and the time of each mode.
+ *
+ * Usage: validate_app [--early-exit N] [--precision full|quick]
+ *                     [--threads N] [--output FILE] [input.json ...]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>  // NOLINT(build/c++17)
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "src/config.h"
+#include "src/cpu_reliability.h"
+#include "src/data_io.h"
+#include "src/row_pool.h"
+#include "src/score_params.h"
+#include "src/server_table.h"
+#include "src/stability_engine.h"
+#include "src/utils.h"
+
+namespace {
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+struct ValidateOptions {
+    ScoreParameters params;          // Exit checks: Config::VALIDATE_*
+    int threads = 0;                 // 0 = one per core
+    std::string output = Config::VALIDATE_OUTPUT_FILE;
+    std::vector<std::string> inputs;
+};
+
+/**
+ * Every score of one filter in one mode.
+ */
+struct FilterRun {
+    std::vector<double> scores;
+    double ms = 0.0;
+};
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+}
+
+/**
+ * Run fn(begin, end) on contiguous shares of count rows, one per thread.
+ */
+template <typename Fn>
+void parallel_rows(int count, int threads, Fn fn) {
+    const int share = (count + threads - 1) / threads;
+    std::vector<std::jthread> pool;
+    for (int begin = 0; begin < count; begin += share) {
+        pool.emplace_back(fn, begin, std::min(begin + share, count));
+    }
+}
+
+FilterRun run_reliability(const ServerTable& table,
+                          const ScoreParameters& params, int threads) {
+    const int count = static_cast<int>(table.size());
+    const CpuIsa isa = detect_cpu_isa();
+    std::vector<float> scores(count);
+    const auto start = Clock::now();
+    parallel_rows(count, threads, [&](int begin, int end) {
+        compute_reliability_block(isa, params, table.uptimes().data() + begin,
+                                  table.loads().data() + begin, end - begin,
+                                  scores.data() + begin);
+    });
+    FilterRun run;
+    run.ms = elapsed_ms(start);
+    run.scores.assign(scores.begin(), scores.end());
+    return run;
+}
+
+FilterRun run_stability(const ServerTable& table,
+                        const ScoreParameters& params, int threads) {
+    const int count = static_cast<int>(table.size());
+    FilterRun run;
+    run.scores.resize(count);
+    const auto start = Clock::now();
+    parallel_rows(count, threads, [&](int begin, int end) {
+        for (int row = begin; row < end; row++) {
+            run.scores[row] = compute_stability(table.ids()[row],
+                                                table.loads()[row],
+                                                table.uptimes()[row], params);
+        }
+    });
+    run.ms = elapsed_ms(start);
+    return run;
+}
+
+/**
+ * Compare one filter's approximate run to the exact one.
+ */
+json compare(const FilterRun& exact, const FilterRun& approximate,
+             double threshold) {
+    int differ = 0;
+    int changed = 0;
+    int passed = 0;
+    for (size_t r = 0; r < exact.scores.size(); r++) {
+        const bool pass = exact.scores[r] >= threshold;
+        passed += pass ? 1 : 0;
+        differ += (approximate.scores[r] != exact.scores[r]) ? 1 : 0;
+        changed += ((approximate.scores[r] >= threshold) != pass) ? 1 : 0;
+    }
+    return {
+        {"passed", passed},
+        {"scores_differ", differ},
+        {"changed", changed},
+        {"exact_ms", exact.ms},
+        {"approximate_ms", approximate.ms},
+        {"speedup", (approximate.ms > 0.0) ? exact.ms / approximate.ms : 0.0}
+    };
+}
+
+bool parse_int(const std::string& name, const char* value, int min,
+               int* out) {
+    if (value == nullptr) {
+        std::cerr << Color::RED << "[Error] Missing value for " << name
+                  << Color::RESET << "\n";
+        return false;
+    }
+    try {
+        size_t pos = 0;
+        const int parsed = std::stoi(value, &pos);
+        if (value[pos] != '\0' || parsed < min) {
+            throw std::invalid_argument(value);
+        }
+        *out = parsed;
+        return true;
+    } catch (const std::exception&) {
+        std::cerr << Color::RED << "[Error] Invalid value for " << name
+                  << ": " << value << Color::RESET << "\n";
+        return false;
+    }
+}
+
+bool parse_validate_options(int argc, char* argv[],
+                            ValidateOptions* options) {
+    options->params.reliability_exit_checks = Config::VALIDATE_EXIT_CHECKS;
+    options->params.stability_exit_checks = Config::VALIDATE_EXIT_CHECKS;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--early-exit") {
+            int checks = 0;
+            if (!parse_int(arg, next, 1, &checks)) {
+                return false;
+            }
+            options->params.reliability_exit_checks = checks;
+            options->params.stability_exit_checks = checks;
+            i++;
+        } else if (arg == "--precision") {
+            const std::string name = (next != nullptr) ? next : "";
+            if (!score_preset(name, &options->params)) {
+                std::cerr << Color::RED
+                          << "[Error] Invalid value for --precision: "
+                          << name << " (full, quick)" << Color::RESET
+                          << "\n";
+                return false;
+            }
+            i++;
+        } else if (arg == "--threads") {
+            if (!parse_int(arg, next, 0, &options->threads)) {
+                return false;
+            }
+            i++;
+        } else if (arg == "--output") {
+            if (next == nullptr) {
+                std::cerr << Color::RED << "[Error] Missing value for "
+                          << arg << Color::RESET << "\n";
+                return false;
+            }
+            options->output = next;
+            i++;
+        } else if (arg[0] != '-') {
+            options->inputs.push_back(arg);
+        } else {
+            std::cerr << Color::RED << "[Error] Unknown option: " << arg
+                      << Color::RESET << "\n";
+            return false;
+        }
+    }
+
+    if (options->inputs.empty()) {
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(
+                 Config::VALIDATE_DATA_DIR, ec)) {
+            if (entry.path().extension() == ".json") {
+                options->inputs.push_back(entry.path().string());
+            }
+        }
+        std::sort(options->inputs.begin(), options->inputs.end());
+        if (options->inputs.empty()) {
+            std::cerr << Color::RED << "[Error] No inventories in "
+                      << Config::VALIDATE_DATA_DIR << Color::RESET << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::cout.setf(std::ios::unitbuf);
+    std::cout << Color::BOLD << "\n=== Early Exit Validation ==="
+              << Color::RESET << "\n";
+
+    ValidateOptions options;
+    if (!parse_validate_options(argc, argv, &options)) {
+        return 1;
+    }
+    const int threads = pool_threads(options.threads);
+    ScoreParameters exact = options.params;
+    exact.reliability_exit_checks = 0;
+    exact.stability_exit_checks = 0;
+
+    json files = json::array();
+    int changed = 0;
+    try {
+        for (const std::string& input : options.inputs) {
+            ServerTable table;
+            if (!load_data(input, &table, {})) {
+                return 1;
+            }
+            std::cout << Color::BLUE << "[Validate] " << Color::RESET
+                      << input << ": " << table.size() << " records\n";
+
+            const json reliability = compare(
+                run_reliability(table, exact, threads),
+                run_reliability(table, options.params, threads),
+                options.params.reliability_threshold);
+            const json stability = compare(
+                run_stability(table, exact, threads),
+                run_stability(table, options.params, threads),
+                options.params.stability_threshold);
+            changed += reliability["changed"].get<int>() +
+                       stability["changed"].get<int>();
+
+            for (const auto& [name, result] :
+                 {std::pair{"Reliability", &reliability},
+                  std::pair{"Stability", &stability}}) {
+                std::cout << Color::BLUE << "[Validate] " << Color::RESET
+                          << "  " << name << ": "
+                          << (*result)["scores_differ"].get<int>()
+                          << " score(s) differ, "
+                          << (*result)["changed"].get<int>()
+                          << " decision(s) changed, "
+                          << (*result)["speedup"].get<double>() << "x\n";
+            }
+            files.push_back({
+                {"file", input},
+                {"records", table.size()},
+                {"reliability", reliability},
+                {"stability", stability}
+            });
+        }
+    } catch (const std::exception& e) {
+        std::cerr << Color::RED << "[Validate] " << e.what() << Color::RESET
+                  << "\n";
+        return 1;
+    }
+
+    const json result = {
+        {"precision", score_preset_name(exact)},
+        {"early_exit", options.params.reliability_exit_checks},
+        {"check_iterations", Config::EXIT_CHECK_ITERATIONS},
+        {"threads", threads},
+        {"changed", changed},
+        {"files", files}
+    };
+
+    const std::filesystem::path path(options.output);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::ofstream out(options.output);
+    if (!out) {
+        std::cerr << Color::RED << "[Validate] Cannot write "
+                  << options.output << Color::RESET << "\n";
+        return 1;
+    }
+    out << result.dump(2) << "\n";
+
+    std::cout << Color::GREEN << "[Validate] " << Color::RESET << changed
+              << " decision(s) changed in total, report -> "
+              << options.output << "\n";
+    return 0;
+}
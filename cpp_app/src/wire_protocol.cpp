@@ -0,0 +1,58 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/wire_protocol.h"
+
+#include <cstring>
+
+#include "src/utils.h"
+
+namespace Wire {
+
+FrameHeader make_header(FrameKind kind, uint32_t count, bool multipart) {
+    return FrameHeader{
+        .magic = Constants::BATCH_MAGIC,
+        .version = Constants::PROTOCOL_VERSION,
+        .kind = kind,
+        .flags = static_cast<uint8_t>(multipart ? FLAG_MULTIPART : 0),
+        .count = count
+    };
+}
+
+bool parse_header(const void* data, size_t size, FrameHeader* header) {
+    if (size < sizeof(FrameHeader)) {
+        return false;
+    }
+    std::memcpy(header, data, sizeof(FrameHeader));
+    if (header->magic != Constants::BATCH_MAGIC ||
+        header->version != Constants::PROTOCOL_VERSION) {
+        return false;
+    }
+    switch (header->kind) {
+        case FrameKind::kTasks:
+        case FrameKind::kResults:
+        case FrameKind::kHello:
+        case FrameKind::kCredit:
+        case FrameKind::kDone:
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t frame_size(FrameKind kind, uint32_t count) {
+    size_t record = 0;
+    if (kind == FrameKind::kTasks) {
+        record = Constants::MSG_SIZE;
+    } else if (kind == FrameKind::kResults) {
+        record = Constants::MSG_RESULT_SIZE;
+    } else if (kind == FrameKind::kHello) {
+        return sizeof(HelloFrame);
+    } else if (kind == FrameKind::kCredit) {
+        return sizeof(CreditFrame);
+    } else if (kind == FrameKind::kDone) {
+        return sizeof(DoneFrame);
+    }
+    return sizeof(FrameHeader) + record * count;
+}
+
+}  // namespace Wire
@@ -0,0 +1,114 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_WIRE_PROTOCOL_H_
+#define CPP_APP_SRC_WIRE_PROTOCOL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Versioned batch frames of the ZMQ binary protocol.
+ *
+ * Every batch starts with an 8 byte header followed by packed columns:
+ *   tasks:   ids[count](i32) loads[count](f32) uptimes[count](i32)
+ *   results: ids[count](i32) stabilities[count](f32)
+ *   hello:   capabilities(u32) reserved(u32), count = offered batch size
+ *   credit:  processed(u32) reserved(u32), count = records granted
+ *   done:    passed(u32) reserved(u32), count = records processed
+ * With FLAG_MULTIPART the header travels alone and each column is a
+ * separate part of the same multipart message.
+ *
+ * Legacy single-record frames (MSG_SIZE / MSG_RESULT_SIZE bytes, never
+ * multipart) and the 1 byte stop signal stay valid. Batch frames are never
+ * sent empty and hello and credit carry a payload, so no batch frame can
+ * have a legacy size (1, 8 or 12 bytes).
+ *
+ * Flow control: when both hellos carry CAP_CREDITS, the sender may only
+ * have as many task records outstanding as the workers granted. The
+ * workers grant an initial window right after their hello and return one
+ * credit per processed record.
+ *
+ * Cluster mode (ROUTER/DEALER): a node registers with hello, asks for
+ * work with credit frames (count 0 is a heartbeat) and finishes every
+ * batch with done. Tasks, results and done travel behind a 4 byte batch
+ * id part; a node sent hello by the router registers again.
+ *
+ * Shared memory (CAP_SHM in both hellos, see ShmRing): tasks and results
+ * are slot frames with FLAG_SHM. The records stay in the ring slot;
+ * the task frame hands the slot to the workers, and the result frame
+ * hands it back with the stabilities and pass flags written in place.
+ */
+namespace Wire {
+
+enum class FrameKind : uint8_t {
+    kTasks = 1,
+    kResults = 2,
+    kHello = 3,
+    kCredit = 4,
+    kDone = 5
+};
+
+constexpr uint8_t FLAG_MULTIPART = 0x01;
+constexpr uint8_t FLAG_SHM = 0x02;        // Columns are in a ring slot
+
+// Hello capability bits
+constexpr uint32_t CAP_MULTIPART = 0x01;  // Peer sends multipart batches
+constexpr uint32_t CAP_CREDITS = 0x02;    // Credit-based flow control
+constexpr uint32_t CAP_SHM = 0x04;        // Shared-memory ring transport
+
+struct FrameHeader {
+    uint8_t magic;
+    uint8_t version;
+    FrameKind kind;
+    uint8_t flags;
+    uint32_t count;
+};
+static_assert(sizeof(FrameHeader) == 8, "FrameHeader must be 8 bytes");
+
+struct HelloFrame {
+    FrameHeader header;
+    uint32_t capabilities;
+    uint32_t reserved;
+};
+static_assert(sizeof(HelloFrame) == 16, "HelloFrame must be 16 bytes");
+
+struct CreditFrame {
+    FrameHeader header;
+    uint32_t processed;      // Records processed in this job (informative)
+    uint32_t reserved;
+};
+static_assert(sizeof(CreditFrame) == 16, "CreditFrame must be 16 bytes");
+
+struct DoneFrame {
+    FrameHeader header;
+    uint32_t passed;         // Records of the batch that passed Filter 2
+    uint32_t reserved;
+};
+static_assert(sizeof(DoneFrame) == 16, "DoneFrame must be 16 bytes");
+
+struct SlotFrame {
+    FrameHeader header;      // count = records in the slot
+    uint32_t slot;
+    uint32_t passed;         // Results: records that passed Filter 2
+};
+static_assert(sizeof(SlotFrame) == 16, "SlotFrame must be 16 bytes");
+
+/**
+ * Build a header for the current protocol version.
+ */
+FrameHeader make_header(FrameKind kind, uint32_t count, bool multipart);
+
+/**
+ * Parse and validate a header.
+ * @return false if data is not a batch header of a known version
+ */
+bool parse_header(const void* data, size_t size, FrameHeader* header);
+
+/**
+ * Size of a single-part frame (header + columns) for a batch.
+ */
+size_t frame_size(FrameKind kind, uint32_t count);
+
+}  // namespace Wire
+
+#endif  // CPP_APP_SRC_WIRE_PROTOCOL_H_
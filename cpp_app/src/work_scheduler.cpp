@@ -0,0 +1,227 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/work_scheduler.h"
+
+#include <algorithm>
+#include <mutex>
+
+WorkScheduler::WorkScheduler(int count, int workers, int chunk)
+    : workers_(std::max(1, workers)),
+      count_(std::max(0, count)),
+      chunk_(std::max(1, chunk)) {}
+
+WorkScheduler::Status WorkScheduler::try_next(int worker, int* begin,
+                                              int* end) {
+    std::scoped_lock lock(mutex_);
+    return try_next_locked(worker, begin, end);
+}
+
+bool WorkScheduler::next(int worker, int* begin, int* end) {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        Status status = try_next_locked(worker, begin, end);
+        if (status != Status::kWait) {
+            return status == Status::kRange;
+        }
+        cv_.wait(lock);
+    }
+}
+
+void WorkScheduler::report(int worker, double records_per_second) {
+    {
+        std::scoped_lock lock(mutex_);
+        mark_reported_locked(worker, records_per_second);
+    }
+    cv_.notify_all();
+}
+
+void WorkScheduler::complete(int worker, int begin, int end) {
+    {
+        std::scoped_lock lock(mutex_);
+        unclaim_locked(&workers_[worker], begin, end);
+    }
+    // Waiting workers may now be done
+    cv_.notify_all();
+}
+
+void WorkScheduler::requeue(int worker, int begin, int end) {
+    {
+        std::scoped_lock lock(mutex_);
+        unclaim_locked(&workers_[worker], begin, end);
+        returned_.emplace_back(begin, end);
+    }
+    cv_.notify_all();
+}
+
+void WorkScheduler::retire(int worker) {
+    {
+        std::scoped_lock lock(mutex_);
+        Worker& self = workers_[worker];
+        self.retired = true;
+        returned_.insert(returned_.end(), self.claimed.begin(),
+                         self.claimed.end());
+        self.claimed.clear();
+        mark_reported_locked(worker, 0.0);
+    }
+    cv_.notify_all();
+}
+
+int WorkScheduler::unfinished() {
+    std::scoped_lock lock(mutex_);
+    int records = count_ - next_;
+    for (const Range& range : returned_) {
+        records += range.second - range.first;
+    }
+    for (const Worker& w : workers_) {
+        records += w.end - w.begin;
+        for (const Range& range : w.claimed) {
+            records += range.second - range.first;
+        }
+    }
+    return records;
+}
+
+double WorkScheduler::rate(int worker) {
+    std::scoped_lock lock(mutex_);
+    return workers_[worker].rate;
+}
+
+WorkScheduler::Status WorkScheduler::try_next_locked(int worker, int* begin,
+                                                     int* end) {
+    Worker& self = workers_[worker];
+    if (self.retired) {
+        return Status::kDone;
+    }
+
+    if (!partitioned_) {
+        if (self.state == State::kIdle) {
+            if (next_ < count_) {
+                // Calibration chunk straight from the shared front
+                const int first = next_;
+                next_ = std::min(count_, next_ + chunk_);
+                self.state = State::kCalibrating;
+                return claim_locked(&self, first, next_, begin, end);
+            }
+            // Nothing left to calibrate on
+            mark_reported_locked(worker, 0.0);
+            cv_.notify_all();
+        }
+        if (!partitioned_) {
+            return Status::kWait;
+        }
+    }
+
+    if (!returned_.empty()) {
+        const Range range = returned_.front();
+        returned_.pop_front();
+        return claim_locked(&self, range.first, range.second, begin, end);
+    }
+
+    if (self.begin >= self.end) {
+        // Steal the back half of the largest remaining partition
+        int victim = -1;
+        int largest = 0;
+        for (size_t i = 0; i < workers_.size(); i++) {
+            const int remaining = workers_[i].end - workers_[i].begin;
+            if (remaining > largest) {
+                largest = remaining;
+                victim = static_cast<int>(i);
+            }
+        }
+        if (victim < 0) {
+            // A live worker's claims could still fail and come back
+            for (const Worker& w : workers_) {
+                if (&w != &self && !w.retired && !w.claimed.empty()) {
+                    return Status::kWait;
+                }
+            }
+            return Status::kDone;
+        }
+        Worker& other = workers_[victim];
+        const int mid = (largest <= chunk_) ? other.begin
+                                            : other.begin + largest / 2;
+        self.begin = mid;
+        self.end = other.end;
+        other.end = mid;
+    }
+
+    const int first = self.begin;
+    self.begin = std::min(self.end, self.begin + chunk_);
+    return claim_locked(&self, first, self.begin, begin, end);
+}
+
+WorkScheduler::Status WorkScheduler::claim_locked(Worker* self, int begin,
+                                                  int end, int* out_begin,
+                                                  int* out_end) {
+    self->claimed.emplace_back(begin, end);
+    *out_begin = begin;
+    *out_end = end;
+    return Status::kRange;
+}
+
+void WorkScheduler::unclaim_locked(Worker* self, int begin, int end) {
+    auto it = std::find(self->claimed.begin(), self->claimed.end(),
+                        Range(begin, end));
+    if (it != self->claimed.end()) {
+        self->claimed.erase(it);
+    }
+}
+
+void WorkScheduler::mark_reported_locked(int worker, double rate) {
+    Worker& self = workers_[worker];
+    if (self.state == State::kReported) {
+        return;
+    }
+    self.state = State::kReported;
+    self.rate = rate;
+    reported_++;
+    if (reported_ == static_cast<int>(workers_.size()) && !partitioned_) {
+        partition_locked();
+    }
+}
+
+void WorkScheduler::partition_locked() {
+    partitioned_ = true;
+
+    double total = 0.0;
+    for (const Worker& w : workers_) {
+        if (!w.retired) {
+            total += w.rate;
+        }
+    }
+
+    const int remaining = count_ - next_;
+    if (remaining <= 0) {
+        return;
+    }
+
+    if (total <= 0.0) {
+        // No usable measurements: split evenly between live workers
+        for (Worker& w : workers_) {
+            w.rate = w.retired ? 0.0 : 1.0;
+            total += w.rate;
+        }
+        if (total <= 0.0) {
+            return;
+        }
+    }
+
+    int offset = next_;
+    int last = -1;
+    for (size_t i = 0; i < workers_.size(); i++) {
+        Worker& w = workers_[i];
+        const double share = w.retired ? 0.0 : w.rate / total;
+        const int size = static_cast<int>(remaining * share);
+        w.begin = offset;
+        w.end = offset + size;
+        offset = w.end;
+        if (!w.retired) {
+            last = static_cast<int>(i);
+        }
+    }
+    // Rounding leftovers go to the last live worker
+    if (last >= 0) {
+        workers_[last].end += count_ - offset;
+    }
+    next_ = count_;
+}
@@ -0,0 +1,115 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_WORK_SCHEDULER_H_
+#define CPP_APP_SRC_WORK_SCHEDULER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * Splits the record range [0, count) between workers of unequal speed.
+ *
+ * Every worker first claims one calibration chunk from the front of the
+ * range and reports its measured throughput. Once all workers reported,
+ * the rest is partitioned proportionally to throughput. Workers then take
+ * chunks from their own partition and, once it is empty, steal the back
+ * half of the largest remaining partition.
+ *
+ * Claimed ranges stay on their worker's books until complete(). A range
+ * whose batch failed (requeue()) and every range still held by a retired
+ * worker go back on a shared queue that the live workers drain first, so
+ * no record is dropped while a live worker remains. A worker is told
+ * kDone only when nothing is left to claim and no other live worker
+ * could still hand a range back.
+ */
+class WorkScheduler {
+ public:
+    enum class Status { kRange, kWait, kDone };
+
+    /**
+     * @param count Total number of records
+     * @param workers Number of workers (devices)
+     * @param chunk Records per claimed range (also the calibration size)
+     */
+    WorkScheduler(int count, int workers, int chunk);
+
+    /**
+     * Claim the next range without blocking.
+     * @return kRange with [*begin, *end) filled, kWait while calibration
+     *         of other workers is pending, kDone when no work is left
+     */
+    Status try_next(int worker, int* begin, int* end);
+
+    /**
+     * Claim the next range, blocking while calibration is pending.
+     * @return false when no work is left
+     */
+    bool next(int worker, int* begin, int* end);
+
+    /**
+     * Report throughput measured on the calibration chunk.
+     */
+    void report(int worker, double records_per_second);
+
+    /**
+     * A claimed range [begin, end) was processed.
+     */
+    void complete(int worker, int begin, int end);
+
+    /**
+     * A claimed range [begin, end) failed; a live worker takes it again.
+     */
+    void requeue(int worker, int begin, int end);
+
+    /**
+     * Remove a failed or finished worker; its unclaimed work is stolen by
+     * the others and the ranges it still held are requeued.
+     */
+    void retire(int worker);
+
+    /**
+     * Records nobody processed (no live worker was left to take them).
+     */
+    int unfinished();
+
+    /**
+     * Throughput reported by a worker (0 until calibrated).
+     */
+    double rate(int worker);
+
+ private:
+    enum class State { kIdle, kCalibrating, kReported };
+
+    using Range = std::pair<int, int>;   // [first, second)
+
+    struct Worker {
+        State state = State::kIdle;
+        bool retired = false;
+        double rate = 0.0;
+        int begin = 0;
+        int end = 0;
+        std::vector<Range> claimed;   // Handed out, not yet complete
+    };
+
+    Status try_next_locked(int worker, int* begin, int* end);
+    Status claim_locked(Worker* self, int begin, int end, int* out_begin,
+                        int* out_end);
+    void unclaim_locked(Worker* self, int begin, int end);
+    void mark_reported_locked(int worker, double rate);
+    void partition_locked();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Worker> workers_;
+    std::deque<Range> returned_;      // Requeued ranges, taken first
+    int count_;
+    int chunk_;
+    int next_ = 0;
+    int reported_ = 0;
+    bool partitioned_ = false;
+};
+
+#endif  // CPP_APP_SRC_WORK_SCHEDULER_H_
@@ -0,0 +1,376 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#include "src/worker_cluster.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/config.h"
+#include "src/metrics.h"
+#include "src/utils.h"
+#include "src/wire_protocol.h"
+
+namespace {
+
+void add_rows(const ServerTable& /*table*/, const RowRange& range,
+              std::vector<int32_t>* out) {
+    for (int32_t row = range.begin; row < range.end; row++) {
+        out->push_back(row);
+    }
+}
+
+void add_rows(const ServerTable& table, const IdBatch& ids,
+              std::vector<int32_t>* out) {
+    for (int id : ids) {
+        const int32_t row = table.row_of(id);
+        if (row != IdIndex::NO_ROW) {
+            out->push_back(row);
+        }
+    }
+}
+
+/**
+ * Take everything the upstream stage has published so far.
+ * @return false once the channel is closed and drained
+ */
+template <typename T>
+bool drain(const ServerTable& table, Channel<T>* input,
+           std::vector<int32_t>* out) {
+    T item;
+    while (true) {
+        switch (input->try_pop(&item)) {
+            case Channel<T>::PopResult::kItem:
+                add_rows(table, item, out);
+                break;
+            case Channel<T>::PopResult::kEmpty:
+                return true;
+            case Channel<T>::PopResult::kClosed:
+            default:
+                return false;
+        }
+    }
+}
+
+SocketMetrics* router_socket() {
+    static SocketMetrics* const socket = metrics().socket("cluster");
+    return socket;
+}
+
+void send_hello(zmq::socket_t* sock, const std::string& node) {
+    const Wire::HelloFrame hello{
+        .header = Wire::make_header(Wire::FrameKind::kHello, 0, false),
+        .capabilities = 0,
+        .reserved = 0
+    };
+    sock->send(zmq::buffer(node), zmq::send_flags::sndmore);
+    sock->send(zmq::buffer(&hello, sizeof(hello)), zmq::send_flags::none);
+    router_socket()->sent(node.size() + sizeof(hello));
+}
+
+}  // namespace
+
+/**
+ * State of the job being run.
+ */
+struct WorkerCluster::Job {
+    ServerTable* table = nullptr;
+    Channel<IdBatch>* passed = nullptr;
+    std::deque<Batch> pending;   // Cut, not yet assigned to a node
+    int64_t processed = 0;
+    int64_t passed_count = 0;
+    int requeued = 0;
+};
+
+zmq::socket_t* WorkerCluster::socket() {
+    if (!bound_) {
+        socket_ = zmq::socket_t(*context_, ZMQ_ROUTER);
+        socket_.bind(Config::ZMQ_ROUTER_ADDR);
+        bound_ = true;
+        std::cout << Color::YELLOW << "[Cluster] " << Color::RESET
+                  << "Nodes connect to " << Config::ZMQ_ROUTER_ADDR << "\n";
+    }
+    return &socket_;
+}
+
+void WorkerCluster::run(ServerTable* table, const ClusterSettings& settings,
+                        Channel<RowRange>* rows, Channel<IdBatch>* input,
+                        Channel<IdBatch>* passed) {
+    zmq::socket_t* sock = socket();
+    Job job;
+    job.table = table;
+    job.passed = passed;
+    for (auto& entry : nodes_) {
+        entry.second.processed = 0;
+        entry.second.batches = 0;
+    }
+
+    const size_t batch_size =
+        static_cast<size_t>(std::max(1, settings.batch_size));
+    std::vector<int32_t> filling;
+    bool input_open = true;
+    bool waiting_logged = false;
+
+    while (true) {
+        if (input_open) {
+            input_open = (input == nullptr) ? drain(*table, rows, &filling)
+                                            : drain(*table, input, &filling);
+            // Cut full batches; the last partial one once input is done
+            size_t begin = 0;
+            while (filling.size() - begin >= batch_size ||
+                   (!input_open && begin < filling.size())) {
+                const size_t end = std::min(filling.size(),
+                                            begin + batch_size);
+                Batch batch;
+                batch.id = next_batch_++;
+                batch.rows.assign(filling.begin() + begin,
+                                  filling.begin() + end);
+                job.pending.push_back(std::move(batch));
+                begin = end;
+            }
+            filling.erase(filling.begin(), filling.begin() + begin);
+        }
+
+        dispatch(&job);
+
+        const bool in_flight = std::any_of(
+            nodes_.begin(), nodes_.end(),
+            [](const auto& entry) { return !entry.second.in_flight.empty(); });
+        if (!input_open && job.pending.empty() && !in_flight) {
+            break;
+        }
+        if (nodes_.empty() && !job.pending.empty() && !waiting_logged) {
+            std::cout << Color::YELLOW << "[Cluster] " << Color::RESET
+                      << "Waiting for worker nodes\n";
+            waiting_logged = true;
+        }
+
+        zmq_pollitem_t item{sock->handle(), 0, ZMQ_POLLIN, 0};
+        zmq::poll(&item, 1,
+                  std::chrono::milliseconds(Config::PIPELINE_POLL_MS));
+        receive(&job);
+        drop_silent_nodes(&job);
+    }
+
+    for (const auto& [name, node] : nodes_) {
+        if (node.batches > 0) {
+            std::cout << Color::YELLOW << "[Cluster] " << Color::RESET
+                      << name << ": " << node.processed << " records, "
+                      << node.batches << " batch(es)\n";
+        }
+    }
+    std::cout << Color::YELLOW << "[Cluster] " << Color::RESET
+              << job.passed_count << "/" << job.processed << " passed on "
+              << nodes_.size() << " node(s), " << job.requeued
+              << " batch(es) reassigned\n";
+}
+
+void WorkerCluster::dispatch(Job* job) {
+    zmq::socket_t* sock = socket();
+    const ServerTable& table = *job->table;
+    for (auto& [name, node] : nodes_) {
+        while (!job->pending.empty()) {
+            Batch& batch = job->pending.front();
+            const auto count = static_cast<uint32_t>(batch.rows.size());
+            // A batch larger than the whole window goes once it is free
+            if (node.window == 0 ||
+                node.credits < std::min<int64_t>(count, node.window)) {
+                break;
+            }
+
+            zmq::message_t frame(
+                Wire::frame_size(Wire::FrameKind::kTasks, count));
+            char* out = static_cast<char*>(frame.data());
+            const Wire::FrameHeader header = Wire::make_header(
+                Wire::FrameKind::kTasks, count, false);
+            std::memcpy(out, &header, sizeof(header));
+            auto* ids = reinterpret_cast<int*>(out + sizeof(header));
+            auto* loads = reinterpret_cast<float*>(ids + count);
+            auto* uptimes = reinterpret_cast<int*>(loads + count);
+            for (uint32_t i = 0; i < count; i++) {
+                const int32_t row = batch.rows[i];
+                ids[i] = table.ids()[row];
+                loads[i] = table.loads()[row];
+                uptimes[i] = table.uptimes()[row];
+            }
+
+            sock->send(zmq::buffer(name), zmq::send_flags::sndmore);
+            sock->send(zmq::buffer(&batch.id, sizeof(batch.id)),
+                       zmq::send_flags::sndmore);
+            router_socket()->sent(name.size() + sizeof(batch.id) +
+                                  frame.size());
+            sock->send(frame, zmq::send_flags::none);
+
+            node.credits -= count;
+            const uint32_t id = batch.id;
+            node.in_flight.emplace(id, std::move(batch));
+            job->pending.pop_front();
+        }
+    }
+}
+
+void WorkerCluster::receive(Job* job) {
+    zmq::socket_t* sock = socket();
+    while (true) {
+        zmq::message_t identity;
+        if (!sock->recv(identity, zmq::recv_flags::dontwait)) {
+            return;
+        }
+        std::vector<zmq::message_t> parts;
+        size_t bytes = identity.size();
+        bool more = identity.more();
+        while (more) {
+            zmq::message_t part;
+            if (!sock->recv(part)) {
+                break;
+            }
+            more = part.more();
+            bytes += part.size();
+            parts.push_back(std::move(part));
+        }
+        router_socket()->received(bytes);
+        const std::string name = identity.to_string();
+
+        // Results and done come behind their batch id
+        uint32_t batch_id = 0;
+        size_t first = 0;
+        if (!parts.empty() && parts[0].size() == sizeof(batch_id)) {
+            std::memcpy(&batch_id, parts[0].data(), sizeof(batch_id));
+            first = 1;
+        }
+        Wire::FrameHeader header{};
+        if (first >= parts.size() ||
+            !Wire::parse_header(parts[first].data(), parts[first].size(),
+                                &header)) {
+            continue;
+        }
+        const zmq::message_t& frame = parts[first];
+
+        auto it = nodes_.find(name);
+        if (header.kind == Wire::FrameKind::kHello) {
+            if (it != nodes_.end()) {
+                // Restarted with the same id: its batches are gone
+                requeue(&it->second, job);
+            }
+            Node& node = nodes_[name];
+            node = Node{};
+            node.last_seen = Clock::now();
+            std::cout << Color::YELLOW << "[Cluster] " << Color::RESET
+                      << "Node " << name << " joined, " << nodes_.size()
+                      << " node(s)\n";
+            continue;
+        }
+        if (it == nodes_.end()) {
+            // Dropped earlier or registered with a previous process
+            send_hello(sock, name);
+            continue;
+        }
+
+        Node& node = it->second;
+        node.last_seen = Clock::now();
+        if (header.kind == Wire::FrameKind::kCredit) {
+            if (frame.size() == sizeof(Wire::CreditFrame)) {
+                node.credits += header.count;
+                node.window = std::max(node.window, node.credits);
+            }
+        } else if (header.kind == Wire::FrameKind::kResults) {
+            // Only results of batches this node still owns
+            const uint32_t n = header.count;
+            if (!node.in_flight.contains(batch_id) ||
+                frame.size() !=
+                    Wire::frame_size(Wire::FrameKind::kResults, n)) {
+                continue;
+            }
+            const char* data = static_cast<const char*>(frame.data()) +
+                               sizeof(Wire::FrameHeader);
+            IdBatch forwarded;
+            for (uint32_t i = 0; i < n; i++) {
+                int id = 0;
+                float stability = 0.0f;
+                std::memcpy(&id, data + Constants::ID_SIZE * i,
+                            Constants::ID_SIZE);
+                std::memcpy(&stability,
+                            data + Constants::ID_SIZE * n +
+                                Constants::FLOAT_SIZE * i,
+                            Constants::FLOAT_SIZE);
+                const int32_t row = job->table->row_of(id);
+                // A reassigned batch may repeat results
+                if (row == IdIndex::NO_ROW ||
+                    job->table->has_python_result(row)) {
+                    continue;
+                }
+                job->table->set_stability(row, stability);
+                forwarded.push_back(id);
+            }
+            job->passed_count += static_cast<int64_t>(forwarded.size());
+            if (job->passed != nullptr && !forwarded.empty()) {
+                job->passed->push(std::move(forwarded));
+            }
+        } else if (header.kind == Wire::FrameKind::kDone) {
+            auto batch = node.in_flight.find(batch_id);
+            if (batch == node.in_flight.end()) {
+                continue;
+            }
+            const auto count =
+                static_cast<int64_t>(batch->second.rows.size());
+            node.credits += count;
+            node.processed += count;
+            node.batches++;
+            job->processed += count;
+            node.in_flight.erase(batch);
+        }
+    }
+}
+
+void WorkerCluster::drop_silent_nodes(Job* job) {
+    const auto now = Clock::now();
+    const auto timeout = std::chrono::milliseconds(Config::NODE_TIMEOUT_MS);
+    for (auto it = nodes_.begin(); it != nodes_.end();) {
+        if (now - it->second.last_seen <= timeout) {
+            ++it;
+            continue;
+        }
+        const size_t batches = it->second.in_flight.size();
+        requeue(&it->second, job);
+        std::cout << Color::YELLOW << "[Cluster] " << Color::RESET
+                  << "Node " << it->first << " lost, " << batches
+                  << " batch(es) reassigned\n";
+        it = nodes_.erase(it);
+    }
+}
+
+void WorkerCluster::requeue(Node* node, Job* job) {
+    // Oldest first, ahead of the batches nobody has seen yet
+    for (auto it = node->in_flight.rbegin(); it != node->in_flight.rend();
+         ++it) {
+        job->pending.push_front(std::move(it->second));
+        job->requeued++;
+    }
+    node->in_flight.clear();
+}
+
+void cluster_thread(
+    WorkerCluster* cluster,
+    ServerTable* table,
+    const ClusterSettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed) {
+    TraceScope scope("cluster", "worker nodes");
+    try {
+        cluster->run(table, settings, rows, input, passed);
+    } catch (const std::exception& e) {
+        stage_errors()->add(1);
+        std::cerr << Color::RED << "[Cluster] " << e.what() << Color::RESET
+                  << "\n";
+    }
+
+    // Downstream stage must not wait forever, even after a failure
+    if (passed != nullptr) {
+        passed->close();
+    }
+}
@@ -0,0 +1,102 @@
+// Copyright 2026 IFF-3-2 Aleksandravicius Linas
+
+#ifndef CPP_APP_SRC_WORKER_CLUSTER_H_
+#define CPP_APP_SRC_WORKER_CLUSTER_H_
+
+#include <zmq.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/channel.h"
+#include "src/server_table.h"
+#include "src/types.h"
+
+/**
+ * Tunables for the cluster stage.
+ */
+struct ClusterSettings {
+    int batch_size;          // Records per routed batch
+};
+
+/**
+ * Filter 2 on remote worker nodes (python_app/node.py, --stability
+ * cluster). A ROUTER socket is bound on Config::ZMQ_ROUTER_ADDR; nodes
+ * connect as DEALERs, register and ask for work with credits, so batches
+ * go to whichever node has capacity. A node that is silent (no heartbeat)
+ * for Config::NODE_TIMEOUT_MS is dropped and its in-flight batches are
+ * handed to the others.
+ *
+ * The socket and the node registry are kept across jobs (daemon mode);
+ * one job at a time.
+ */
+class WorkerCluster {
+ public:
+    explicit WorkerCluster(zmq::context_t* context) : context_(context) {}
+
+    WorkerCluster(const WorkerCluster&) = delete;
+    WorkerCluster& operator=(const WorkerCluster&) = delete;
+
+    /**
+     * Run Filter 2 for one job on the connected nodes.
+     *
+     * @param table Server table; stability results are written lock-free
+     * @param settings Batching settings
+     * @param rows Row ranges published by the loader (used when input is
+     *             nullptr)
+     * @param input Ids to evaluate, pushed by an upstream stage
+     *              (nullptr = evaluate every loaded record)
+     * @param passed Receives the ids that passed Filter 2 (nullptr = not
+     *               chained); not closed here
+     */
+    void run(ServerTable* table, const ClusterSettings& settings,
+             Channel<RowRange>* rows, Channel<IdBatch>* input,
+             Channel<IdBatch>* passed);
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Batch {
+        uint32_t id = 0;
+        std::vector<int32_t> rows;
+    };
+
+    struct Node {
+        int64_t credits = 0;     // Records the node will still take
+        int64_t window = 0;      // Largest credit seen
+        Clock::time_point last_seen;
+        std::map<uint32_t, Batch> in_flight;
+        int64_t processed = 0;   // Per job
+        int batches = 0;         // Per job
+    };
+
+    zmq::socket_t* socket();
+
+    struct Job;
+    void dispatch(Job* job);
+    void receive(Job* job);
+    void drop_silent_nodes(Job* job);
+    void requeue(Node* node, Job* job);
+
+    zmq::context_t* context_;
+    zmq::socket_t socket_;
+    bool bound_ = false;
+    std::map<std::string, Node> nodes_;   // By routing id
+    uint32_t next_batch_ = 1;
+};
+
+/**
+ * Cluster thread function: WorkerCluster::run, then closes passed.
+ */
+void cluster_thread(
+    WorkerCluster* cluster,
+    ServerTable* table,
+    const ClusterSettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input,
+    Channel<IdBatch>* passed);
+
+#endif  // CPP_APP_SRC_WORKER_CLUSTER_H_
@@ -4,78 +4,581 @@
 
 #include <zmq.hpp>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
-#include <map>
-#include <thread>
+#include <memory>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "src/config.h"
+#include "src/metrics.h"
+#include "src/server_table.h"
 #include "src/utils.h"
+#include "src/wire_protocol.h"
 
-void sender_thread(const std::vector<ServerData>& servers) {
-    try {
-        zmq::context_t ctx(1);
-        zmq::socket_t sock(ctx, ZMQ_PUSH);
-        sock.connect(Config::ZMQ_PUSH_ADDR);
+namespace {
+
+/**
+ * Records sent but not yet granted back by the workers.
+ */
+Gauge* credits_in_flight() {
+    static Gauge* const gauge =
+        metrics().gauge("lygiagretus_wire_credits_in_flight", "");
+    return gauge;
+}
+
+SocketMetrics* tasks_socket() {
+    static SocketMetrics* const socket = metrics().socket("tasks");
+    return socket;
+}
+
+SocketMetrics* results_socket() {
+    static SocketMetrics* const socket = metrics().socket("results");
+    return socket;
+}
+
+void send_server(zmq::socket_t* sock, int id, float load, int uptime) {
+    std::array<char, Constants::MSG_SIZE> buf{};
+    std::memcpy(buf.data(), &id, Constants::ID_SIZE);
+    std::memcpy(buf.data() + Constants::ID_SIZE,
+                &load, Constants::FLOAT_SIZE);
+    std::memcpy(buf.data() + Constants::ID_SIZE + Constants::FLOAT_SIZE,
+                &uptime, Constants::UPTIME_SIZE);
+
+    zmq::message_t msg(Constants::MSG_SIZE);
+    std::memcpy(msg.data(), buf.data(), Constants::MSG_SIZE);
+    sock->send(msg, zmq::send_flags::none);
+    tasks_socket()->sent(Constants::MSG_SIZE);
+}
+
+/**
+ * Collects records into column batches and sends them as batch frames,
+ * or one legacy message per record when the batch size is 1. With credits
+ * every batch waits for window space first. With a ring the columns are
+ * written straight into a free slot and a slot frame is sent instead; the
+ * gate wakes it when the receiver releases a slot. Every send first waits
+ * for the socket to take the message.
+ */
+class TaskBatcher {
+ public:
+    TaskBatcher(Executor* executor, zmq::socket_t* sock,
+                const ServerTable& table, const WireSettings& settings,
+                CreditGate* credits, bool credited, ShmRing* ring)
+        : executor_(executor), sock_(sock), table_(table),
+          settings_(settings), credits_(credits), credited_(credited),
+          ring_(ring) {}
+
+    Task add(int32_t row) {
+        const int id = table_.ids()[row];
+        const float load = table_.loads()[row];
+        const int uptime = table_.uptimes()[row];
+        if (ring_ != nullptr) {
+            co_await add_to_slot(id, load, uptime);
+            co_return;
+        }
+        if (settings_.batch_size <= 1) {
+            co_await executor_->writable(sock_);
+            send_server(sock_, id, load, uptime);
+            sent_++;
+            co_return;
+        }
+        ids_.push_back(id);
+        loads_.push_back(load);
+        uptimes_.push_back(uptime);
+        if (static_cast<int>(ids_.size()) >= settings_.batch_size) {
+            co_await flush();
+        }
+    }
+
+    /**
+     * Add a contiguous run of rows. With multipart frames, full batches
+     * reference the table columns directly instead of being copied.
+     */
+    Task add_range(int32_t begin, int32_t end) {
+        const int batch = settings_.batch_size;
+        if (settings_.multipart && batch > 1 && ring_ == nullptr) {
+            co_await flush();  // Keep records in order
+            while (end - begin >= batch) {
+                co_await send_columns(begin, batch);
+                begin += batch;
+            }
+        }
+        for (int32_t row = begin; row < end; row++) {
+            co_await add(row);
+        }
+    }
+
+    Task flush() {
+        if (ring_ != nullptr) {
+            co_await flush_slot();
+            co_return;
+        }
+        if (ids_.empty()) {
+            co_return;
+        }
+        const auto count = static_cast<uint32_t>(ids_.size());
+        co_await wait_for_credits(count);
+        co_await executor_->writable(sock_);
+        const Wire::FrameHeader header = Wire::make_header(
+            Wire::FrameKind::kTasks, count, settings_.multipart);
+
+        if (settings_.multipart) {
+            sock_->send(zmq::buffer(&header, sizeof(header)),
+                        zmq::send_flags::sndmore);
+            sock_->send(zmq::buffer(ids_), zmq::send_flags::sndmore);
+            sock_->send(zmq::buffer(loads_), zmq::send_flags::sndmore);
+            sock_->send(zmq::buffer(uptimes_), zmq::send_flags::none);
+            tasks_socket()->sent(
+                Wire::frame_size(Wire::FrameKind::kTasks, count));
+        } else {
+            zmq::message_t msg(
+                Wire::frame_size(Wire::FrameKind::kTasks, count));
+            char* out = static_cast<char*>(msg.data());
+            std::memcpy(out, &header, sizeof(header));
+            out += sizeof(header);
+            std::memcpy(out, ids_.data(), Constants::ID_SIZE * count);
+            out += Constants::ID_SIZE * count;
+            std::memcpy(out, loads_.data(), Constants::FLOAT_SIZE * count);
+            out += Constants::FLOAT_SIZE * count;
+            std::memcpy(out, uptimes_.data(), Constants::UPTIME_SIZE * count);
+            sock_->send(msg, zmq::send_flags::none);
+            tasks_socket()->sent(msg.size());
+        }
+
+        sent_ += count;
+        ids_.clear();
+        loads_.clear();
+        uptimes_.clear();
+    }
+
+    size_t sent() const { return sent_; }
+    size_t dropped() const { return dropped_; }
+
+ private:
+    // A queued part can outlive the job (a socket that lingers, a worker
+    // that never answers), so attached columns are sent as zero-copy
+    // parts holding a reference to their backing, released by ZMQ once
+    // the part is sent. Owned columns may move as the table grows and
+    // are copied.
+    template <typename T>
+    void send_part(std::span<const T> column, int32_t begin, int count,
+                   zmq::send_flags flags) {
+        const T* data = column.data() + begin;
+        const size_t bytes = sizeof(T) * count;
+        if (!table_.backing()) {
+            zmq::message_t part(data, bytes);
+            sock_->send(part, flags);
+            return;
+        }
+        auto* owner = new std::shared_ptr<const void>(table_.backing());
+        zmq::message_t part(const_cast<T*>(data), bytes, release_backing,
+                            owner);
+        sock_->send(part, flags);
+    }
 
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(Constants::SLEEP_MS));
+    static void release_backing(void* /*data*/, void* hint) {
+        delete static_cast<std::shared_ptr<const void>*>(hint);
+    }
+
+    Task wait_for_credits(uint32_t count) {
+        if (credited_) {
+            TraceScope wait("sender", "credit wait");
+            co_await credits_->acquire(count);
+        }
+    }
+
+    Task add_to_slot(int id, float load, int uptime) {
+        if (filled_ == 0) {
+            bool acquired = false;
+            co_await acquire_slot(&acquired);
+            if (!acquired) {
+                dropped_++;  // The workers cannot answer (receive_results)
+                co_return;
+            }
+        }
+        ring_->ids(slot_)[filled_] = id;
+        ring_->loads(slot_)[filled_] = load;
+        ring_->uptimes(slot_)[filled_] = uptime;
+        if (++filled_ == ring_->slot_records()) {
+            co_await flush_slot();
+        }
+    }
+
+    /**
+     * Take a free slot, waiting for the receiver to release one.
+     */
+    Task acquire_slot(bool* acquired) {
+        TraceScope wait("sender", "slot wait");
+        ShmRing::Acquire status;
+        while ((status = ring_->try_acquire(&slot_)) ==
+               ShmRing::Acquire::kFull) {
+            co_await credits_->changed();
+        }
+        *acquired = (status == ShmRing::Acquire::kSlot);
+    }
+
+    Task flush_slot() {
+        if (filled_ == 0) {
+            co_return;
+        }
+        Wire::SlotFrame frame{
+            .header = Wire::make_header(Wire::FrameKind::kTasks, filled_,
+                                        false),
+            .slot = slot_,
+            .passed = 0
+        };
+        frame.header.flags |= Wire::FLAG_SHM;
+        co_await executor_->writable(sock_);
+        sock_->send(zmq::buffer(&frame, sizeof(frame)),
+                    zmq::send_flags::none);
+        tasks_socket()->sent(sizeof(frame));
+        sent_ += filled_;
+        filled_ = 0;
+    }
+
+    Task send_columns(int32_t begin, int count) {
+        co_await wait_for_credits(static_cast<uint32_t>(count));
+        co_await executor_->writable(sock_);
+        const Wire::FrameHeader header = Wire::make_header(
+            Wire::FrameKind::kTasks, static_cast<uint32_t>(count), true);
+        sock_->send(zmq::buffer(&header, sizeof(header)),
+                    zmq::send_flags::sndmore);
+        send_part(table_.ids(), begin, count, zmq::send_flags::sndmore);
+        send_part(table_.loads(), begin, count, zmq::send_flags::sndmore);
+        send_part(table_.uptimes(), begin, count, zmq::send_flags::none);
+        tasks_socket()->sent(Wire::frame_size(
+            Wire::FrameKind::kTasks, static_cast<uint32_t>(count)));
+        sent_ += count;
+    }
+
+    Executor* executor_;
+    zmq::socket_t* sock_;
+    const ServerTable& table_;
+    WireSettings settings_;
+    CreditGate* credits_;
+    bool credited_;          // Batches wait for the workers' credits
+    ShmRing* ring_;
+    uint32_t slot_ = 0;
+    uint32_t filled_ = 0;    // Records in the current slot
+    std::vector<int> ids_;
+    std::vector<float> loads_;
+    std::vector<int> uptimes_;
+    size_t sent_ = 0;
+    size_t dropped_ = 0;
+};
+
+/**
+ * Offer the batch size to the workers; they answer with the size they
+ * will use for results.
+ */
+void send_hello(zmq::socket_t* sock, const WireSettings& settings,
+                bool credits, const ShmRing* ring) {
+    const uint32_t batch_size =
+        (ring != nullptr) ? ring->slot_records()
+                          : static_cast<uint32_t>(settings.batch_size);
+    const Wire::HelloFrame hello{
+        .header = Wire::make_header(Wire::FrameKind::kHello, batch_size,
+                                    false),
+        .capabilities = (settings.multipart ? Wire::CAP_MULTIPART : 0u) |
+                        (credits ? Wire::CAP_CREDITS : 0u) |
+                        (ring != nullptr ? Wire::CAP_SHM : 0u),
+        .reserved = 0
+    };
+    sock->send(zmq::buffer(&hello, sizeof(hello)), zmq::send_flags::none);
+    tasks_socket()->sent(sizeof(hello));
+}
+
+/**
+ * Write a column of results into the table.
+ * @return Number of results applied
+ */
+int apply_results(
+    const int* ids,
+    const float* stabilities,
+    uint32_t count,
+    ServerTable* table,
+    Channel<IdBatch>* passed) {
+    IdBatch batch(count);
+    std::memcpy(batch.data(), ids, Constants::ID_SIZE * count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        float stability = 0.0f;
+        std::memcpy(&stability, stabilities + i, Constants::FLOAT_SIZE);
+        const int32_t row = table->row_of(batch[i]);
+        if (row != IdIndex::NO_ROW) {
+            table->set_stability(row, stability);
+        }
+    }
+    if (passed != nullptr) {
+        passed->push(std::move(batch));
+    }
+    return static_cast<int>(count);
+}
 
-        // Send all server data
-        for (const auto& server : servers) {
-            std::array<char, Constants::MSG_SIZE> buf{};
-            std::memcpy(buf.data(), &server.id, Constants::ID_SIZE);
-            std::memcpy(buf.data() + Constants::ID_SIZE,
-                        &server.load, Constants::FLOAT_SIZE);
-            std::memcpy(buf.data() + Constants::ID_SIZE + Constants::FLOAT_SIZE,
-                        &server.uptime, Constants::UPTIME_SIZE);
+/**
+ * Take the results of an answered ring slot: records flagged as passed
+ * get their stability.
+ * @return Number of records that passed
+ */
+int apply_slot(
+    ShmRing* ring,
+    uint32_t slot,
+    uint32_t count,
+    ServerTable* table,
+    Channel<IdBatch>* passed) {
+    const int* ids = ring->ids(slot);
+    const float* stabilities = ring->stabilities(slot);
+    const uint8_t* flags = ring->passed(slot);
 
-            zmq::message_t msg(Constants::MSG_SIZE);
-            std::memcpy(msg.data(), buf.data(), Constants::MSG_SIZE);
-            sock.send(msg, zmq::send_flags::none);
+    IdBatch batch;
+    for (uint32_t i = 0; i < count; i++) {
+        if (flags[i] == 0) {
+            continue;
         }
+        const int32_t row = table->row_of(ids[i]);
+        if (row != IdIndex::NO_ROW) {
+            table->set_stability(row, stabilities[i]);
+        }
+        batch.push_back(ids[i]);
+    }
+    const auto applied = static_cast<int>(batch.size());
+    if (passed != nullptr && !batch.empty()) {
+        passed->push(std::move(batch));
+    }
+    return applied;
+}
+
+Task add_rows(TaskBatcher* batcher, const ServerTable& /*table*/,
+              const RowRange& range) {
+    co_await batcher->add_range(range.begin, range.end);
+}
+
+Task add_rows(TaskBatcher* batcher, const ServerTable& table,
+              const IdBatch& ids) {
+    for (int id : ids) {
+        const int32_t row = table.row_of(id);
+        if (row != IdIndex::NO_ROW) {
+            co_await batcher->add(row);
+        }
+    }
+}
+
+/**
+ * Send everything an upstream stage pushes until it closes the channel.
+ */
+template <typename T>
+Task send_stream(Executor* executor, TaskBatcher* batcher,
+                 const ServerTable& table, Channel<T>* input) {
+    T item;
+    while (true) {
+        const auto status = input->try_pop(&item);
+        if (status == Channel<T>::PopResult::kClosed) {
+            break;
+        }
+        if (status == Channel<T>::PopResult::kEmpty) {
+            // Upstream is momentarily dry: do not hold records back
+            co_await batcher->flush();
+            co_await executor->ready(input);
+            continue;
+        }
+        co_await add_rows(batcher, table, item);
+    }
+}
+
+}  // namespace
+
+void CreditGate::grant(uint32_t records) {
+    available_ += records;
+    window_ = std::max(window_, available_);
+    credits_in_flight()->set(window_ - available_);
+    changed_.notify();
+}
+
+Task CreditGate::acquire(uint32_t records) {
+    // A batch larger than the whole window goes once the window is free
+    auto ready = [&] {
+        return closed_ ||
+               (window_ > 0 &&
+                available_ >= std::min<int64_t>(records, window_));
+    };
+    if (!ready()) {
+        stalls_++;
+        while (!ready()) {
+            co_await changed_.wait();
+        }
+    }
+    if (!closed_) {
+        available_ -= records;
+        credits_in_flight()->set(window_ - available_);
+    }
+}
+
+void CreditGate::close() {
+    closed_ = true;
+    changed_.notify();
+}
+
+zmq::socket_t* WorkerLink::tasks(bool* connected) {
+    *connected = !tasks_open_;
+    if (!tasks_open_) {
+        tasks_ = zmq::socket_t(*context_, ZMQ_PUSH);
+        tasks_.connect(transport_ == WireTransport::kTcp
+                           ? Config::ZMQ_PUSH_ADDR
+                           : Config::ZMQ_PUSH_IPC_ADDR);
+        tasks_open_ = true;
+    }
+    return &tasks_;
+}
+
+zmq::socket_t* WorkerLink::results() {
+    if (!results_open_) {
+        results_ = zmq::socket_t(*context_, ZMQ_PULL);
+        results_.bind(transport_ == WireTransport::kTcp
+                          ? Config::ZMQ_PULL_ADDR
+                          : Config::ZMQ_PULL_IPC_ADDR);
+        results_open_ = true;
+    }
+    return &results_;
+}
+
+ShmRing* WorkerLink::ring() {
+    if (transport_ != WireTransport::kShm) {
+        return nullptr;
+    }
+    // Sender and receiver both ask at the start of a job, on the control
+    // thread
+    if (!ring_.is_open()) {
+        ring_.create(Config::SHM_RING_NAME,
+                     static_cast<uint32_t>(Config::SHM_RING_SLOTS),
+                     static_cast<uint32_t>(Config::SHM_SLOT_RECORDS));
+    }
+    return &ring_;
+}
+
+Task send_tasks(
+    Executor* executor,
+    WorkerLink* link,
+    CreditGate* credits,
+    const ServerTable& table,
+    const WireSettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input) {
+    TraceScope scope("sender", "send tasks");
+    try {
+        bool connected = false;
+        zmq::socket_t& sock = *link->tasks(&connected);
+        if (connected) {
+            // Give the workers time to join before the first job
+            co_await executor->sleep_for(
+                std::chrono::milliseconds(Constants::SLEEP_MS));
+        }
+        ShmRing* ring = link->ring();
+        if (ring != nullptr) {
+            ring->reset();
+        }
+
+        // Credits need the hello exchange, i.e. batch frames; the ring's
+        // free slots already bound what the workers hold
+        const bool batched = settings.batch_size > 1 || ring != nullptr;
+        const bool credited = batched && settings.credits && ring == nullptr;
+        if (batched) {
+            co_await executor->writable(&sock);
+            send_hello(&sock, settings, credited, ring);
+        }
+
+        TaskBatcher batcher(executor, &sock, table, settings, credits,
+                            credited, ring);
+        if (input == nullptr) {
+            // Send every record as the loader publishes it
+            co_await send_stream(executor, &batcher, table, rows);
+        } else {
+            // Send only the ids forwarded by the upstream filter
+            co_await send_stream(executor, &batcher, table, input);
+        }
+        co_await batcher.flush();
 
         // Send stop signal
+        co_await executor->writable(&sock);
         zmq::message_t stop(1);
         *static_cast<unsigned char*>(stop.data()) = Constants::STOP_SIGNAL;
         sock.send(stop, zmq::send_flags::none);
+        tasks_socket()->sent(1);
 
         std::cout << Color::YELLOW << "[Sender] " << Color::RESET
-                  << "Sent " << servers.size() << " records\n";
+                  << "Sent " << batcher.sent() << " records";
+        if (credited) {
+            std::cout << ", waited for credits " << credits->stalls()
+                      << " time(s)";
+        }
+        if (ring != nullptr) {
+            std::cout << " through shared memory, waited for a slot "
+                      << ring->stalls() << " time(s)";
+        }
+        std::cout << "\n";
+        if (batcher.dropped() > 0) {
+            stage_errors()->add(1);
+            std::cerr << Color::RED << "[Sender] " << batcher.dropped()
+                      << " records not sent, no shared-memory workers"
+                      << Color::RESET << "\n";
+        }
     } catch (const std::exception& e) {
+        stage_errors()->add(1);
         std::cerr << Color::RED << "[Sender] " << e.what()
                   << Color::RESET << "\n";
     }
 }
 
-void receiver_thread(
-    std::map<int, ServerResult>* results,
-    std::mutex* mutex) {
+Task receive_results(
+    Executor* executor,
+    WorkerLink* link,
+    CreditGate* credits,
+    ServerTable* table,
+    Channel<IdBatch>* passed) {
+    TraceScope scope("receiver", "receive results");
+    ShmRing* ring = nullptr;
     try {
-        zmq::context_t ctx(1);
-        zmq::socket_t sock(ctx, ZMQ_PULL);
-        sock.bind(Config::ZMQ_PULL_ADDR);
+        zmq::socket_t& sock = *link->results();
+        ring = link->ring();
 
         int count = 0;
 
         while (true) {
+            co_await executor->readable(&sock);
             zmq::message_t msg;
-            if (!sock.recv(msg)) {
+            if (!sock.recv(msg, zmq::recv_flags::dontwait)) {
                 continue;
             }
 
+            // Collect the remaining parts of a multipart batch (they
+            // arrive with the first)
+            std::vector<zmq::message_t> parts;
+            size_t bytes = msg.size();
+            bool more = msg.more();
+            while (more) {
+                zmq::message_t part;
+                if (!sock.recv(part)) {
+                    break;
+                }
+                more = part.more();
+                bytes += part.size();
+                parts.push_back(std::move(part));
+            }
+            results_socket()->received(bytes);
+
             // Check for stop signal
-            if (msg.size() == 1 &&
+            if (parts.empty() && msg.size() == 1 &&
                 *static_cast<unsigned char*>(msg.data()) ==
                     Constants::STOP_SIGNAL) {
                 break;
             }
 
-            // Parse result message
-            if (msg.size() == Constants::MSG_RESULT_SIZE) {
+            // Legacy single-record result
+            if (parts.empty() && msg.size() == Constants::MSG_RESULT_SIZE) {
                 int id = 0;
                 float stability = 0.0f;
 
@@ -83,21 +586,109 @@ void receiver_thread(
                 std::memcpy(&stability,
                             static_cast<char*>(msg.data()) + Constants::ID_SIZE,
                             Constants::FLOAT_SIZE);
+                count += apply_results(&id, &stability, 1, table,
+                                       passed);
+                continue;
+            }
+
+            Wire::FrameHeader header{};
+            if (!Wire::parse_header(msg.data(), msg.size(), &header)) {
+                continue;  // Unknown frame
+            }
 
-                std::scoped_lock lock(*mutex);
-                auto it = results->find(id);
-                if (it != results->end()) {
-                    it->second.stability = stability;
-                    it->second.has_python_result = true;
+            if (header.kind == Wire::FrameKind::kCredit) {
+                if (parts.empty() &&
+                    msg.size() == sizeof(Wire::CreditFrame)) {
+                    credits->grant(header.count);
                 }
-                count++;
+                continue;
+            }
+
+            if (header.kind == Wire::FrameKind::kHello) {
+                Wire::HelloFrame hello{};
+                if (msg.size() == sizeof(hello)) {
+                    std::memcpy(&hello, msg.data(), sizeof(hello));
+                }
+                const bool granted = hello.capabilities & Wire::CAP_CREDITS;
+                if (!granted) {
+                    // No flow control from these workers
+                    credits->close();
+                }
+                if (ring != nullptr) {
+                    if (!(hello.capabilities & Wire::CAP_SHM)) {
+                        std::cerr << Color::RED << "[Receiver] Workers "
+                                  << "cannot use shared memory"
+                                  << Color::RESET << "\n";
+                        ring->stop();
+                        credits->slot_released();
+                    } else {
+                        std::cout << Color::MAGENTA << "[Receiver] "
+                                  << Color::RESET << "Workers answer "
+                                  << "through shared memory\n";
+                    }
+                    continue;
+                }
+                std::cout << Color::MAGENTA << "[Receiver] " << Color::RESET
+                          << "Workers batch results by " << header.count
+                          << (granted ? ", credit flow control" : "")
+                          << "\n";
+                continue;
+            }
+            if (header.kind != Wire::FrameKind::kResults) {
+                continue;
+            }
+
+            const uint32_t n = header.count;
+            if (header.flags & Wire::FLAG_SHM) {
+                Wire::SlotFrame frame{};
+                if (ring != nullptr && parts.empty() &&
+                    msg.size() == sizeof(frame)) {
+                    std::memcpy(&frame, msg.data(), sizeof(frame));
+                    if (frame.slot < ring->slots() &&
+                        n <= ring->slot_records()) {
+                        count += apply_slot(ring, frame.slot, n, table,
+                                            passed);
+                        ring->release(frame.slot);
+                        credits->slot_released();
+                    }
+                }
+            } else if (header.flags & Wire::FLAG_MULTIPART) {
+                if (parts.size() == 2 &&
+                    parts[0].size() == Constants::ID_SIZE * n &&
+                    parts[1].size() == Constants::FLOAT_SIZE * n) {
+                    count += apply_results(
+                        static_cast<const int*>(parts[0].data()),
+                        static_cast<const float*>(parts[1].data()),
+                        n, table, passed);
+                }
+            } else if (msg.size() ==
+                       Wire::frame_size(Wire::FrameKind::kResults, n)) {
+                const char* data =
+                    static_cast<const char*>(msg.data()) +
+                    sizeof(Wire::FrameHeader);
+                count += apply_results(
+                    reinterpret_cast<const int*>(data),
+                    reinterpret_cast<const float*>(
+                        data + Constants::ID_SIZE * n),
+                    n, table, passed);
             }
         }
 
         std::cout << Color::MAGENTA << "[Receiver] " << Color::RESET
                   << "Received " << count << " results\n";
     } catch (const std::exception& e) {
+        stage_errors()->add(1);
         std::cerr << Color::RED << "[Receiver] " << e.what()
                   << Color::RESET << "\n";
     }
+
+    // Neither the sender nor the downstream stage may wait forever, even
+    // after a failure
+    credits->close();
+    if (ring != nullptr) {
+        ring->stop();
+    }
+    if (passed != nullptr) {
+        passed->close();
+    }
 }
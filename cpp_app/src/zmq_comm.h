@@ -3,29 +3,163 @@
 #ifndef CPP_APP_SRC_ZMQ_COMM_H_
 #define CPP_APP_SRC_ZMQ_COMM_H_
 
-#include <map>
-#include <mutex>
-#include <vector>
+#include <zmq.hpp>
 
+#include <cstdint>
+
+#include "src/channel.h"
+#include "src/executor.h"
+#include "src/options.h"
+#include "src/server_table.h"
+#include "src/shm_ring.h"
 #include "src/types.h"
 
 /**
- * Sender thread function.
- * Sends server data to Python workers via ZMQ PUSH socket.
+ * Wire format used by the sender.
+ */
+struct WireSettings {
+    int batch_size;          // Records per batch frame (1 = legacy format)
+    bool multipart;          // Send batch columns as separate parts
+    bool credits;            // Offer credit-based flow control (batches)
+};
+
+/**
+ * Flow control from the receiver to the sender of a job: task records the
+ * workers are ready to take, granted by their credit frames (see
+ * wire_protocol.h), and the shared-memory slots they have answered. The
+ * receiver grants, the sender waits before each batch. Once closed (no
+ * credits negotiated, or the receiver has ended) the sender no longer
+ * waits. Both run on the executor's control thread.
+ */
+class CreditGate {
+ public:
+    explicit CreditGate(Executor* executor) : changed_(executor) {}
+
+    void grant(uint32_t records);
+
+    /**
+     * Wait until records may be sent and take them from the window.
+     */
+    Task acquire(uint32_t records);
+
+    /**
+     * A ring slot was released: wake a sender waiting for one.
+     */
+    void slot_released() { changed_.notify(); }
+
+    /**
+     * Wait for the next grant, released slot or close().
+     */
+    auto changed() { return changed_.wait(); }
+
+    void close();
+
+    /**
+     * Number of times acquire() had to wait.
+     */
+    int stalls() const { return stalls_; }
+
+ private:
+    Wakeup changed_;
+    int64_t available_ = 0;  // May go negative after an oversized batch
+    int64_t window_ = 0;     // Largest window granted so far
+    bool closed_ = false;
+    int stalls_ = 0;
+};
+
+/**
+ * Sockets to the Python workers, opened on first use and kept for every
+ * later job (daemon mode). Only the first job waits for the workers to
+ * join (Constants::SLEEP_MS). The sender and receiver coroutines of one
+ * job each own one socket; jobs must not overlap.
+ *
+ * The ipc and shm transports use Unix domain sockets; shm also keeps the
+ * record ring (see ShmRing) for the link's lifetime.
+ */
+class WorkerLink {
+ public:
+    explicit WorkerLink(zmq::context_t* context,
+                        WireTransport transport = WireTransport::kTcp)
+        : context_(context), transport_(transport) {}
+
+    WorkerLink(const WorkerLink&) = delete;
+    WorkerLink& operator=(const WorkerLink&) = delete;
+
+    /**
+     * PUSH socket connected to the workers' task receiver.
+     * @param connected Set when this call connected it (the workers have
+     *                  yet to join)
+     */
+    zmq::socket_t* tasks(bool* connected);
+
+    /**
+     * PULL socket bound for the workers' results.
+     */
+    zmq::socket_t* results();
+
+    /**
+     * Shared-memory ring, created on first use (nullptr unless the
+     * transport is shm).
+     */
+    ShmRing* ring();
+
+ private:
+    zmq::context_t* context_;
+    WireTransport transport_;
+    ShmRing ring_;
+    zmq::socket_t tasks_;
+    zmq::socket_t results_;
+    bool tasks_open_ = false;
+    bool results_open_ = false;
+};
+
+/**
+ * Sender coroutine.
+ * Sends server data to Python workers via ZMQ PUSH socket, either one
+ * legacy message per record or as batch frames (see wire_protocol.h).
+ * With the shm transport records are written to ring slots and only slot
+ * frames are sent. A stop signal ends the job. Waits for the upstream
+ * channel, socket and credits on the executor.
  *
- * @param servers Server data to send
+ * @param executor Runs the coroutine
+ * @param link Worker sockets
+ * @param credits Flow control shared with the receiver
+ * @param table Server table to send from
+ * @param settings Wire format settings
+ * @param rows Row ranges published by the loader (used when input is
+ *             nullptr)
+ * @param input Ids to send, pushed by an upstream stage
+ *              (nullptr = send every loaded record)
  */
-void sender_thread(const std::vector<ServerData>& servers);
+Task send_tasks(
+    Executor* executor,
+    WorkerLink* link,
+    CreditGate* credits,
+    const ServerTable& table,
+    const WireSettings& settings,
+    Channel<RowRange>* rows,
+    Channel<IdBatch>* input);
 
 /**
- * Receiver thread function.
+ * Receiver coroutine.
  * Receives stability results from Python workers via ZMQ PULL socket.
+ * Accepts legacy single-record messages and batch frames. Returns on the
+ * workers' stop signal for the job. Credit frames are handed to the
+ * sender through credits, which is closed when the coroutine ends;
+ * answered ring slots are released to the sender the same way.
  *
- * @param results Output map for results (thread-safe access)
- * @param mutex Mutex for thread-safe result updates
+ * @param executor Runs the coroutine
+ * @param link Worker sockets
+ * @param credits Flow control shared with the sender
+ * @param table Server table; stability results are written lock-free
+ * @param passed Receives the ids that passed Filter 2
+ *               (nullptr = not chained); closed when the coroutine ends
  */
-void receiver_thread(
-    std::map<int, ServerResult>* results,
-    std::mutex* mutex);
+Task receive_results(
+    Executor* executor,
+    WorkerLink* link,
+    CreditGate* credits,
+    ServerTable* table,
+    Channel<IdBatch>* passed);
 
 #endif  // CPP_APP_SRC_ZMQ_COMM_H_
@@ -9,6 +9,32 @@ import multiprocessing
 ZMQ_PULL_ADDR = "tcp://127.0.0.1:5557"
 ZMQ_PUSH_ADDR = "tcp://127.0.0.1:5558"
 
+# Same-host sockets (--transport ipc / shm)
+IPC_PULL_ADDR = "ipc:///tmp/lygiagretus_tasks"
+IPC_PUSH_ADDR = "ipc:///tmp/lygiagretus_results"
+
+# Shared-memory ring created by C++ (--transport shm) and records per
+# worker task taken from a slot
+SHM_RING_NAME = "lygiagretus_wire"
+SHM_CHUNK_RECORDS = 4
+
+# C++ router for worker nodes (node.py --connect overrides it)
+CLUSTER_ADDR = "tcp://127.0.0.1:5560"
+
+# Largest batch frame the workers agree to send back
+WIRE_BATCH_MAX = 256
+
+# Seconds a partial result batch may wait before it is flushed
+RESULT_FLUSH_INTERVAL = 0.05
+
+# Credit window per worker, in result batches (flow control)
+CREDIT_BATCHES_PER_WORKER = 2
+
+# Worker nodes: seconds between heartbeats (C++ drops a node after 5 s of
+# silence) and batch size the credit window is sized for
+HEARTBEAT_INTERVAL = 1.0
+CLUSTER_CREDIT_BATCH = 16
+
 # Computation parameters
 STABILITY_ITERATIONS = 600_000
 STABILITY_THRESHOLD = 50.0
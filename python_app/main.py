@@ -11,6 +11,11 @@ Architecture:
 - Worker processes: compute stability scores (N-1 CPU cores)
 - Sender process: sends filtered results back to C++
 
+With --serve the processes stay up and handle one job per C++ stop
+signal (for main_app --serve), so workers and sockets are set up once.
+--transport ipc|shm (as main_app --wire-transport) uses Unix domain
+sockets; with shm the records themselves stay in shared memory.
+
 Performance (300 records):
 - Single worker: ~54 seconds
 - Full parallelization: ~10 seconds
@@ -18,10 +23,11 @@ Performance (300 records):
 
 import sys
 import time
-from multiprocessing import Process, Queue, Value
+from multiprocessing import Array, Barrier, Process, Queue, Value
 
 from colors import Color
-from config import STABILITY_ITERATIONS, get_worker_count
+from config import IPC_PULL_ADDR, IPC_PUSH_ADDR, STABILITY_ITERATIONS, \
+    ZMQ_PULL_ADDR, ZMQ_PUSH_ADDR, get_worker_count
 from processes import receiver_process, sender_process, worker_process
 
 
@@ -35,6 +41,15 @@ def parse_args() -> int:
     return get_worker_count(use_half_cpu)
 
 
+def parse_transport() -> str:
+    """Value of --transport (tcp, ipc or shm)."""
+    if "--transport" in sys.argv:
+        index = sys.argv.index("--transport")
+        if index + 1 < len(sys.argv):
+            return sys.argv[index + 1]
+    return "tcp"
+
+
 def main() -> None:
     """Main entry point."""
     print(
@@ -43,10 +58,16 @@ def main() -> None:
     )
 
     num_workers = parse_args()
+    serve = "--serve" in sys.argv
+    transport = parse_transport()
+    pull_addr, push_addr = (ZMQ_PULL_ADDR, ZMQ_PUSH_ADDR) \
+        if transport == "tcp" else (IPC_PULL_ADDR, IPC_PUSH_ADDR)
 
     print(
         f"{Color.BLUE}[Main]{Color.RESET} Workers: {num_workers}, "
-        f"Iterations: {STABILITY_ITERATIONS:,}",
+        f"Iterations: {STABILITY_ITERATIONS:,}"
+        + (", serving jobs" if serve else "")
+        + (f", {transport} transport" if transport != "tcp" else ""),
         flush=True
     )
 
@@ -58,12 +79,19 @@ def main() -> None:
     total_received = Value('i', 0)
     total_passed = Value('i', 0)
 
+    # Negotiated wire format: [batch_size, multipart, credits, shm]
+    wire_state = Array('i', [1, 0, 0, 0])
+
+    # Serve mode: workers meet here after each job's END marker
+    job_barrier = Barrier(num_workers) if serve else None
+
     start_time = time.perf_counter()
 
     # Start receiver process
     p_receiver = Process(
         target=receiver_process,
-        args=(task_queue, num_workers, total_received),
+        args=(task_queue, num_workers, total_received, wire_state, serve,
+              result_queue, pull_addr),
         name="Receiver"
     )
     p_receiver.start()
@@ -72,7 +100,7 @@ def main() -> None:
     workers = [
         Process(
             target=worker_process,
-            args=(i + 1, task_queue, result_queue),
+            args=(i + 1, task_queue, result_queue, job_barrier),
             name=f"Worker-{i + 1}"
         )
         for i in range(num_workers)
@@ -83,7 +111,8 @@ def main() -> None:
     # Start sender process
     p_sender = Process(
         target=sender_process,
-        args=(result_queue, total_passed, total_received, start_time),
+        args=(result_queue, total_passed, total_received, start_time,
+              wire_state, num_workers, serve, push_addr),
         name="Sender"
     )
     p_sender.start()
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""
+Worker node for the C++ cluster backend (main_app --stability cluster).
+Author: IFF-3-2 Aleksandravicius Linas
+
+Connects a DEALER socket to the C++ ROUTER and computes Filter 2 for the
+batches routed to it. Any number of nodes, on any machine, may connect:
+
+- hello + credit: register and ask for a window of records
+- tasks (behind a batch id): queued for the local worker processes
+- results + done (behind the batch id): sent once a batch is complete,
+  the done frame returns the batch's credits
+- credit 0 every HEARTBEAT_INTERVAL: keeps the node registered; a node
+  that goes silent is dropped and its batches go to the other nodes
+
+A hello from C++ means the node was dropped: it registers again.
+
+Usage: node.py [--connect tcp://host:5560] [--half-cpu | --single-worker]
+"""
+
+import os
+import queue
+import signal
+import socket as net
+import struct
+import sys
+import time
+from multiprocessing import Process, Queue
+from typing import Any, Dict, List
+
+import zmq
+
+from colors import Color
+from config import CLUSTER_ADDR, CLUSTER_CREDIT_BATCH, \
+    CREDIT_BATCHES_PER_WORKER, HEARTBEAT_INTERVAL, get_worker_count
+from functions import compute_stability_score, passes_stability_filter
+from protocol import decode_tasks, encode_results, make_credit, make_done, \
+    make_hello, parse_hello
+
+# Milliseconds the main loop waits for a message
+POLL_MS = 50
+
+
+def parse_args() -> Any:
+    """Parse command line arguments: (router address, worker count)."""
+    address = CLUSTER_ADDR
+    if "--connect" in sys.argv:
+        index = sys.argv.index("--connect")
+        if index + 1 < len(sys.argv):
+            address = sys.argv[index + 1]
+
+    if "--single-worker" in sys.argv:
+        return address, 1
+    return address, get_worker_count("--half-cpu" in sys.argv)
+
+
+def node_worker_process(
+    worker_id: int,
+    input_queue: "Queue[Any]",
+    output_queue: "Queue[Any]"
+) -> None:
+    """
+    Worker process: (batch, id, load, uptime) in,
+    (batch, id, stability, passed) out.
+    """
+    processed = 0
+    while True:
+        item = input_queue.get()
+        if item == "STOP":
+            break
+        try:
+            batch_id, server_id, load, uptime = item
+            stability = compute_stability_score(server_id, load, uptime)
+            output_queue.put((batch_id, server_id, stability,
+                              passes_stability_filter(stability)))
+            processed += 1
+        except Exception as e:  # pylint: disable=broad-exception-caught
+            print(
+                f"{Color.RED}[Worker {worker_id}] Error: {e}{Color.RESET}",
+                flush=True
+            )
+
+    print(
+        f"{Color.CYAN}[Worker {worker_id}]{Color.RESET} "
+        f"Done: {processed} processed",
+        flush=True
+    )
+
+
+class Node:
+    """Socket side of a worker node: batches in flight and their results."""
+
+    def __init__(self, socket: zmq.Socket, task_queue: "Queue[Any]",
+                 num_workers: int) -> None:
+        self.socket = socket
+        self.task_queue = task_queue
+        self.window = num_workers * CREDIT_BATCHES_PER_WORKER * \
+            CLUSTER_CREDIT_BATCH
+        # batch id -> [records, records left, passed results]
+        self.batches: Dict[int, List[Any]] = {}
+        self.processed = 0
+        self.passed = 0
+
+    def register(self) -> None:
+        """Hello and the full credit window."""
+        # Results of batches from before a drop are no longer wanted
+        self.batches.clear()
+        self.socket.send(make_hello(CLUSTER_CREDIT_BATCH, False, True))
+        self.socket.send(make_credit(self.window, self.processed))
+
+    def heartbeat(self) -> None:
+        """Credit of zero records: only says the node is alive."""
+        self.socket.send(make_credit(0, self.processed))
+
+    def handle(self, frames: List[bytes]) -> None:
+        """One message from the router."""
+        if len(frames) == 1 and parse_hello(frames) is not None:
+            print(
+                f"{Color.YELLOW}[Node]{Color.RESET} Router asked to "
+                f"register again",
+                flush=True
+            )
+            self.register()
+            return
+        if len(frames) < 2 or len(frames[0]) != 4:
+            return
+
+        (batch_id,) = struct.unpack("I", frames[0])
+        tasks = decode_tasks(frames[1:])
+        self.batches[batch_id] = [len(tasks), len(tasks), []]
+        for task in tasks:
+            self.task_queue.put((batch_id,) + tuple(task))
+        if not tasks:
+            self.finish(batch_id)
+
+    def add(self, item: Any) -> None:
+        """One processed record from a worker."""
+        batch_id, server_id, stability, passed = item
+        batch = self.batches.get(batch_id)
+        if batch is None:
+            return
+        batch[1] -= 1
+        if passed:
+            batch[2].append((server_id, stability))
+        if batch[1] <= 0:
+            self.finish(batch_id)
+
+    def finish(self, batch_id: int) -> None:
+        """Send a complete batch: its results, then done."""
+        count, _, results = self.batches.pop(batch_id)
+        prefix = struct.pack("I", batch_id)
+        # One results frame for the whole batch
+        for frames in encode_results(results, max(2, len(results))):
+            self.socket.send_multipart([prefix] + frames)
+        self.socket.send_multipart([prefix, make_done(count, len(results))])
+        self.passed += len(results)
+
+
+def main() -> None:
+    """Main entry point."""
+    address, num_workers = parse_args()
+    identity = f"{net.gethostname()}:{os.getpid()}"
+
+    print(
+        f"{Color.BOLD}\n=== Python Worker Node ==={Color.RESET}",
+        flush=True
+    )
+    print(
+        f"{Color.BLUE}[Node]{Color.RESET} {identity}, workers: "
+        f"{num_workers}, router: {address}",
+        flush=True
+    )
+
+    task_queue: Queue = Queue()
+    result_queue: Queue = Queue()
+    workers = [
+        Process(
+            target=node_worker_process,
+            args=(i + 1, task_queue, result_queue),
+            name=f"Worker-{i + 1}"
+        )
+        for i in range(num_workers)
+    ]
+    for worker in workers:
+        worker.start()
+
+    context = zmq.Context()
+    socket = context.socket(zmq.DEALER)
+    socket.setsockopt(zmq.IDENTITY, identity.encode())
+    socket.connect(address)
+
+    # run.py stops the node with terminate()
+    signal.signal(signal.SIGTERM, signal.default_int_handler)
+
+    node = Node(socket, task_queue, num_workers)
+    node.register()
+    last_beat = time.monotonic()
+
+    try:
+        while True:
+            if socket.poll(POLL_MS):
+                while True:
+                    try:
+                        frames = socket.recv_multipart(zmq.NOBLOCK)
+                    except zmq.Again:
+                        break
+                    node.handle(frames)
+
+            while True:
+                try:
+                    item = result_queue.get_nowait()
+                except queue.Empty:
+                    break
+                node.processed += 1
+                node.add(item)
+
+            if time.monotonic() - last_beat >= HEARTBEAT_INTERVAL:
+                node.heartbeat()
+                last_beat = time.monotonic()
+
+    except KeyboardInterrupt:
+        pass
+
+    finally:
+        for _ in workers:
+            task_queue.put("STOP")
+        for worker in workers:
+            worker.join()
+        socket.close(linger=0)
+        context.term()
+
+    print(
+        f"{Color.BLUE}[Node]{Color.RESET} "
+        f"{node.passed}/{node.processed} passed",
+        flush=True
+    )
+
+
+if __name__ == "__main__":
+    main()
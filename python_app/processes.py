@@ -4,36 +4,82 @@ Author: IFF-3-2 Aleksandravicius Linas
 
 Processes communicate via multiprocessing.Queue.
 Network communication with C++ uses ZeroMQ (binary protocol).
+
+In serve mode the processes stay up across jobs: the C++ stop signal
+ends a job, the receiver queues one END marker per worker, every worker
+forwards its marker after its last result and the sender answers with
+the stop signal once all markers arrived.
+
+Flow control: workers report every processed record to the sender (a
+result or TASK_DONE), which returns them to C++ as credits, so at most
+one credit window of tasks is ever queued here.
+
+Shared memory: the receiver splits every ring slot into SLOT_TASK parts,
+the workers compute them in place and report SLOT_DONE, and the sender
+hands the slot back once all its records are done. Only slot numbers go
+through the queues.
 """
 
-import struct
+import queue
 import time
 from multiprocessing import Queue
-from typing import Any, Tuple
+from typing import Any, Dict, List, Tuple
 
 import zmq
 
 from colors import Color
-from config import ZMQ_PULL_ADDR, ZMQ_PUSH_ADDR
+from config import CREDIT_BATCHES_PER_WORKER, RESULT_FLUSH_INTERVAL, \
+    SHM_CHUNK_RECORDS, ZMQ_PULL_ADDR, ZMQ_PUSH_ADDR
 from functions import compute_stability_score, passes_stability_filter
+from protocol import KIND_RESULTS, KIND_TASKS, decode_tasks, \
+    encode_results, is_stop, make_credit, make_hello, make_slot, \
+    parse_hello, parse_slot
+from shm_ring import SlotRing
 
 # Type aliases
 ServerTask = Tuple[int, float, int]  # (id, load, uptime)
 ServerResult = Tuple[int, float]     # (id, stability)
 
+# End of one job in serve mode
+JOB_END = "END"
+
+# A processed record that did not pass Filter 2 (returns its credit)
+TASK_DONE = "DONE"
+
+# The receiver saw a hello: answer it and grant the first credits
+WIRE_HELLO = "HELLO"
+
+# (SLOT_TASK, slot, start, end, count): records start..end of a ring slot
+# (SLOT_DONE, slot, records, count, passed): those records are computed
+SLOT_TASK = "SLOT"
+SLOT_DONE = "SLOT_DONE"
+
+
+def print_worker_done(worker_id: int, accepted: int, processed: int) -> None:
+    """Per-worker summary line."""
+    print(
+        f"{Color.CYAN}[Worker {worker_id}]{Color.RESET} "
+        f"Done: {accepted}/{processed} passed",
+        flush=True
+    )
+
 
 def worker_process(
     worker_id: int,
     input_queue: "Queue[Any]",
-    output_queue: "Queue[Any]"
+    output_queue: "Queue[Any]",
+    job_barrier: Any = None
 ) -> None:
     """
     Worker process: computes stability score and applies Filter 2.
 
-    Only records with stability >= 50.0 are sent to output queue.
+    Records with stability >= 50.0 are sent to output queue, the others
+    as TASK_DONE; ring slot parts are computed in place. In serve mode
+    job_barrier makes every worker take exactly one END marker.
     """
     processed = 0
     accepted = 0
+    ring = None
 
     while True:
         try:
@@ -42,6 +88,24 @@ def worker_process(
             if item == "STOP":
                 break
 
+            if item == JOB_END:
+                output_queue.put(JOB_END)
+                print_worker_done(worker_id, accepted, processed)
+                processed = 0
+                accepted = 0
+                job_barrier.wait()
+                continue
+
+            if isinstance(item, tuple) and item[0] == SLOT_TASK:
+                _, slot, start, end, count = item
+                if ring is None:
+                    ring = SlotRing()
+                passed = ring.process(slot, start, end)
+                processed += end - start
+                accepted += passed
+                output_queue.put((SLOT_DONE, slot, end - start, count, passed))
+                continue
+
             server_id, load, uptime = item
             stability = compute_stability_score(server_id, load, uptime)
             processed += 1
@@ -49,6 +113,8 @@ def worker_process(
             if passes_stability_filter(stability):
                 output_queue.put((server_id, stability))
                 accepted += 1
+            else:
+                output_queue.put(TASK_DONE)
 
         except Exception as e:  # pylint: disable=broad-exception-caught
             print(
@@ -56,41 +122,81 @@ def worker_process(
                 flush=True
             )
 
-    print(
-        f"{Color.CYAN}[Worker {worker_id}]{Color.RESET} "
-        f"Done: {accepted}/{processed} passed",
-        flush=True
-    )
+    print_worker_done(worker_id, accepted, processed)
 
 
 def receiver_process(
     task_queue: "Queue[Any]",
     num_workers: int,
-    total_received: Any = None
+    total_received: Any = None,
+    wire_state: Any = None,
+    serve: bool = False,
+    result_queue: "Queue[Any]" = None,
+    address: str = ZMQ_PULL_ADDR
 ) -> None:
     """
     Receiver process: gets data from C++ via ZMQ.
 
-    Binary format: id(4) + load(4) + uptime(4) = 12 bytes per record.
+    Legacy format: id(4) + load(4) + uptime(4) = 12 bytes per record.
+    Batch frames (see protocol.py) carry many records per message; a hello
+    frame negotiates the batch size used for results, flow control and
+    the shared-memory ring (stored in wire_state as [batch_size,
+    multipart, credits, shm]) and is passed on to the sender through
+    result_queue.
     """
     context = zmq.Context()
     socket = context.socket(zmq.PULL)
-    socket.bind(ZMQ_PULL_ADDR)
+    socket.bind(address)
 
     received = 0
 
     try:
         while True:
-            msg = socket.recv()
+            frames = socket.recv_multipart()
 
             # Stop signal: single byte 0xFF
-            if len(msg) == 1 and msg[0] == 0xFF:
-                break
-
-            # Binary format: id(4) + load(4) + uptime(4)
-            server_id, load, uptime = struct.unpack("ifi", msg)
-            task_queue.put((server_id, load, uptime))
-            received += 1
+            if is_stop(frames):
+                if not serve:
+                    break
+                for _ in range(num_workers):
+                    task_queue.put(JOB_END)
+                print(
+                    f"{Color.GREEN}[Receiver]{Color.RESET} "
+                    f"Job done, received {received} records from C++",
+                    flush=True
+                )
+                received = 0
+                continue
+
+            hello = parse_hello(frames)
+            if hello is not None:
+                if wire_state is not None:
+                    wire_state[:] = [hello[0], int(hello[1]),
+                                     int(hello[2]), int(hello[3])]
+                if result_queue is not None:
+                    result_queue.put(WIRE_HELLO)
+                print(
+                    f"{Color.GREEN}[Receiver]{Color.RESET} "
+                    + ("Shared-memory ring" if hello[3] else
+                       f"Batch frames, results batched by {hello[0]}")
+                    + (", credit flow control" if hello[2] else ""),
+                    flush=True
+                )
+                continue
+
+            slot = parse_slot(frames)
+            if slot is not None:
+                kind, index, count = slot
+                if kind == KIND_TASKS:
+                    for start in range(0, count, SHM_CHUNK_RECORDS):
+                        end = min(count, start + SHM_CHUNK_RECORDS)
+                        task_queue.put((SLOT_TASK, index, start, end, count))
+                    received += count
+                continue
+
+            for task in decode_tasks(frames):
+                task_queue.put(task)
+                received += 1
 
     except Exception as e:  # pylint: disable=broad-exception-caught
         print(f"{Color.RED}[Receiver] Error: {e}{Color.RESET}", flush=True)
@@ -111,16 +217,127 @@ def receiver_process(
     )
 
 
+def send_results(
+    socket: zmq.Socket,
+    results: List[ServerResult],
+    wire_state: Any
+) -> None:
+    """Send results in the format negotiated by the receiver."""
+    batch_size = wire_state[0] if wire_state is not None else 1
+    multipart = bool(wire_state[1]) if wire_state is not None else False
+    for frames in encode_results(results, batch_size, multipart):
+        socket.send_multipart(frames)
+
+
+class ResultSender:
+    """
+    Result and credit side of the sender process for one job: results
+    are batched in the negotiated format, processed records are returned
+    to C++ as credits in batches of the same size.
+    """
+
+    def __init__(self, socket: zmq.Socket, wire_state: Any,
+                 num_workers: int) -> None:
+        self.socket = socket
+        self.wire_state = wire_state
+        self.num_workers = num_workers
+        self.pending: List[ServerResult] = []
+        self.hello_sent = False
+        self.owed = 0
+        self.processed = 0
+        # slot -> [records done, passed]
+        self.slots: Dict[int, List[int]] = {}
+
+    def batch_size(self) -> int:
+        """Negotiated result batch size."""
+        return self.wire_state[0] if self.wire_state is not None else 1
+
+    def credits(self) -> bool:
+        """Whether C++ asked for flow control."""
+        return self.wire_state is not None and bool(self.wire_state[2])
+
+    def shm(self) -> bool:
+        """Whether C++ sends records through the shared-memory ring."""
+        return self.wire_state is not None and bool(self.wire_state[3])
+
+    def hello(self) -> None:
+        """Answer the C++ hello once per job; grant the first window."""
+        batch_size = self.batch_size()
+        if batch_size <= 1 or self.hello_sent:
+            return
+        self.socket.send(make_hello(
+            batch_size, bool(self.wire_state[1]), self.credits(), self.shm()
+        ))
+        self.hello_sent = True
+        if self.credits():
+            window = self.num_workers * CREDIT_BATCHES_PER_WORKER * batch_size
+            self.socket.send(make_credit(window, 0))
+
+    def add(self, item: Any) -> None:
+        """One processed record: a result or TASK_DONE."""
+        if item != TASK_DONE:
+            self.pending.append(item)
+            if len(self.pending) >= self.batch_size():
+                self.flush_results()
+        self.owed += 1
+        self.processed += 1
+        if self.owed >= self.batch_size():
+            self.flush_credits()
+
+    def add_slot(self, slot: int, records: int, count: int,
+                 passed: int) -> None:
+        """Part of a ring slot is done; hand the slot back when complete."""
+        done = self.slots.setdefault(slot, [0, 0])
+        done[0] += records
+        done[1] += passed
+        self.processed += records
+        if done[0] >= count:
+            self.socket.send(make_slot(KIND_RESULTS, slot, count, done[1]))
+            del self.slots[slot]
+
+    def flush_results(self) -> None:
+        """Send every pending result."""
+        send_results(self.socket, self.pending, self.wire_state)
+        self.pending = []
+
+    def flush_credits(self) -> None:
+        """Return the credits of the records processed since last time."""
+        if self.owed and self.credits():
+            self.socket.send(make_credit(self.owed, self.processed))
+        self.owed = 0
+
+    def has_pending(self) -> bool:
+        """Anything the flush timer has to send."""
+        return bool(self.pending) or (self.owed > 0 and self.credits())
+
+    def end_job(self) -> None:
+        """Flush results; credits of a finished job are dropped."""
+        self.flush_results()
+        self.owed = 0
+        self.processed = 0
+        self.slots = {}
+        # The next job negotiates its own format
+        self.hello_sent = False
+
+
 def sender_process(
     result_queue: "Queue[Any]",
     total_passed: Any = None,
     total_received: Any = None,
-    start_time: float = 0.0
+    start_time: float = 0.0,
+    wire_state: Any = None,
+    num_workers: int = 1,
+    serve: bool = False,
+    address: str = ZMQ_PUSH_ADDR
 ) -> None:
     """
     Sender process: sends filtered results back to C++ via ZMQ.
 
-    Binary format: id(4) + stability(4) = 8 bytes per result.
+    Legacy format: id(4) + stability(4) = 8 bytes per result. Once the
+    receiver negotiated batch frames, results are collected and flushed
+    when the batch is full or after RESULT_FLUSH_INTERVAL seconds, and
+    credits are returned the same way. In serve mode the END markers of
+    all num_workers workers end a job.
     """
     context = zmq.Context()
     socket = context.socket(zmq.PUSH)
@@ -128,25 +345,62 @@ def sender_process(
     # Retry connection with timeout
     for _ in range(30):
         try:
-            socket.connect(ZMQ_PUSH_ADDR)
+            socket.connect(address)
             break
         except zmq.ZMQError:
             time.sleep(1.0)
 
     sent = 0
+    job_sent = 0
+    job_ends = 0
+    sender = ResultSender(socket, wire_state, num_workers)
 
     try:
         while True:
-            item = result_queue.get()
+            try:
+                item = result_queue.get(
+                    timeout=RESULT_FLUSH_INTERVAL
+                    if sender.has_pending() else None
+                )
+            except queue.Empty:
+                sender.flush_results()
+                sender.flush_credits()
+                continue
+
+            if item == WIRE_HELLO:
+                sender.hello()
+                continue
 
             if item == "STOP":
+                sender.flush_results()
                 socket.send(bytes([0xFF]))  # Stop signal
                 break
 
-            server_id, stability = item
-            msg = struct.pack("if", server_id, stability)
-            socket.send(msg)
-            sent += 1
+            if serve and item == JOB_END:
+                job_ends += 1
+                if job_ends == num_workers:
+                    sender.end_job()
+                    socket.send(bytes([0xFF]))  # Job done
+                    print(
+                        f"{Color.MAGENTA}[Sender]{Color.RESET} "
+                        f"Job done, sent {sent - job_sent} results to C++",
+                        flush=True
+                    )
+                    job_ends = 0
+                    job_sent = sent
+                continue
+
+            # Results only exist after the receiver saw the first task, so
+            # the negotiated format is known by now
+            sender.hello()
+            if isinstance(item, tuple) and item[0] == SLOT_DONE:
+                _, slot, records, count, passed = item
+                sent += passed
+                sender.add_slot(slot, records, count, passed)
+                continue
+            if item != TASK_DONE:
+                sent += 1
+            sender.add(item)
 
     except Exception as e:  # pylint: disable=broad-exception-caught
         print(f"{Color.RED}[Sender] Error: {e}{Color.RESET}", flush=True)
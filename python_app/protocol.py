@@ -0,0 +1,201 @@
+"""
+ZeroMQ binary protocol (legacy single-record and batch frames).
+Author: IFF-3-2 Aleksandravicius Linas
+
+Batch frames start with an 8 byte header followed by packed columns:
+- tasks:   ids[count](i32) loads[count](f32) uptimes[count](i32)
+- results: ids[count](i32) stabilities[count](f32)
+- hello:   capabilities(u32) reserved(u32), count = offered batch size
+- credit:  processed(u32) reserved(u32), count = records granted
+- done:    passed(u32) reserved(u32), count = records in the batch
+
+With the multipart flag the header travels alone and every column is a
+separate part. Legacy frames (12 byte task, 8 byte result, 1 byte stop)
+are still accepted.
+
+When both hellos carry CAP_CREDITS, C++ sends tasks only while it holds
+credits: the workers grant an initial window after their hello and return
+one credit per processed record.
+
+With CAP_SHM in both hellos (same host, see shm_ring.py) tasks and
+results are slot frames with FLAG_SHM: slot(u32) passed(u32), count =
+records in the slot. The records and results stay in shared memory.
+
+Worker nodes (node.py) talk to the C++ ROUTER with the same frames; tasks,
+results and done frames travel behind a 4 byte batch id part.
+"""
+
+import struct
+from typing import List, Optional, Tuple
+
+from config import WIRE_BATCH_MAX
+
+BATCH_MAGIC = 0xB7
+PROTOCOL_VERSION = 1
+
+KIND_TASKS = 1
+KIND_RESULTS = 2
+KIND_HELLO = 3
+KIND_CREDIT = 4
+KIND_DONE = 5
+
+FLAG_MULTIPART = 0x01
+FLAG_SHM = 0x02
+CAP_MULTIPART = 0x01
+CAP_CREDITS = 0x02
+CAP_SHM = 0x04
+
+HELLO_PAYLOAD_FORMAT = "II"
+CREDIT_PAYLOAD_FORMAT = "II"
+DONE_PAYLOAD_FORMAT = "II"
+SLOT_PAYLOAD_FORMAT = "II"
+
+HEADER_FORMAT = "BBBBI"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+
+STOP_SIGNAL = 0xFF
+LEGACY_TASK_SIZE = 12
+LEGACY_RESULT_SIZE = 8
+
+Task = Tuple[int, float, int]  # (id, load, uptime)
+Result = Tuple[int, float]     # (id, stability)
+
+
+def is_stop(frames: List[bytes]) -> bool:
+    """Check for the single byte stop signal."""
+    return len(frames) == 1 and len(frames[0]) == 1 and \
+        frames[0][0] == STOP_SIGNAL
+
+
+def parse_header(frame: bytes) -> Optional[Tuple[int, int, int]]:
+    """Return (kind, flags, count) for a batch header, else None."""
+    if len(frame) < HEADER_SIZE:
+        return None
+    magic, version, kind, flags, count = struct.unpack_from(
+        HEADER_FORMAT, frame
+    )
+    if magic != BATCH_MAGIC or version != PROTOCOL_VERSION:
+        return None
+    return kind, flags, count
+
+
+def make_header(kind: int, count: int, multipart: bool = False) -> bytes:
+    """Build a batch header."""
+    flags = FLAG_MULTIPART if multipart else 0
+    return struct.pack(
+        HEADER_FORMAT, BATCH_MAGIC, PROTOCOL_VERSION, kind, flags, count
+    )
+
+
+def make_hello(batch_size: int, multipart: bool,
+               credits: bool = False, shm: bool = False) -> bytes:
+    """Build a hello frame offering a batch size."""
+    capabilities = (CAP_MULTIPART if multipart else 0) | \
+        (CAP_CREDITS if credits else 0) | (CAP_SHM if shm else 0)
+    return make_header(KIND_HELLO, batch_size) + struct.pack(
+        HELLO_PAYLOAD_FORMAT, capabilities, 0
+    )
+
+
+def make_credit(records: int, processed: int) -> bytes:
+    """Build a credit frame granting records more tasks."""
+    return make_header(KIND_CREDIT, records) + struct.pack(
+        CREDIT_PAYLOAD_FORMAT, processed, 0
+    )
+
+
+def make_done(count: int, passed: int) -> bytes:
+    """Build a done frame: a batch of count records is finished."""
+    return make_header(KIND_DONE, count) + struct.pack(
+        DONE_PAYLOAD_FORMAT, passed, 0
+    )
+
+
+def make_slot(kind: int, slot: int, count: int, passed: int = 0) -> bytes:
+    """Build a slot frame handing a ring slot to the peer."""
+    header = bytearray(make_header(kind, count))
+    header[3] |= FLAG_SHM
+    return bytes(header) + struct.pack(SLOT_PAYLOAD_FORMAT, slot, passed)
+
+
+def parse_slot(frames: List[bytes]) -> Optional[Tuple[int, int, int]]:
+    """Return (kind, slot, count) for a slot frame, else None."""
+    if len(frames) != 1 or len(frames[0]) != HEADER_SIZE + 8:
+        return None
+    header = parse_header(frames[0])
+    if header is None or not header[1] & FLAG_SHM:
+        return None
+    slot, _ = struct.unpack_from(SLOT_PAYLOAD_FORMAT, frames[0], HEADER_SIZE)
+    return header[0], slot, header[2]
+
+
+def parse_hello(
+    frames: List[bytes]
+) -> Optional[Tuple[int, bool, bool, bool]]:
+    """
+    Return (agreed batch size, multipart, credits, shm) for a hello frame,
+    else None.
+    """
+    if len(frames) != 1 or len(frames[0]) != HEADER_SIZE + 8:
+        return None
+    header = parse_header(frames[0])
+    if header is None or header[0] != KIND_HELLO:
+        return None
+    capabilities, _ = struct.unpack_from(
+        HELLO_PAYLOAD_FORMAT, frames[0], HEADER_SIZE
+    )
+    batch_size = max(1, min(header[2], WIRE_BATCH_MAX))
+    return batch_size, bool(capabilities & CAP_MULTIPART), \
+        bool(capabilities & CAP_CREDITS), bool(capabilities & CAP_SHM)
+
+
+def decode_tasks(frames: List[bytes]) -> List[Task]:
+    """Decode a legacy task or a (multipart) task batch."""
+    if len(frames) == 1 and len(frames[0]) == LEGACY_TASK_SIZE:
+        return [struct.unpack("ifi", frames[0])]
+
+    header = parse_header(frames[0])
+    if header is None or header[0] != KIND_TASKS:
+        return []
+    _, flags, count = header
+    if flags & FLAG_SHM:
+        return []  # Records are in the ring (parse_slot)
+
+    if flags & FLAG_MULTIPART:
+        if len(frames) != 4:
+            return []
+        ids_raw, loads_raw, uptimes_raw = frames[1], frames[2], frames[3]
+    else:
+        body = memoryview(frames[0])[HEADER_SIZE:]
+        ids_raw = body[:4 * count]
+        loads_raw = body[4 * count:8 * count]
+        uptimes_raw = body[8 * count:12 * count]
+
+    ids = struct.unpack(f"{count}i", ids_raw)
+    loads = struct.unpack(f"{count}f", loads_raw)
+    uptimes = struct.unpack(f"{count}i", uptimes_raw)
+    return list(zip(ids, loads, uptimes))
+
+
+def encode_results(results: List[Result], batch_size: int,
+                   multipart: bool = False) -> List[List[bytes]]:
+    """
+    Encode results as messages (each a list of frames).
+
+    batch_size 1 keeps the legacy one-message-per-result format.
+    """
+    if batch_size <= 1:
+        return [[struct.pack("if", sid, stab)] for sid, stab in results]
+
+    messages = []
+    for start in range(0, len(results), batch_size):
+        chunk = results[start:start + batch_size]
+        count = len(chunk)
+        ids = struct.pack(f"{count}i", *(sid for sid, _ in chunk))
+        stabs = struct.pack(f"{count}f", *(stab for _, stab in chunk))
+        header = make_header(KIND_RESULTS, count, multipart)
+        if multipart:
+            messages.append([header, ids, stabs])
+        else:
+            messages.append([header + ids + stabs])
+    return messages
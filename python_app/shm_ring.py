@@ -0,0 +1,72 @@
+"""
+Worker side of the shared-memory ring (--wire-transport shm).
+Author: IFF-3-2 Aleksandravicius Linas
+
+C++ creates the segment (cpp_app/src/shm_ring.h) and hands slots over
+with slot frames. A worker reads the task columns of its part of a slot
+and writes stabilities and pass flags next to them:
+
+    header: magic(u32) version(u32) slots(u32) slot_records(u32)
+            slot_bytes(u64), 64 bytes
+    slot:   ids[n](i32) loads[n](f32) uptimes[n](i32)
+            stabilities[n](f32) passed[n](u8)
+"""
+
+import struct
+from multiprocessing import resource_tracker, shared_memory
+
+from config import SHM_RING_NAME
+from functions import compute_stability_score, passes_stability_filter
+
+RING_MAGIC = 0x474E4952
+RING_HEADER_FORMAT = "IIIIQ"
+RING_HEADER_SIZE = 64
+
+
+class SlotRing:
+    """Attached view of the ring; one per worker process."""
+
+    def __init__(self, name: str = SHM_RING_NAME) -> None:
+        self.shm = shared_memory.SharedMemory(name=name)
+        # C++ owns the segment: do not unlink it when this process exits
+        resource_tracker.unregister(
+            self.shm._name, "shared_memory"  # pylint: disable=protected-access
+        )
+        magic, _, self.slots, self.slot_records, self.slot_bytes = \
+            struct.unpack_from(RING_HEADER_FORMAT, self.shm.buf, 0)
+        if magic != RING_MAGIC:
+            raise ValueError(f"{name} is not a record ring")
+
+    def process(self, slot: int, start: int, end: int) -> int:
+        """
+        Compute Filter 2 for records start..end of a slot in place.
+        Returns the number that passed.
+        """
+        n = self.slot_records
+        base = RING_HEADER_SIZE + self.slot_bytes * slot
+        buf = self.shm.buf
+        ids = buf[base:base + 4 * n].cast("i")
+        loads = buf[base + 4 * n:base + 8 * n].cast("f")
+        uptimes = buf[base + 8 * n:base + 12 * n].cast("i")
+        stabilities = buf[base + 12 * n:base + 16 * n].cast("f")
+        passed = buf[base + 16 * n:base + 17 * n]
+
+        accepted = 0
+        try:
+            for i in range(start, end):
+                stability = compute_stability_score(
+                    ids[i], loads[i], uptimes[i]
+                )
+                stabilities[i] = stability
+                ok = passes_stability_filter(stability)
+                passed[i] = 1 if ok else 0
+                accepted += ok
+        finally:
+            # Views must be gone before the segment can be closed
+            for view in (ids, loads, uptimes, stabilities, passed):
+                view.release()
+        return accepted
+
+    def close(self) -> None:
+        """Detach from the segment."""
+        self.shm.close()
@@ -78,6 +78,30 @@ def resolve_data_path(root: Path, data_arg: str) -> str:
     return str(root / data_arg)
 
 
+def uses_python_workers(cpp_args: list) -> bool:
+    for i, arg in enumerate(cpp_args[:-1]):
+        value = cpp_args[i + 1]
+        if arg == "--stability" and value in ("native", "opencl"):
+            return False
+        if arg == "--pipeline" and value == "fused":
+            return False
+    return True
+
+
+def wire_transport(cpp_args: list) -> str:
+    for i, arg in enumerate(cpp_args[:-1]):
+        if arg == "--wire-transport":
+            return cpp_args[i + 1]
+    return "tcp"
+
+
+def uses_worker_node(cpp_args: list) -> bool:
+    for i, arg in enumerate(cpp_args[:-1]):
+        if arg == "--stability" and cpp_args[i + 1] == "cluster":
+            return True
+    return False
+
+
 def main() -> int:
     parser = argparse.ArgumentParser(
         description="Run parallel computing applications"
@@ -103,7 +127,8 @@ def main() -> int:
         action="store_true",
         help="Force rebuild C++"
     )
-    args = parser.parse_args()
+    # Unrecognized flags are forwarded to the C++ application
+    args, cpp_args = parser.parse_known_args()
 
     root = get_root()
 
@@ -127,44 +152,63 @@ def main() -> int:
     if args.half_cpu:
         py_args.append("--half-cpu")
 
+    # Daemon mode: both sides stay up, jobs arrive on the control socket
+    serve = "--serve" in cpp_args
+    if serve and not uses_worker_node(cpp_args):
+        py_args.append("--serve")
+
+    # Same-host transports: both sides must use the same sockets
+    transport = wire_transport(cpp_args)
+    if transport != "tcp":
+        py_args += ["--transport", transport]
+
+    # Cluster backend: one local worker node, more may connect from elsewhere
+    cluster = uses_worker_node(cpp_args)
+    py_script = "node.py" if cluster else "main.py"
+
     data_path = resolve_data_path(root, args.data_file)
 
     print("[Main] Starting...")
     print()
 
-    # Start Python application
-    py_proc = subprocess.Popen(
-        [sys.executable, str(root / "python_app" / "main.py")] + py_args,
-        cwd=root / "python_app",
-        stdout=subprocess.PIPE,
-        stderr=subprocess.STDOUT,
-        text=True,
-        bufsize=1
-    )
-
     lock = threading.Lock()
-    py_thread = threading.Thread(
-        target=stream_output,
-        args=(py_proc, "[Python]", lock)
-    )
-    py_thread.start()
+    py_proc = None
+    py_thread = None
+
+    # Start Python application (not needed when Filter 2 runs in C++)
+    if uses_python_workers(cpp_args):
+        py_proc = subprocess.Popen(
+            [sys.executable, str(root / "python_app" / py_script)] + py_args,
+            cwd=root / "python_app",
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+            text=True,
+            bufsize=1
+        )
 
-    # Wait for Python to initialize
-    time.sleep(1)
+        py_thread = threading.Thread(
+            target=stream_output,
+            args=(py_proc, "[Python]", lock)
+        )
+        py_thread.start()
 
-    if py_proc.poll() is not None:
-        print("[Error] Python failed to start")
-        return 1
+        # Wait for Python to initialize
+        time.sleep(1)
+
+        if py_proc.poll() is not None:
+            print("[Error] Python failed to start")
+            return 1
 
     # Start C++ application
     exe = get_executable(root)
     if not exe.exists():
         print("[Error] C++ executable not found")
-        py_proc.terminate()
+        if py_proc is not None:
+            py_proc.terminate()
         return 1
 
     cpp_proc = subprocess.Popen(
-        [str(exe), data_path],
+        [str(exe)] + ([] if serve else [data_path]) + cpp_args,
         cwd=root / "cpp_app",
         stdout=subprocess.PIPE,
         stderr=subprocess.STDOUT,
@@ -180,14 +224,19 @@ def main() -> int:
 
     # Wait for completion
     cpp_proc.wait()
-    py_proc.wait()
-    py_thread.join()
+    if py_proc is not None:
+        if serve or cluster:
+            # Serving workers and nodes only stop when asked to
+            py_proc.terminate()
+        py_proc.wait()
+        py_thread.join()
     cpp_thread.join()
 
     # Print summary
+    py_code = py_proc.returncode if py_proc is not None else "-"
     print()
     print("=" * 50)
-    print(f"Exit: C++={cpp_proc.returncode}, Python={py_proc.returncode}")
+    print(f"Exit: C++={cpp_proc.returncode}, Python={py_code}")
     print("=" * 50)
 
     return cpp_proc.returncode